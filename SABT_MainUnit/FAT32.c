@@ -13,6 +13,8 @@
 #include "Globals.h"
 #include "ui_handle.h"
 
+#include <string.h>
+
 /**
  * @brief Reads in data data from boot sector and
  * checks to make sure that it is the FAT32 standard
@@ -413,6 +415,203 @@ unsigned char read_and_retrieve_file_contents(unsigned char *file_name, unsigned
 }
 
 
+/**
+ * @brief  Opens a file for reading with read_file_stream
+ * @param  stream - struct file_stream *, stream to set up
+ * @param  file_name - unsigned char *, name of the file; converted to FAT
+ *                     format in place, so it must have FILE_NAME_LEN bytes
+ * @return bool - false if the name is invalid or the file does not exist
+ */
+bool open_file_stream(struct file_stream *stream, unsigned char *file_name)
+{
+  struct dir_Structure *dir;
+
+  if(convert_file_name(file_name)) return false;
+
+  dir = find_files(GET_FILE, file_name);
+  if(dir == 0) return false;
+
+  stream->cluster = (((unsigned long) dir->first_cluster_hi) << 16) | dir->first_cluster_lo;
+  stream->bytes_left = dir->file_size;
+  stream->sector = 0;
+  stream->offset = BUFFER_SIZE;   //nothing buffered yet
+  stream->first_cluster = stream->cluster;
+  stream->size = dir->file_size;
+  stream->cluster_index = 0;
+  return true;
+}
+
+/**
+ * @brief  Moves a stream opened with open_file_stream so that the next
+ *         read_file_stream returns the byte at position. Seeking forwards
+ *         follows the cluster chain from the current cluster, seeking
+ *         backwards from the first one.
+ * @param  stream - struct file_stream *, stream to move
+ * @param  position - unsigned long, byte offset from the start of the file
+ * @return bool - false if position is past the end of the file or the card
+ *         cannot be read
+ */
+bool seek_file_stream(struct file_stream *stream, unsigned long position)
+{
+  unsigned long cluster_size = (unsigned long) sector_per_cluster * BUFFER_SIZE;
+  unsigned long target = position / cluster_size;
+
+  if(position >= stream->size) return false;
+
+  if(target < stream->cluster_index)
+  {
+    stream->cluster = stream->first_cluster;
+    stream->cluster_index = 0;
+  }
+  while(stream->cluster_index < target)
+  {
+    stream->cluster = get_set_next_cluster(stream->cluster, GET, 0);
+    if(stream->cluster == 0)
+    {
+      stream->bytes_left = 0;
+      return false;
+    }
+    stream->cluster_index++;
+  }
+
+  stream->sector = (position % cluster_size) / BUFFER_SIZE;
+  if(sd_read_single_block(get_first_sector(stream->cluster) + stream->sector))
+  {
+    stream->bytes_left = 0;
+    return false;
+  }
+  stream->sector++;
+  stream->offset = position % BUFFER_SIZE;
+  stream->bytes_left = stream->size - position;
+  return true;
+}
+
+/**
+ * @brief  Returns the next byte of a file opened with open_file_stream,
+ *         reading a new sector from the card every BUFFER_SIZE bytes
+ * @param  stream - struct file_stream *, stream to read from
+ * @return int - the byte read, or -1 at the end of the file or on error
+ */
+int read_file_stream(struct file_stream *stream)
+{
+  if(stream->bytes_left == 0) return -1;
+
+  if(stream->offset == BUFFER_SIZE)
+  {
+    if(stream->sector == sector_per_cluster)
+    {
+      stream->cluster = get_set_next_cluster(stream->cluster, GET, 0);
+      stream->cluster_index++;
+      stream->sector = 0;
+      if(stream->cluster == 0)
+      {
+        stream->bytes_left = 0;
+        return -1;
+      }
+    }
+
+    if(sd_read_single_block(get_first_sector(stream->cluster) + stream->sector))
+    {
+      stream->bytes_left = 0;
+      return -1;
+    }
+    stream->sector++;
+    stream->offset = 0;
+  }
+
+  stream->bytes_left--;
+  return buffer[stream->offset++];
+}
+
+
+/**
+ * @brief  Looks up where a file is, so that it can be played later with
+ *         play_mp3_location without searching the root directory again
+ * @param  file_name - unsigned char *, name of the file; converted to FAT
+ *                     format in place, so it must have FILE_NAME_LEN bytes
+ * @param  location - struct file_location *, set to where the file is;
+ *                    first_cluster is 0 if it is not found
+ * @return bool - false if the name is invalid or the file does not exist
+ */
+bool find_file_location(unsigned char *file_name,
+                        struct file_location *location)
+{
+  struct dir_Structure *dir;
+
+  location->first_cluster = 0;
+  location->size = 0;
+  if(convert_file_name(file_name)) return false;
+
+  dir = find_files(GET_FILE, file_name);
+  if(dir == 0) return false;
+
+  location->first_cluster = (((unsigned long) dir->first_cluster_hi) << 16) | dir->first_cluster_lo;
+  location->size = dir->file_size;
+  return location->first_cluster != 0;
+}
+
+/**
+ * @brief  Looks up several files with one pass over the root directory, where
+ *         find_file_location would make one pass for each
+ * @param  file_names - unsigned char (*)[FILE_NAME_LEN], names of the files;
+ *                      converted to FAT format in place
+ * @param  locations - struct file_location *, set to where each file is;
+ *                     first_cluster is 0 for files that are not found
+ * @param  count - unsigned char, number of files, up to MAX_FILE_LOCATIONS
+ * @return unsigned char - number of files found
+ */
+unsigned char find_file_locations(unsigned char (*file_names)[FILE_NAME_LEN],
+                                  struct file_location *locations,
+                                  unsigned char count)
+{
+  struct dir_Structure *dir;
+  unsigned long cluster, first_sector;
+  unsigned int i, wanted = 0;
+  unsigned char sector, n, found = 0;
+
+  if(count > MAX_FILE_LOCATIONS) count = MAX_FILE_LOCATIONS;
+  for(n = 0; n < count; n++)
+  {
+    locations[n].first_cluster = 0;
+    locations[n].size = 0;
+    if(!convert_file_name(file_names[n])) wanted |= 1U << n;
+  }
+
+  cluster = root_cluster;
+  while(wanted != 0)
+  {
+    first_sector = get_first_sector(cluster);
+
+    for(sector = 0; sector < sector_per_cluster; sector++)
+    {
+      sd_read_single_block(first_sector + sector);
+
+      for(i = 0; i < bytes_per_sector; i += 32)
+      {
+        dir = (struct dir_Structure *) &buffer[i];
+        if(dir->name[0] == EMPTY) return found; //end of the directory
+        if((dir->name[0] == DELETED) || (dir->attrib == ATTR_LONG_NAME)) continue;
+
+        for(n = 0; n < count; n++)
+        {
+          if((wanted & (1U << n)) && memcmp(dir->name, file_names[n], 11) == 0)
+          {
+            locations[n].first_cluster = (((unsigned long) dir->first_cluster_hi) << 16) | dir->first_cluster_lo;
+            locations[n].size = dir->file_size;
+            wanted &= ~(1U << n);
+            found++;
+          }
+        }
+        if(wanted == 0) return found;
+      }
+    }
+
+    cluster = get_set_next_cluster(cluster, GET, 0);
+    if((cluster == 0) || (cluster > 0x0ffffff6)) return found;
+  }
+  return found;
+}
+
 /**
  * @brief  This function plays a given MP3 files, until:
  *          1. The files reach the end of file
@@ -425,14 +624,8 @@ unsigned char read_and_retrieve_file_contents(unsigned char *file_name, unsigned
 unsigned char play_mp3_file(unsigned char *file_name)
 {
   struct dir_Structure *dir;
-  unsigned long cluster, byteCounter = 0, file_size, first_sector;
-  unsigned int k,iCntForSingleAudioWrite;
-  unsigned char j, error;
-  unsigned int iAudioByteCnt;
-  bool end_of_file=false;
-
-  uint16_t calc_crc, msg_crc;
-  uint8_t msg_len;
+  struct file_location location;
+  unsigned char error;
 
   playing_sound = true;
 
@@ -443,9 +636,31 @@ unsigned char play_mp3_file(unsigned char *file_name)
   if(dir == 0) 
     return (0);
 
-  cluster = (((unsigned long) dir->first_cluster_hi) << 16) | dir->first_cluster_lo;
+  location.first_cluster = (((unsigned long) dir->first_cluster_hi) << 16) | dir->first_cluster_lo;
+  location.size = dir->file_size;
+  return play_mp3_location(&location);
+}
 
-  file_size = dir->file_size;
+/**
+ * @brief  Plays an MP3 file found earlier with find_file_location, the same
+ *         way as play_mp3_file
+ * @param location - const struct file_location *, where the file is
+ * @return unsigned char - return 0 on success
+ */
+
+unsigned char play_mp3_location(const struct file_location *location)
+{
+  unsigned long cluster, byteCounter = 0, file_size, first_sector;
+  unsigned int k,iCntForSingleAudioWrite;
+  unsigned char j;
+  unsigned int iAudioByteCnt;
+  bool end_of_file=false;
+
+
+  playing_sound = true;
+
+  cluster = location->first_cluster;
+  file_size = location->size;
   vs1053_skip_play=false;
   while(1)
   {
@@ -479,6 +694,16 @@ unsigned char play_mp3_file(unsigned char *file_name)
             if(iAudioByteCnt++==k)return 0;    
           }  
         }
+        else
+        {
+          // Decoder buffer is full - sleep until DREQ rises or a key arrives
+          cli();
+          if(!(PINB & (1<<MP3_DREQ)) && !usart_keypad_data_ready)
+          {
+            scheduler_sleep();
+          }
+          sei();
+        }
 
         /*
         // KORY CHANGED
@@ -505,32 +730,26 @@ unsigned char play_mp3_file(unsigned char *file_name)
           usart_keypad_receive_action();
         }
 
+        // Packets are only flagged ready once their CRC has been checked
         if (usart_ui_message_ready) {
-
-          msg_len = usart_ui_received_packet[2];
-          calc_crc = ui_calculate_crc((unsigned char*)usart_ui_received_packet);
-          msg_crc = usart_ui_received_packet[msg_len - 2] << 8 | 
-                      usart_ui_received_packet[msg_len - 1];
-          if (msg_crc == calc_crc) {
-            switch (usart_ui_received_packet[5]) {
-              // Deal with volume here
-              case UI_CMD_VOLU:
-                vs1053_increase_vol();
-                usart_ui_message_ready = false;
-                break;
-              case UI_CMD_VOLD:
-                vs1053_decrease_vol();
-                usart_ui_message_ready = false;
-                break;
-              default:
-                // Handle in main loop
-                playing_sound = 0;
-                return 0;
-                break;
-            }
-          } else {
-            PRINTF("[IO] CRC failed on interrupt\n\r");
-            usart_ui_message_ready = false;
+          switch (usart_ui_received_packet[5]) {
+            // Deal with volume here; saving it only marks the settings and
+            // user state dirty, so the card is not written mid-clip
+            case UI_CMD_VOLU:
+              vs1053_increase_vol();
+              user_volume_changed();
+              usart_ui_message_ready = false;
+              break;
+            case UI_CMD_VOLD:
+              vs1053_decrease_vol();
+              user_volume_changed();
+              usart_ui_message_ready = false;
+              break;
+            default:
+              // Handle in main loop
+              playing_sound = 0;
+              return 0;
+              break;
           }
         }
       }
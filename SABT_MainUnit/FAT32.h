@@ -27,6 +27,7 @@
 #define BUFFER_SIZE      512
 //BOARD WILL RESET IF NOT SET TO 13
 #define FILE_NAME_LEN    13
+#define MAX_FILE_LOCATIONS 16 //most files find_file_locations looks up at once
 #define END_OF_FILE      26
 #define CLUSTERS_PER_RUN 60
 #define MAX_NUM_CLUSTERS 512  //max number of clusters that can be in teh dictionary file you are using 
@@ -145,6 +146,27 @@ struct dir_Structure
   unsigned long file_size;              // size of file in bytes
 };
 
+//Sequential reader for a file, one byte at a time. Sectors are read into
+//the shared SD buffer, so nothing else may use the SD card between reads.
+struct file_stream
+{
+  unsigned long cluster;                // cluster being read
+  unsigned long bytes_left;             // bytes not yet returned
+  unsigned char sector;                 // next sector to read in the cluster
+  unsigned int offset;                  // next byte in buffer
+  unsigned long first_cluster;          // for seek_file_stream
+  unsigned long size;
+  unsigned long cluster_index;          // position of cluster in the chain
+};
+
+//Where a file is on the card. Found once with find_file_location, it lets
+//the file be played again without searching the root directory.
+struct file_location
+{
+  unsigned long first_cluster;          // 0 if the file was not found
+  unsigned long size;
+};
+
 
 //************* external variables *************
 volatile unsigned long first_data_sector, root_cluster, total_clusters;
@@ -189,7 +211,16 @@ unsigned long get_set_next_cluster(unsigned long cluster_number,
 unsigned char read_file(unsigned char flag, unsigned char *file_name);
 unsigned char read_and_retrieve_file_contents(unsigned char *file_name,
                                               unsigned char *data_string);
+bool open_file_stream(struct file_stream *stream, unsigned char *file_name);
+int read_file_stream(struct file_stream *stream);
+bool seek_file_stream(struct file_stream *stream, unsigned long position);
+bool find_file_location(unsigned char *file_name,
+                        struct file_location *location);
+unsigned char find_file_locations(unsigned char (*file_names)[FILE_NAME_LEN],
+                                  struct file_location *locations,
+                                  unsigned char count);
 unsigned char play_mp3_file(unsigned char *file_name);
+unsigned char play_mp3_location(const struct file_location *location);
 unsigned char play_beep();
 unsigned char convert_file_name(unsigned char *file_name);
 int replace_the_contents_of_this_file_with(unsigned char *file_name,
@@ -27,6 +27,15 @@
 #include "PC_Handle.h"
 #include "debug.h"
 #include "io.h"
+#include "scheduler.h"
+#include "random.h"
+#include "translate.h"
+#include "backtranslate.h"
+#include "fsm.h"
+#include "store.h"
+#include "settings.h"
+#include "userlog.h"
+#include "user.h"
 
 #define F_CPU 8000000UL
 #define MAX_NUMBER_OF_MODES	20
@@ -20,49 +20,17 @@
 #include "common.h"
 
 static char last_dot;                   // char representing last big dot pressed
-char used_number[6] = {0, 0, 0, 0, 0, 0};
+static shuffle_bag_t dot_bag;           // dots not asked for yet this round
 
 /**
- * @brief based off of the internal timer (TCNT1) - we generate
- *        a psuedo-random number. Turn that into a number from 1 - 6
- *        return the charachter of that number;
+ * @brief Picks a random number from 1 - 6 that has not been used since
+ *        all six were last used, and returns the charachter of that number
  * @return char - charachter representation of a number from 1 - 6
  */
 char random_number_as_char()
 {
-  int num = TCNT1;
-  int i;
-
-  num *= PRIME;
-  num = (abs(num) % 6);
-
-  //while you are looking at a full section of the array
-  while(used_number[num])
-  {
-    num = TCNT1;
-    num *= PRIME;
-    num = (abs(num) % 6);
-  }
-
-  used_number[num] = 1;
-  used_num_cnt ++;
-
-  //if you find that you have used all of the letters, clear both the array and the count
-  if(used_num_cnt == NUM_DOTS)
-  {
-    for(i = 0; i < NUM_DOTS; i ++)
-      used_number[i] = 0;
-    used_num_cnt = 0;
-  }
-
   //change from range 0-5 to 1-6
-  num += 1;
-
-  // Return the number as a character
-  if (num >= 1 && num <= 6) return '0' + num;
-
-  // Default behavior, could not generate a valid char
-  return '0';
+  return '1' + shuffle_bag_draw(&dot_bag);
 }
 
 /**
@@ -88,7 +56,7 @@ void md1_main(void)
   {
     case STATE_INITIAL:
       PRINTF("[MD1] Entering MD1\n\r");
-      used_num_cnt = 0;
+      shuffle_bag_init(&dot_bag, NUM_DOTS);
       // Play the introductory message for Mode 1
       play_mp3(MODE_FILESET,MP3_INTRODUCTION);
       current_state = STATE_REQUEST_INPUT1;
@@ -106,6 +74,8 @@ void md1_main(void)
     case STATE_WAIT_INPUT:
       if(last_dot != 0)
         current_state = STATE_PROC_INPUT;
+      else
+        wait_for_input();
       break;
     case STATE_PROC_INPUT:
       if(last_dot != expected_dot)
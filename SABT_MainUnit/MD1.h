@@ -17,11 +17,8 @@
 #define STATE_PROC_INPUT     4   // Processed user input
 #define NUM_DOTS			 6   //number of dots for each braille cell
 
-#define PRIME                53
-
 int current_state;               // current state of the mode
 char expected_dot;               // The expected response from user 
-char used_num_cnt;
 
 void md1_main(void);
 void md1_reset(void);
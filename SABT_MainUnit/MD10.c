@@ -9,6 +9,10 @@
 #include "audio.h"
 #include "common.h"
 #include "script_eng_contraction.h"
+#include "script_english.h"
+#include "translate.h"
+#include "backtranslate.h"
+#include "words.h"
 
 #define LANG_FILESET "ENG_"
 
@@ -16,19 +20,112 @@ int md10_current_state, md10_prev_state = 0;
 char md10_last_dot, last_cell, expected_dot;
 char *sub_mode[NUM_SUB_MODES] = {"PCON","PABR","DICT"};
 static int game_mode = 0;
-static int word_num_inset = 20;
-static int set = 0;
-struct dir_Structure *location;
+static int word_index = -1;
 static char cell;
-static char buf[8];
-static char fname[12];
-static glyph_t* g1;
-static glyph_t* g2;
+static char buf[10];
+static const glyph_t* g1;
+static const glyph_t* g2;
 
 static char cell1_pattern;
 static char cell2_pattern;
 static char cell_control;
 
+// Dictation word, its clip and how it is written in contracted Braille
+static char dictation_text[WORDS_MAX_CELLS + 1];
+static char dictation_clip[WORDS_CLIP_SIZE + 2];
+static char dictation_cells[MAX_LINE_SIZE];
+static int dictation_length;
+static char word_result;
+
+/**
+ * @brief Moves word_index to the next contraction in contraction_glyphs,
+ *        skipping the prefix cells and wrapping around at the end
+ * @return Void
+ */
+static void md10_next_word(void)
+{
+  do {
+    word_index++;
+    if(word_index >= SCRIPT_CONTRACTION_LENGTH)
+    {
+      word_index = 0;
+    }
+  } while(glyph_next(&contraction_glyphs[word_index]) != NULL);
+}
+
+/**
+ * @brief Builds the CON<set>_W<word> sound file name for a contraction. The
+ *        set is the position of its prefix (0 for single cell contractions)
+ *        and the word is the position of its last cell among the symbols.
+ * @param prefix - const glyph_t*, prefix cell, NULL for single cell
+ * @param word - const glyph_t*, contraction glyph
+ * @return Void
+ */
+static void md10_word_file(const glyph_t* prefix, const glyph_t* word)
+{
+  int set = 0;
+  const glyph_t* symbol = search_script(&script_eng_contraction, glyph_pattern(word));
+
+  if(prefix != NULL)
+  {
+    set = prefix - &contraction_glyphs[SCRIPT_CONTRACTION_PREFIX_START] + 1;
+  }
+  sprintf(buf, "CON%d_W%d", set, (int)(symbol - contraction_glyphs) + 1);
+}
+
+/**
+ * @brief Picks the next dictation word from the word list and translates it
+ *        to contracted Braille
+ * @return bool - false if the word cannot be read or translated
+ */
+static bool md10_dictation_next(void)
+{
+  words_entry_t entry;
+  const glyph_t* letter;
+  int i;
+
+  if(!words_read(words_pick(), &entry))
+  {
+    return false;
+  }
+  for(i = 0; i < entry.length; i++)
+  {
+    letter = search_script(&script_english, entry.cells[i]);
+    if(letter == NULL || letter - script_english.glyphs >= 26)
+    {
+      return false;
+    }
+    dictation_text[i] = 'a' + (letter - script_english.glyphs);
+  }
+  dictation_text[i] = '\0';
+  sprintf(dictation_clip, "N%s", entry.clip);
+
+  dictation_length = translate_text(dictation_text, TRANSLATE_GRADE_2,
+    dictation_cells, sizeof(dictation_cells));
+  sprintf(dbgstr, "[MD10] Dictation word: %s, %d cells\n\r", dictation_text,
+    dictation_length);
+  PRINTF(dbgstr);
+  return dictation_length > 0;
+}
+
+/**
+ * @brief Checks the line written in dictation against the contracted word
+ * @return bool - true if every cell matches
+ */
+static bool md10_dictation_check(void)
+{
+  int i;
+
+  for(i = 0; i < dictation_length; i++)
+  {
+    if(io_line[i] != dictation_cells[i])
+    {
+      return false;
+    }
+  }
+  return io_line[i] == (char) END_OF_TEXT;
+}
+
 void md10_main(void) {
 
  switch(md10_current_state)
@@ -44,6 +141,8 @@ void md10_main(void) {
       break;
 
     case MD10_STATE_SELECT_MODE:
+	  // Waits for LEFT, RIGHT and ENTER through the mode's handlers
+	  wait_for_input();
 	  break;
  
  	case MD10_STATE_SUBMODE_INIT:
@@ -62,42 +161,31 @@ void md10_main(void) {
 			break;
 		}
 		md10_current_state = MD10_STATE_REQUEST_WRITE;
+		if (game_mode == 2) {
+			const char* list = ui_current_mode_options()->words;
+
+			md10_current_state = MD10_STATE_DICTATE;
+			if (!words_open(list[0] != '\0' ? list : MD10_WORD_LIST)) {
+				play_mp3(LANG_FILESET, MP3_INVALID_PATTERN);
+				md10_reset();
+			}
+		}
 		break;
 
 	case MD10_STATE_REQUEST_WRITE:
 		play_mp3("MD10","_WRT");
 		md10_current_state = MD10_STATE_REQUEST_INPUT;
-		if (word_num_inset == 36){
-					set = set + 1;
-					word_num_inset = 0;
-		}
-	    else {
-					word_num_inset = word_num_inset + 1;
-		}
+		md10_next_word();
 		break;
 
     case MD10_STATE_REQUEST_INPUT:
 	  switch(game_mode){
 	  	case 0:		    
 		    // to write <word><set>_<num> please press
-			sprintf(buf,"CON%d_W%d",set,word_num_inset-1);
-			sprintf(fname,"%s.mp3",buf);
-			PRINTF(buf);			
-			
-			bool e = convert_file_name ((unsigned char*)fname); //convert file_name into FAT format
-  			if(e) return;
-			location = find_files(GET_FILE,(unsigned char*)fname);
-			
-			if (!location) {
-			    if (word_num_inset == 36){
-					set = set + 1;
-					word_num_inset = 0;
-				}
-				else {
-					word_num_inset = word_num_inset + 1;
-				}
-				return;
-			}			
+			g2 = &contraction_glyphs[word_index];
+			g1 = glyph_prev(g2);
+			md10_word_file(g1, g2);
+			PRINTF(buf);
 			play_mp3(NULL,buf);
 			play_mp3(LANG_FILESET,"PRSS");
 					
@@ -106,29 +194,60 @@ void md10_main(void) {
 		case 1:
 			play_mp3("MD10","_PL2");
 			break;
-		case 2:
-			play_mp3("MD10","_PL3");
-			break;
 	  }
 	  break;
 
-	case MD10_STATE_SPELL_PATTERN:
-	  if(buf[3] != '0'){
-	    g1 = &contraction_pattern[CHARTOINT(buf[3])];   // Stores the preceding pattern for the cell
-		play_dot_sequence(g1);
-		play_mp3("MD10","_NXT");
+	case MD10_STATE_DICTATE:
+	  if (!md10_dictation_next()) {
+		play_mp3(LANG_FILESET, MP3_INVALID_PATTERN);
+		md10_reset();
+		break;
+	  }
+	  play_mp3("MD10","_WRT");
+	  play_mp3((char*) words_fileset(), dictation_clip);
+	  io_init();
+	  md10_current_state = MD10_STATE_DICTATE_INPUT;
+	  break;
+
+	case MD10_STATE_DICTATE_INPUT:
+	  if (!get_word(TRANSLATE_GRADE_2, &word_result)) {
+		// CANCEL twice on a blank cell goes back to the submode menu
+		if (io_user_abort) {
+		  md10_reset();
+		}
+		// A word that does not read as Braille or is not in the dictionary is
+		// wrong straight away, so the user starts over
+		else if (word_result == BACKTRANSLATE_INVALID) {
+		  play_mp3(LANG_FILESET, MP3_INVALID_PATTERN);
+		  io_init();
+		} else if (word_result == BACKTRANSLATE_UNKNOWN) {
+		  play_mp3("MD5_", "NFND");	// Word not found in the dictionary
+		  io_init();
 		}
-	  else g1 = NULL;
-	  int sym;
-	  if (strlen(buf) == 8){
-	  	sym = 10*CHARTOINT(buf[6])+CHARTOINT(buf[7]);
-		char test[10];
-		sprintf(test,"num%d",sym);
+		break;
 	  }
-	  else {
-	  	sym = CHARTOINT(buf[6]);						// Stores the alphabet/symbol glyph
+	  if (md10_dictation_check()) {
+		play_mp3(LANG_FILESET,"GOOD");
+		md10_current_state = MD10_STATE_DICTATE;
+	  } else {
+		// Spell out the contracted word, then let the user try again
+		play_mp3(LANG_FILESET,"NO");
+		for (int i = 0; i < dictation_length; i++) {
+		  if (i > 0) {
+			play_mp3("MD10","_NXT");
+		  }
+		  play_pattern((unsigned char)dictation_cells[i]);
+		}
+		play_mp3("MD10","_TRY");
+		play_mp3((char*) words_fileset(), dictation_clip);
 	  }
-	  g2 = &contraction_glyphs[sym-1];
+	  break;
+
+	case MD10_STATE_SPELL_PATTERN:
+	  if(g1 != NULL){
+		play_pattern((unsigned char)glyph_pattern(g1));   // Plays the preceding pattern for the cell
+		play_mp3("MD10","_NXT");
+		}
    	  play_dot_sequence(g2);
 	  md10_current_state = MD10_STATE_CELL1;
 	  io_init();
@@ -203,8 +322,18 @@ void md10_main(void) {
 	  break;
 
 	case MD10_STATE_CHECK:
-	  if(g1==NULL || cell1_pattern == g1->pattern){
-	      if(cell2_pattern == g2->pattern){
+	  {
+	    char cells[3];
+	    int cell_index = 0;
+
+	    // Decode what was written the same way get_line() would
+	    if(g1 != NULL){
+	      cells[cell_index++] = cell1_pattern;
+	    }
+	    cells[cell_index++] = cell2_pattern;
+	    cells[cell_index] = END_OF_TEXT;
+	    cell_index = 0;
+	    if(get_glyph(&script_eng_contraction, cells, &cell_index) == g2){
 			play_mp3(LANG_FILESET,"GOOD");
 			md10_current_state = MD10_STATE_REQUEST_WRITE;
 		  }
@@ -215,7 +344,7 @@ void md10_main(void) {
 			cell2_pattern = NO_DOTS;
 			md10_current_state = MD10_STATE_REQUEST_INPUT;
 		 }
-	  }        
+	  }
       break;
 	}
 }
@@ -223,8 +352,7 @@ void md10_main(void) {
 void md10_reset(void)
 {
   game_mode = 0;
-  word_num_inset = 0;
-  set = 0;
+  word_index = -1;
   md10_current_state = MD10_STATE_INITIAL;
   cell1_pattern = NO_DOTS;
   cell2_pattern = NO_DOTS;
@@ -240,12 +368,18 @@ void md10_call_mode_yes_answer(void) {
 }
 
 void md10_call_mode_no_answer(void) {	
+	// In dictation CANCEL clears a cell, see MD10_STATE_DICTATE_INPUT
+	if (md10_current_state != MD10_STATE_DICTATE_INPUT) {
     md10_reset(); // Pressing CANCEL exits to submode menu
+	}
 }
 
 void md10_input_dot(char this_dot) {
   md10_last_dot = this_dot;
-  play_requested_dot(this_dot);	
+  // get_line() reads out the dots in dictation
+  if (md10_current_state != MD10_STATE_DICTATE_INPUT) {
+    play_requested_dot(this_dot);	
+  }
 }
 
 void md10_input_cell(char this_cell) {
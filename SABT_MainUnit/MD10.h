@@ -17,8 +17,12 @@
 #define MD10_STATE_CHECK				    6		   // Checks if pattern is right
 #define MD10_STATE_REQUEST_WRITE			7		   // Requests the user to write in the pattern
 #define MD10_STATE_SPELL_PATTERN			8		   // Spells out the pattern for the user
+#define MD10_STATE_DICTATE					9		   // Dictation - says the next word
+#define MD10_STATE_DICTATE_INPUT			10		   // Dictation - waits for the word
+
+// Word list read out in dictation when MODES.DAT names none
+#define MD10_WORD_LIST "ANIMALS"
 
-#define PRIME                53
 #define NUM_SUB_MODES		 3
 
 char entered_letter;                       // Current letter being entered
@@ -18,16 +18,10 @@
 #define SCRIPT_LENGTH SCRIPT_ENGLISH_LENGTH
 #define LANG_FILESET "ENG_"
 #define MODE_FILESET "MD11"
-
-
-const char *noise_list[MAX_INDEX + 1] = {"aeroplane", "rain", "bell", "doorbell", "horn", "auto",
-    "truck", "train", "siren", "phone", "clock", NULL};
-
-const char* noise_sounds[MAX_INDEX + 1] = {"AER", "RAI", "BEL", "DOO", "HOR", "AUT",
-    "TRU", "TRA", "SIR", "PHO", "CLO", NULL};
+#define WORD_LIST "NOISES"
 
 void md11_reset(void) {
-	sound_game_reset(SCRIPT_ADDRESS, LANG_FILESET, MODE_FILESET, noise_list, noise_sounds);
+	sound_game_reset(SCRIPT_ADDRESS, LANG_FILESET, MODE_FILESET, WORD_LIST);
 }
 
 void md11_main(void) {
@@ -25,8 +25,6 @@
 #define STATE_WORD_HINT				   14
 #define STATE_BUTTON_HINT			   15
 
-#define PRIME                	53
-
 // Int array representing the noises that have been used already.
 int noises_used_list[11];                 
 // Keeps track of number of noises used in current rotation
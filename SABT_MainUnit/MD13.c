@@ -0,0 +1,163 @@
+/**
+ * @file MD13.c
+ * @brief Mode 13 code - SD card games. Runs a game script from the SD card
+ *        with the interpreter in fsm.c and supplies its platform functions.
+ */
+
+#include <string.h>
+#include "globals.h"
+#include "audio.h"
+#include "common.h"
+#include "script_common.h"
+#include "script_english.h"
+#include "fsm.h"
+#include "MD13.h"
+
+static char this_mode_fileset[5] = "MD13";
+
+// State variables
+static char next_state = MD13_STATE_INITIAL;
+static struct file_stream md13_stream;
+static bool md13_stream_open = false;
+
+/**
+ * @brief Reads part of the game script. The stream is moved before every read
+ *        because other tasks use the SD buffer between calls.
+ * @param offset - unsigned int, offset into the script
+ * @param dest - unsigned char*, set to the bytes read
+ * @param length - unsigned char, number of bytes to read; bytes past the end
+ *        of the script read as 0
+ * @return bool - false if the card could not be read
+ */
+bool fsm_platform_read(unsigned int offset, unsigned char* dest,
+	unsigned char length) {
+	unsigned char i = 0;
+	int byte;
+
+	if (!md13_stream_open) {
+		return false;
+	}
+	if (offset < md13_stream.size) {
+		if (!seek_file_stream(&md13_stream, offset)) {
+			return false;
+		}
+		for (; i < length; i++) {
+			byte = read_file_stream(&md13_stream);
+			if (byte < 0) {
+				break;
+			}
+			dest[i] = byte;
+		}
+	}
+	for (; i < length; i++) {
+		dest[i] = 0;
+	}
+	return true;
+}
+
+void fsm_platform_play(char* fileset, char* name) {
+	play_mp3(fileset, name);
+}
+
+void fsm_platform_say_number(int number) {
+	play_number(number);
+}
+
+void fsm_platform_say_cell(char pattern) {
+	play_pattern(pattern);
+}
+
+int fsm_platform_random(int limit) {
+	return random_below(limit);
+}
+
+char fsm_platform_letter(char pattern) {
+	const glyph_t* glyph = search_script(&script_english, pattern);
+
+	if (glyph == NULL) {
+		return '\0';
+	}
+	return 'a' + (glyph - script_english.glyphs);
+}
+
+bool fsm_platform_in_dictionary(char* word) {
+	return bin_srch_dict((unsigned char*)word);
+}
+
+/**
+ * @brief Maps a dot from the UI board to a script input event
+ * @param dot - char, value from get_dot()
+ * @return bool - false if the script has no handler for it
+ */
+static bool md13_input(char dot) {
+	switch (dot) {
+		case '1': case '2': case '3': case '4': case '5': case '6':
+			return fsm_input(FSM_EVENT_DOT, CHARTOINT(dot));
+		case ENTER:
+			return fsm_input(FSM_EVENT_ENTER, 0);
+		case CANCEL:
+			return fsm_input(FSM_EVENT_CANCEL, 0);
+		case LEFT:
+			return fsm_input(FSM_EVENT_LEFT, 0);
+		case RIGHT:
+			return fsm_input(FSM_EVENT_RIGHT, 0);
+		default:
+			return false;
+	}
+}
+
+void md13_reset(void) {
+	unsigned char file_name[FILE_NAME_LEN];
+
+	set_mode_globals(&script_english, script_english.fileset, this_mode_fileset);
+	strcpy((char*)file_name, MD13_GAME_FILE);
+	md13_stream_open = open_file_stream(&md13_stream, file_name);
+	next_state = MD13_STATE_RUN;
+	if (!md13_stream_open || !fsm_start()) {
+		PRINTF("[MD13] Could not load " MD13_GAME_FILE "\n\r");
+		play_mp3(lang_fileset, MP3_INVALID_PATTERN);
+		next_state = MD13_STATE_INITIAL;
+	}
+	PRINTF("[MD13] Mode reset\n\r");
+}
+
+void md13_main(void) {
+	char dot;
+
+	switch (next_state) {
+		case MD13_STATE_RUN:
+			switch (fsm_run()) {
+				case FSM_WAITING:
+					next_state = MD13_STATE_INPUT;
+					break;
+				case FSM_ENDED:
+					quit_mode();
+					break;
+				case FSM_ERROR:
+					sprintf(dbgstr, "[MD13] Script error at %u\n\r",
+						fsm_error_offset());
+					PRINTF(dbgstr);
+					play_mp3(lang_fileset, MP3_INVALID_PATTERN);
+					quit_mode();
+					break;
+				default:
+					break;
+			}
+			break;
+
+		case MD13_STATE_INPUT:
+			dot = get_dot();
+			if (dot == NO_DOTS) {
+				break;
+			}
+			// If no handler took the input, fsm_run() reports whether the
+			// script is still waiting or could not read its handlers
+			md13_input(dot);
+			next_state = MD13_STATE_RUN;
+			break;
+
+		default:
+			quit_mode();
+			break;
+	}
+}
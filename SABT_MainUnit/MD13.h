@@ -0,0 +1,20 @@
+/**
+ * @file MD13.h
+ * @brief Declarations for mode 13 - SD card games
+ */
+
+#ifndef _MD13_H_
+#define _MD13_H_
+
+// Game script run by this mode; see tools/fsm/README for the format
+#define MD13_GAME_FILE "GAME.FSM"
+
+// State definitions
+#define MD13_STATE_INITIAL  0b00000000  // Initial state
+#define MD13_STATE_RUN      0b00000001  // Runs the script until it waits
+#define MD13_STATE_INPUT    0b00000010  // Passes input to the script
+
+void md13_main(void);
+void md13_reset(void);
+
+#endif /* _MD13_H_ */
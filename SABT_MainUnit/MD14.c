@@ -0,0 +1,121 @@
+/**
+ * @file MD14.c
+ * @brief Mode 14 code - Log in. The user writes their login code; the code
+ *        is looked up in USERS.DAT and the user's saved state is loaded.
+ */
+
+#include "globals.h"
+#include "audio.h"
+#include "common.h"
+#include "script_common.h"
+#include "script_english.h"
+#include "user.h"
+#include "MD14.h"
+
+static char this_mode_fileset[5] = "MD14";
+
+// State variables
+static char next_state = MD14_STATE_INITIAL;
+static char code[USER_CODE_SIZE];
+static unsigned char code_length = 0;
+static char incorrect_tries = 0;
+
+void md14_reset(void) {
+	set_mode_globals(&script_english, script_english.fileset, this_mode_fileset);
+	code_length = 0;
+	incorrect_tries = 0;
+	if (user_current != USER_GUEST && user_current != USER_NONE) {
+		play_mp3(mode_fileset, MP3_USER);
+		play_number(user_current);
+		next_state = MD14_STATE_ASK;
+	} else {
+		next_state = MD14_STATE_PROMPT;
+	}
+	PRINTF("[MD14] Mode reset\n\r");
+}
+
+void md14_main(void) {
+	char cell;
+	unsigned char user;
+
+	switch (next_state) {
+
+		// Someone is already logged in
+		case MD14_STATE_ASK:
+			switch (create_dialog(MP3_SWITCH, ENTER_CANCEL)) {
+				case ENTER:
+					next_state = MD14_STATE_PROMPT;
+					break;
+				case CANCEL:
+					user_logout();
+					play_mp3(mode_fileset, MP3_LOGGED_OUT);
+					quit_mode();
+					break;
+				default:
+					break;
+			}
+			break;
+
+		case MD14_STATE_PROMPT:
+			code_length = 0;
+			play_mp3(mode_fileset, MP3_CODE);
+			next_state = MD14_STATE_INPUT;
+			break;
+
+		// ENTER after dots adds a cell to the code, ENTER on its own ends it;
+		// CANCEL starts the code again, or leaves if there is nothing to cancel
+		case MD14_STATE_INPUT:
+			cell = get_cell();
+			if (cell == NO_DOTS) {
+				break;
+			}
+			switch (GET_CELL_CONTROL(cell)) {
+				case WITH_ENTER:
+					if (GET_CELL_PATTERN(cell) == NO_DOTS) {
+						next_state = (code_length > 0) ?
+							MD14_STATE_CHECK : MD14_STATE_PROMPT;
+					} else if (code_length < USER_CODE_SIZE) {
+						code[code_length++] = GET_CELL_PATTERN(cell);
+						play_pattern(GET_CELL_PATTERN(cell));
+					} else {
+						play_mp3(lang_fileset, MP3_LAST_CELL);
+					}
+					break;
+				case WITH_CANCEL:
+					if (code_length > 0) {
+						next_state = MD14_STATE_PROMPT;
+					} else {
+						quit_mode();
+					}
+					break;
+				default:
+					break;
+			}
+			break;
+
+		case MD14_STATE_CHECK:
+			user = user_find(code, code_length);
+			if (user == USER_NONE) {
+				sprintf(dbgstr, "[MD14] Unknown code, %d cells\n\r", code_length);
+				PRINTF(dbgstr);
+				play_mp3(lang_fileset, MP3_INCORRECT);
+				incorrect_tries++;
+				if (incorrect_tries >= MAX_INCORRECT_TRIES) {
+					quit_mode();
+				} else {
+					play_mp3(lang_fileset, MP3_TRY_AGAIN);
+					next_state = MD14_STATE_PROMPT;
+				}
+				break;
+			}
+			user_login(user);
+			play_mp3(mode_fileset, MP3_WELCOME);
+			play_number(user);
+			quit_mode();
+			break;
+
+		default:
+			quit_mode();
+			break;
+	}
+}
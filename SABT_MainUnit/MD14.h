@@ -0,0 +1,28 @@
+/**
+ * @file MD14.h
+ * @brief Declarations for mode 14 - Log in
+ */
+
+#ifndef _MD14_H_
+#define _MD14_H_
+
+// State definitions
+#define MD14_STATE_INITIAL  0b00000000  // Initial state
+#define MD14_STATE_ASK      0b00000001  // Someone is logged in: switch or log out
+#define MD14_STATE_PROMPT   0b00000010  // Asks for the login code
+#define MD14_STATE_INPUT    0b00000011  // Reads the code one cell at a time
+#define MD14_STATE_CHECK    0b00000100  // Looks the code up and logs in
+
+#define MAX_INCORRECT_TRIES 3
+
+// Mode MP3 constants
+#define MP3_USER "USER"     // "You are logged in as user"
+#define MP3_SWITCH "SWCH"   // "Press ENTER to log in as someone else, or CANCEL to log out"
+#define MP3_CODE "CODE"     // "Write your code, pressing ENTER after each cell and again at the end"
+#define MP3_WELCOME "WELC"  // "Welcome, user"
+#define MP3_LOGGED_OUT "OUT"
+
+void md14_main(void);
+void md14_reset(void);
+
+#endif /* _MD14_H_ */
@@ -0,0 +1,252 @@
+/**
+ * @file MD15.c
+ * @brief Mode 15 code - Letter reference. Reads out each letter and how to
+ *        write it, scrolled with the LEFT and RIGHT buttons. A few letters
+ *        either side of the current one are looked up on the card while the
+ *        user listens, so scrolling to them starts at once.
+ */
+
+#include "globals.h"
+#include "audio.h"
+#include "common.h"
+#include "io.h"
+#include "script_common.h"
+#include "MD15.h"
+
+/* Change this script header for new script */
+#include "script_english.h"
+
+// Change these script pointers for new script
+static script_t* this_script = &script_english;
+static char* this_lang_fileset = script_english.fileset;
+static char this_mode_fileset[5] = "MD15";
+
+// State variables
+static char next_state = MD15_STATE_INITIAL;
+static const glyph_t* letters[MD15_WINDOW];
+static int letter_indices[MD15_WINDOW];
+static clip_t letter_clips[MD15_WINDOW];
+static bool letters_found = false;
+
+/**
+ * @brief Finds the letter after or before a position in the script, going
+ * 	round from the last letter to the first and back
+ * @param int index - Position of the letter in the script
+ * @param bool forwards - True for the next letter, false for the previous one
+ * @param int* neighbour_index - Set to the position of the letter found
+ * @return const glyph_t* - The letter, NULL if the script is empty
+ */
+static const glyph_t* md15_neighbour(int index, bool forwards,
+	int* neighbour_index) {
+	const glyph_t* glyph;
+
+	this_script->index = index;
+	glyph = forwards ? get_next_glyph(this_script) :
+		get_prev_glyph(this_script);
+	if (glyph == NULL) {
+		this_script->index = forwards ? -1 : this_script->length;
+		glyph = forwards ? get_next_glyph(this_script) :
+			get_prev_glyph(this_script);
+	}
+	*neighbour_index = this_script->index;
+	return glyph;
+}
+
+/**
+ * @brief Puts a letter in a place of the window; its clip is looked up later
+ * @param unsigned char slot - Place in the window, MD15_CURRENT in the middle
+ * @param const glyph_t* glyph - The letter
+ * @param int index - Position of the letter in the script
+ * @return void
+ */
+static void md15_set_letter(unsigned char slot, const glyph_t* glyph,
+	int index) {
+	letters[slot] = glyph;
+	letter_indices[slot] = index;
+	letter_clips[slot].location.first_cluster = 0;
+	if (glyph != NULL) {
+		glyph_sound(glyph, letter_clips[slot].mp3);
+		letter_clips[slot].fileset =
+			glyph_sound_fileset(letter_clips[slot].mp3, this_lang_fileset);
+	}
+	letters_found = false;
+}
+
+/**
+ * @brief Copies a letter, with its clip, from one place of the window to
+ * 	another
+ * @param unsigned char to - Place to copy to
+ * @param unsigned char from - Place to copy from
+ * @return void
+ */
+static void md15_copy_letter(unsigned char to, unsigned char from) {
+	letters[to] = letters[from];
+	letter_indices[to] = letter_indices[from];
+	letter_clips[to] = letter_clips[from];
+}
+
+/**
+ * @brief Fills the window outwards from the current letter
+ * @param void
+ * @return void
+ */
+static void md15_fill_window(void) {
+	const glyph_t* glyph;
+	int index;
+
+	for (unsigned char i = 1; i <= MD15_REACH; i++) {
+		glyph = md15_neighbour(letter_indices[MD15_CURRENT + i - 1], true,
+			&index);
+		md15_set_letter(MD15_CURRENT + i, glyph, index);
+		glyph = md15_neighbour(letter_indices[MD15_CURRENT - i + 1], false,
+			&index);
+		md15_set_letter(MD15_CURRENT - i, glyph, index);
+	}
+}
+
+/**
+ * @brief Looks up the clips of the letters in the window that have not been
+ * 	found yet, with one pass over the card's directory
+ * @param void
+ * @return void
+ */
+static void md15_find_letters(void) {
+	unsigned char file_names[MD15_WINDOW][FILE_NAME_LEN];
+	struct file_location locations[MD15_WINDOW];
+	unsigned char slots[MD15_WINDOW];
+	unsigned char count = 0;
+
+	for (unsigned char i = 0; i < MD15_WINDOW; i++) {
+		if (letters[i] != NULL && letter_clips[i].location.first_cluster == 0) {
+			if (letter_clips[i].fileset != NULL)
+				sprintf((char*)file_names[count], "%s%s.mp3",
+					letter_clips[i].fileset, letter_clips[i].mp3);
+			else
+				sprintf((char*)file_names[count], "%s.mp3",
+					letter_clips[i].mp3);
+			slots[count++] = i;
+		}
+	}
+	if (count > 0) {
+		find_file_locations(file_names, locations, count);
+		for (unsigned char i = 0; i < count; i++) {
+			letter_clips[slots[i]].location = locations[i];
+		}
+	}
+	letters_found = true;
+}
+
+/**
+ * @brief Reads out the current letter and its dots, cutting off whatever
+ * 	was playing
+ * @param void
+ * @return void
+ */
+static void md15_play_letter(void) {
+	stop_playlist();
+	if (letters[MD15_CURRENT] == NULL) {
+		return;
+	}
+	// Scrolled on before the letter was looked up
+	if (letter_clips[MD15_CURRENT].location.first_cluster == 0) {
+		md15_find_letters();
+	}
+	play_clips(&letter_clips[MD15_CURRENT], 1);
+	play_dot_sequence(letters[MD15_CURRENT]);
+}
+
+/**
+ * @brief Moves to the next or previous letter and reads it out. The window
+ * 	slides one place, so only the new letter at its far end has not been
+ * 	looked up; the browse state finds all those missing in one pass.
+ * @param bool forwards - True for the next letter, false for the previous one
+ * @return void
+ */
+static void md15_move(bool forwards) {
+	unsigned char edge = forwards ? MD15_WINDOW - 1 : 0;
+	unsigned char inside = forwards ? MD15_WINDOW - 2 : 1;
+	const glyph_t* glyph;
+	int index;
+
+	if (next_state != MD15_STATE_BROWSE) {
+		return;
+	}
+
+	if (forwards) {
+		for (unsigned char i = 0; i < MD15_WINDOW - 1; i++) {
+			md15_copy_letter(i, i + 1);
+		}
+	} else {
+		for (unsigned char i = MD15_WINDOW - 1; i > 0; i--) {
+			md15_copy_letter(i, i - 1);
+		}
+	}
+
+	glyph = md15_neighbour(letter_indices[inside], forwards, &index);
+	md15_set_letter(edge, glyph, index);
+	md15_play_letter();
+}
+
+void md15_reset(void) {
+	// Can be set to another language with lang= in MODES.DAT
+	script_t* language_script =
+		find_language_script(ui_current_mode_options()->language);
+	if (language_script != NULL) {
+		this_script = language_script;
+		this_lang_fileset = language_script->fileset;
+	}
+	set_mode_globals(this_script, this_lang_fileset, this_mode_fileset);
+	for (unsigned char i = 0; i < MD15_WINDOW; i++) {
+		md15_set_letter(i, NULL, -1);
+	}
+	next_state = MD15_STATE_INITIAL;
+	PRINTF("[MD15] Mode reset\n\r");
+}
+
+void md15_main(void) {
+	const glyph_t* glyph;
+	int index;
+
+	switch (next_state) {
+
+		case MD15_STATE_INITIAL:
+			play_mp3(mode_fileset, MP3_INTRO);
+			glyph = md15_neighbour(-1, true, &index);
+			md15_set_letter(MD15_CURRENT, glyph, index);
+			md15_fill_window();
+			md15_find_letters();
+			if (letters[MD15_CURRENT] != NULL) {
+				play_clips(&letter_clips[MD15_CURRENT], 1);
+				play_dot_sequence(letters[MD15_CURRENT]);
+			}
+			next_state = MD15_STATE_BROWSE;
+			break;
+
+		// Buttons are handled as they arrive by the handlers below, which cut
+		// off the letter being read; this only looks up the new neighbours
+		case MD15_STATE_BROWSE:
+			if (!letters_found) {
+				md15_find_letters();
+			}
+			io_dot = NO_DOTS;
+			io_waiting_for_input = true;
+			break;
+
+		default:
+			break;
+	}
+}
+
+void md15_call_mode_yes_answer(void) {
+	if (next_state == MD15_STATE_BROWSE) {
+		md15_play_letter();
+	}
+}
+
+void md15_call_mode_left(void) {
+	md15_move(false);
+}
+
+void md15_call_mode_right(void) {
+	md15_move(true);
+}
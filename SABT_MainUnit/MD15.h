@@ -0,0 +1,28 @@
+/**
+ * @file MD15.h
+ * @brief Declarations for mode 15 - Letter reference
+ */
+
+#ifndef _MD15_H_
+#define _MD15_H_
+
+// State definitions
+#define MD15_STATE_INITIAL  0b00000000  // Plays the introduction and the first letter
+#define MD15_STATE_BROWSE   0b00000001  // Reads out letters as the user scrolls
+
+// The letter being read out sits in the middle of a window of MD15_REACH
+// letters either side of it, so a few quick steps never wait for the card
+#define MD15_REACH    3
+#define MD15_CURRENT  MD15_REACH
+#define MD15_WINDOW   (2 * MD15_REACH + 1)
+
+// Mode MP3 constants
+#define MP3_INTRO "INT"     // "Press RIGHT and LEFT to move through the letters and ENTER to hear one again"
+
+void md15_main(void);
+void md15_reset(void);
+void md15_call_mode_yes_answer(void);
+void md15_call_mode_left(void);
+void md15_call_mode_right(void);
+
+#endif /* _MD15_H_ */
@@ -22,16 +22,10 @@
 #define SCRIPT_LENGTH SCRIPT_ENGLISH_LENGTH
 #define LANG_FILESET "ENG_"
 #define MODE_FILESET "MD3_"
-
-
-const char *animal_list[MAX_INDEX + 1] = {"bee", "camel", "cat", "cow", "dog", "horse",
-    "hyena", "pig", "rooster", "sheep", "zebra", NULL};
-	
-const char* animal_sounds[MAX_INDEX + 1] = {"BEE","CAM","CAT","COW","DOG","HOR",
-    "HYE","PIG","ROO","SHE","ZEB", NULL};
+#define WORD_LIST "ANIMALS"
 
 void md3_reset(void) {
-	sound_game_reset(SCRIPT_ADDRESS, LANG_FILESET, MODE_FILESET, animal_list, animal_sounds);
+	sound_game_reset(SCRIPT_ADDRESS, LANG_FILESET, MODE_FILESET, WORD_LIST);
 }
 
 void md3_main(void) {
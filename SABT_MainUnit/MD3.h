@@ -18,8 +18,6 @@
 #define STATE_CHECK 0x05
 #define STATE_REPROMPT 0x06
 
-#define PRIME                	53
-
 // Submode constants
 #define SUBMODE_NULL 0x00
 #define SUBMODE_PLAY 0x01
@@ -22,7 +22,7 @@ static char this_mode_fileset[5] = "MD6_";
 
 // State variables
 static char next_state = MD6_STATE_INITIAL;
-static glyph_t *this_glyph = NULL;
+static const glyph_t *this_glyph = NULL;
 static char incorrect_tries = 0;
 static char cell = 0;
 static char cell_pattern = 0;
@@ -30,6 +30,13 @@ static char cell_control = 0;
 
 
 void md6_reset(void) {
+	// Free play can be set to another language with lang= in MODES.DAT
+	script_t* language_script =
+		find_language_script(ui_current_mode_options()->language);
+	if (language_script != NULL) {
+		this_script = language_script;
+		this_lang_fileset = language_script->fileset;
+	}
 	set_mode_globals(this_script, this_lang_fileset, this_mode_fileset);
 	mode_fileset = this_mode_fileset;
 	this_glyph = NULL;
@@ -9,6 +9,8 @@
 #include "audio.h"
 #include "script_common.h"
 #include "script_digits.h"
+#include "user.h"
+#include "MD9.h"
 
 #define STATE_NULL 0x00
 #define STATE_MENU 0x01
@@ -24,12 +26,15 @@
 #define SUBMODE_ADD 0x01
 #define SUBMODE_SUB	0x02
 #define SUBMODE_MUL 0x03
+#define SUBMODE_DIV 0x04
+#define SUBMODE_COUNT 5
 
-// Difficulty levels
+// Difficulty levels, each starts the ladder of steps (MD9.h) further up
 #define LEVEL_NULL	0x0000
 #define LEVEL_1			0x0001
 #define LEVEL_2			0x0002
 #define LEVEL_3			0x0003
+#define LEVEL_COUNT		3
 
 // Used to set global fileset variables
 #define LANG_FILESET "ENG_"
@@ -47,18 +52,63 @@
 #define MP3_PLUS	"PLUS"
 #define MP3_MINUS	"MINS"
 #define MP3_TIMES	"TIMS"
+#define MP3_DIVIDED_BY "DIVB"
 #define MP3_YOU_ANSWERED "UANS"
 // Skip prompt
 #define MP3_SKIP "SKIP"
 #define MP3_THE_ANSWER_IS "TAIS"
 
 // Limits
-#define MAX_DIGITS 3
+#define MAX_DIGITS 4
 #define MAX_INCORRECT_TRIES 3
+// "What is", an operator and two operands
+#define QUESTION_CLIPS (2 + 2 * NUMBER_MAX_CLIPS)
+
+/* Steps for addition: the larger operand, the smaller one and whether a
+	column must carry */
+static const md9_step_t md_add_steps[MD9_STEPS] PROGMEM = {
+	{9, 9, false}, {9, 9, true},
+	{99, 9, false}, {99, 9, true},
+	{99, 99, false}, {99, 99, true},
+	{999, 99, false}, {999, 99, true},
+	{999, 999, false}, {999, 999, true}
+};
+
+/* Steps for subtraction: the larger operand, the smaller one and whether a
+	column must borrow. One digit from one digit never borrows, so the first
+	borrowing step takes a teen number, up to 18, from one digit. */
+static const md9_step_t md_sub_steps[MD9_STEPS] PROGMEM = {
+	{9, 9, false}, {18, 9, true},
+	{99, 9, false}, {99, 9, true},
+	{99, 99, false}, {99, 99, true},
+	{999, 99, false}, {999, 99, true},
+	{999, 999, false}, {999, 999, true}
+};
+
+/* Steps for multiplication: the factors and whether a digit product must
+	carry */
+static const md9_step_t md_mul_steps[MD9_STEPS] PROGMEM = {
+	{5, 5, false}, {9, 9, true},
+	{99, 5, false}, {99, 5, true},
+	{99, 9, false}, {99, 9, true},
+	{999, 9, false}, {999, 9, true},
+	{99, 99, false}, {99, 99, true}
+};
+
+/* Steps for division: the answer, the divisor and whether the long division
+	must carry a remainder to the next digit. A one digit answer never
+	carries, so carrying starts with two digit answers. */
+static const md9_step_t md_div_steps[MD9_STEPS] PROGMEM = {
+	{9, 5, false}, {9, 9, false},
+	{99, 5, false}, {99, 5, true},
+	{99, 9, false}, {99, 9, true},
+	{999, 9, false}, {999, 9, true},
+	{99, 99, false}, {99, 99, true}
+};
 
 // State variables
 static char md_next_state = STATE_NULL;
-static char md_submode = SUBMODE_NUL;
+static unsigned char md_submode = SUBMODE_NUL;
 static char md_last_dot = NO_DOTS;
 static int md_level = 0;
 static int md_op_1 = -1;
@@ -67,7 +117,20 @@ static int md_res = -1;
 static int md_usr_res = -1;
 static bool md_input_ready = false;
 static bool md_input_valid = false;
-static bool md_incorrect_tries = 0;
+static unsigned char md_incorrect_tries = 0;
+
+// Adaptive difficulty, by submode
+static md9_progress_t md_progress[SUBMODE_COUNT];
+static bool md_judged = false;
+static bool md_timing = false;
+static uint32_t md_asked_at = 0;
+static uint32_t md_answer_ms = 0;
+
+// The question, looked up on the card before it is asked
+static clip_t md_clip_what_is;
+static clip_t md_clip_operator;
+static clip_t md_question[QUESTION_CLIPS];
+static unsigned char md_question_size = 0;
 
 
 void md9_reset(void) {
@@ -88,67 +151,300 @@ void md9_reset(void) {
 	md_input_ready = false;
 	md_input_valid = false;
 	md_incorrect_tries = 0;
+	memset(md_progress, 0, sizeof(md_progress));
+	md_judged = false;
+	md_timing = false;
+	md_question_size = 0;
+}
+
+/**
+ * @brief Whether adding two numbers carries in any column
+ * @param int op_1 - First operand
+ * @param int op_2 - Second operand
+ * @return bool - True if a column adds up to 10 or more
+ */
+bool md9_add_carries(int op_1, int op_2) {
+	for (; op_1 > 0 || op_2 > 0; op_1 /= 10, op_2 /= 10) {
+		if (op_1 % 10 + op_2 % 10 >= 10) {
+			return true;
+		}
+	}
+	return false;
 }
 
+/**
+ * @brief Whether subtracting needs a borrow in any column
+ * @param int op_1 - Larger operand
+ * @param int op_2 - Smaller operand
+ * @return bool - True if a digit of op_2 is larger than the one above it
+ */
+bool md9_sub_borrows(int op_1, int op_2) {
+	for (; op_2 > 0; op_1 /= 10, op_2 /= 10) {
+		if (op_1 % 10 < op_2 % 10) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Whether long multiplication carries: a digit product of 10 or more,
+ * 	or partial products that carry when added up
+ * @param int op_1 - Upper factor
+ * @param int op_2 - Lower factor, up to two digits
+ * @return bool - True if anything is carried
+ */
+bool md9_mul_carries(int op_1, int op_2) {
+	for (int a = op_1; a > 0; a /= 10) {
+		for (int b = op_2; b > 0; b /= 10) {
+			if ((a % 10) * (b % 10) >= 10) {
+				return true;
+			}
+		}
+	}
+	return op_2 >= 10
+		&& md9_add_carries(op_1 * (op_2 % 10), op_1 * (op_2 / 10) * 10);
+}
+
+/**
+ * @brief Whether long division carries a remainder to the next digit
+ * @param int dividend - Number divided, up to 4 digits
+ * @param int divisor - Number divided by
+ * @return bool - True if a remainder is left before the last digit
+ */
+bool md9_div_carries(int dividend, int divisor) {
+	int remainder = 0;
+	bool started = false;
+
+	for (int place = 1000; place > 0; place /= 10) {
+		remainder = remainder * 10 + (dividend / place) % 10;
+		// Leading digits smaller than the divisor are taken together
+		if (!started && remainder < divisor) {
+			continue;
+		}
+		started = true;
+		remainder %= divisor;
+		if (remainder != 0 && place > 1) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Picks a number with as many digits as max, e.g. 10 to 99 for 99
+ * @param int max - Largest number, 9, 99 or 999 (or 18, for 1 to 18)
+ * @param int min - Smallest number allowed
+ * @return int - Number between the smallest of its length and max
+ */
+int md9_random_operand(int max, int min) {
+	int low = (max + 1) / 10;
+	if (low < min) {
+		low = min;
+	}
+	return low + random_below(max - low + 1);
+}
+
+/**
+ * @brief Generates a question at the current step of the submode. The
+ * 	operands fill the step's ranges and carry (or not) as the step asks; if
+ * 	no such question turns up in MD9_GENERATE_TRIES the last one is kept.
+ * @return void
+ */
 void md9_generate_question(void) {
-	
-	// Sets bound for result
-	int bound = 1;
-	for (int i = 0; i < md_level; i++) {
-		bound *= 10;
+	md9_step_t step;
+	const md9_step_t* steps;
+	bool carries = false;
+
+	switch (md_submode) {
+		case SUBMODE_SUB:
+			steps = md_sub_steps;
+			break;
+		case SUBMODE_MUL:
+			steps = md_mul_steps;
+			break;
+		case SUBMODE_DIV:
+			steps = md_div_steps;
+			break;
+		default:
+			steps = md_add_steps;
+			break;
 	}
+	memcpy_P(&step, &steps[md_progress[md_submode].step], sizeof(step));
 
-	do {
-		md_op_1 = timer_rand() % bound;
-		sprintf(dbgstr, "[MD9] Operand 1: %d\n\r", md_op_1);
-		PRINTF(dbgstr);
-		md_op_2 = timer_rand() % bound;
-		sprintf(dbgstr, "[MD9] Operand 2: %d\n\r", md_op_2);
-		PRINTF(dbgstr);
-		
+	for (int i = 0; i < MD9_GENERATE_TRIES; i++) {
 		switch (md_submode) {
 			case SUBMODE_ADD:
+				md_op_1 = md9_random_operand(step.max_1, 0);
+				md_op_2 = md9_random_operand(step.max_2, 0);
 				md_res = md_op_1 + md_op_2;
+				carries = md9_add_carries(md_op_1, md_op_2);
 				break;
 			case SUBMODE_SUB:
+				md_op_1 = md9_random_operand(step.max_1, 1);
+				md_op_2 = md9_random_operand(step.max_2, 0);
+				if (md_op_2 > md_op_1) {
+					int larger = md_op_2;
+					md_op_2 = md_op_1;
+					md_op_1 = larger;
+				}
 				md_res = md_op_1 - md_op_2;
+				carries = md9_sub_borrows(md_op_1, md_op_2);
 				break;
 			case SUBMODE_MUL:
+				md_op_1 = md9_random_operand(step.max_1, 1);
+				md_op_2 = md9_random_operand(step.max_2, 1);
 				md_res = md_op_1 * md_op_2;
+				carries = md9_mul_carries(md_op_1, md_op_2);
+				break;
+			case SUBMODE_DIV:
+				// Built from the answer so that it divides exactly
+				md_res = md9_random_operand(step.max_1, 1);
+				md_op_2 = md9_random_operand(step.max_2, 2);
+				md_op_1 = md_res * md_op_2;
+				carries = md9_div_carries(md_op_1, md_op_2);
 				break;
 			default:
-				sprintf(dbgstr, "[MD9] Error: md_submode: %c\n\r",
+				sprintf(dbgstr, "[MD9] Error: md_submode: %d\n\r",
 					md_submode);
 				PRINTF(dbgstr);
 				quit_mode();
-				break;
+				return;
 		}
-	} while (!(md_res > 0 && md_res < bound));
-	sprintf(dbgstr, "[MD9] Result: %d\n\r", md_res);
-	PRINTF(dbgstr);	
+		if (carries == step.carries) {
+			break;
+		}
+	}
+	sprintf(dbgstr, "[MD9] Step %d: %d, %d = %d\n\r",
+		md_progress[md_submode].step, md_op_1, md_op_2, md_res);
+	PRINTF(dbgstr);
+
+	// Looked up now so that asking, and asking again, starts straight away
+	md_question_size = 0;
+	md_question[md_question_size++] = md_clip_what_is;
+	md_question_size += number_clips(md_op_1, &md_question[md_question_size]);
+	md_question[md_question_size++] = md_clip_operator;
+	md_question_size += number_clips(md_op_2, &md_question[md_question_size]);
+
+	md_judged = false;
 }
 
-void md9_play_question() {
-	play_mp3(MODE_FILESET, MP3_PREQUES);
-	play_number(md_op_1);
+/**
+ * @brief Looks up the prompts of the chosen submode
+ * @return void
+ */
+void md9_set_prompts(void) {
+	set_clip(&md_clip_what_is, MODE_FILESET, MP3_PREQUES);
 	switch (md_submode) {
 		case SUBMODE_ADD:
-			play_mp3(MODE_FILESET, MP3_PLUS);
+			set_clip(&md_clip_operator, MODE_FILESET, MP3_PLUS);
 			break;
 		case SUBMODE_SUB:
-			play_mp3(MODE_FILESET, MP3_MINUS);
+			set_clip(&md_clip_operator, MODE_FILESET, MP3_MINUS);
 			break;
 		case SUBMODE_MUL:
-			play_mp3(MODE_FILESET, MP3_TIMES);
+			set_clip(&md_clip_operator, MODE_FILESET, MP3_TIMES);
+			break;
+		case SUBMODE_DIV:
+			set_clip(&md_clip_operator, MODE_FILESET, MP3_DIVIDED_BY);
 			break;
 		default:
-			sprintf(dbgstr, "[MD9] Error: md_submode: %c\n\r",
-				md_submode);
-			PRINTF(dbgstr);
-			quit_mode();
 			break;
 	}
-	play_number(md_op_2);
+}
+
+/**
+ * @brief Level a step of the ladder belongs to
+ * @param unsigned char step - Step, 0 to MD9_STEPS - 1
+ * @return int - LEVEL_1 to LEVEL_3
+ */
+int md9_step_level(unsigned char step) {
+	int level = LEVEL_COUNT;
+
+	while (level > LEVEL_1 && step < (level - 1) * MD9_STEPS / LEVEL_COUNT) {
+		level--;
+	}
+	return level;
+}
+
+/**
+ * @brief Counts the first answer to a question towards the step of the
+ * 	submode. Each MD9_WINDOW questions, mostly right and quick answers move
+ * 	up a step and mostly wrong ones move down.
+ * @param bool correct - Whether the first answer was right
+ * @param uint32_t answer_ms - Time from the end of the question to the answer
+ * @return void
+ */
+void md9_judge(bool correct, uint32_t answer_ms) {
+	md9_progress_t* progress = &md_progress[md_submode];
+	uint32_t allowed_ms = MD9_FAST_MS
+		+ (uint32_t) MD9_DIGIT_MS * (get_num_of_digits(md_res) - 1);
+
+	md_judged = true;
+	progress->answered++;
+	if (correct) {
+		progress->correct++;
+		if (answer_ms <= allowed_ms) {
+			progress->fast++;
+		}
+	}
+	sprintf(dbgstr, "[MD9] Answer %s in %lu ms\n\r",
+		correct ? "correct" : "wrong", (unsigned long) answer_ms);
+	PRINTF(dbgstr);
+
+	if (progress->answered < MD9_WINDOW) {
+		return;
+	}
+	if (progress->fast >= MD9_PROMOTE && progress->step < MD9_STEPS - 1) {
+		progress->step++;
+	} else if (progress->correct <= MD9_DEMOTE && progress->step > 0) {
+		progress->step--;
+	}
+	sprintf(dbgstr, "[MD9] %d of %d right, %d quick, now step %d\n\r",
+		progress->correct, progress->answered, progress->fast, progress->step);
+	PRINTF(dbgstr);
+	md_level = md9_step_level(progress->step);
+	user_set_level(ui_current_mode_number, md_level);
+	progress->answered = 0;
+	progress->correct = 0;
+	progress->fast = 0;
+}
+
+/**
+ * @brief Starts the chosen submode at the first step of a level and saves
+ * 	the level for the current user
+ * @param int level - LEVEL_1 to LEVEL_3
+ * @return void
+ */
+void md9_start_level(int level) {
+	sprintf(dbgstr, "[MD9] Level: %d\n\r", level);
+	PRINTF(dbgstr);
+	md_level = level;
+	md_progress[md_submode].step = (level - 1) * MD9_STEPS / LEVEL_COUNT;
+	user_set_level(ui_current_mode_number, level);
+	md9_set_prompts();
+	play_mp3(MODE_FILESET, MP3_INSTRUCTIONS);
+	md_next_state = STATE_GENQUES;
+}
+
+/**
+ * @brief Starts the chosen submode at the level the user last reached, or
+ * 	the one set in MODES.DAT; asks for a level if there is neither
+ * @return void
+ */
+void md9_choose_level(void) {
+	unsigned char level = ui_current_mode_level();
+
+	if (level >= LEVEL_1 && level <= LEVEL_COUNT) {
+		md9_start_level(level);
+	} else {
+		md_next_state = STATE_LVLSEL;
+	}
+}
+
+void md9_play_question() {
+	play_clips(md_question, md_question_size);
+	md_timing = false;
 }
 
 void md9_play_answer(void) {
@@ -161,7 +457,7 @@ void md9_main(void) {
 		
 		case STATE_MENU:
 			md_last_dot = create_dialog(MP3_MENU,
-				(DOT_1 | DOT_2 | DOT_3));
+				(DOT_1 | DOT_2 | DOT_3 | DOT_4));
 			switch (md_last_dot) {
 				
 				case NO_DOTS:
@@ -170,19 +466,25 @@ void md9_main(void) {
 				case '1':
 					PRINTF("[MD9] Submode: Addition\n\r");
 					md_submode = SUBMODE_ADD;
-					md_next_state = STATE_LVLSEL;
+					md9_choose_level();
 					break;
 
 				case '2':
 					PRINTF("[MD9] Submode: Subtraction\n\r");
 					md_submode = SUBMODE_SUB;
-					md_next_state = STATE_LVLSEL;
+					md9_choose_level();
 					break;
 
 				case '3':
 					PRINTF("[MD9] Submode: Multiplication\n\r");
 					md_submode = SUBMODE_MUL;
-					md_next_state = STATE_LVLSEL;
+					md9_choose_level();
+					break;
+
+				case '4':
+					PRINTF("[MD9] Submode: Division\n\r");
+					md_submode = SUBMODE_DIV;
+					md9_choose_level();
 					break;
 
 				default:
@@ -203,24 +505,15 @@ void md9_main(void) {
 					break;
 
 				case '1':
-					PRINTF("[MD9] Level: 1\n\r");
-					md_level = LEVEL_1;
-					play_mp3(MODE_FILESET, MP3_INSTRUCTIONS);
-					md_next_state = STATE_GENQUES;
+					md9_start_level(LEVEL_1);
 					break;
 
 				case '2':
-					PRINTF("[MD9] Level: 2\n\r");
-					md_level = LEVEL_2;
-					play_mp3(MODE_FILESET, MP3_INSTRUCTIONS);
-					md_next_state = STATE_GENQUES;
+					md9_start_level(LEVEL_2);
 					break;
 
 				case '3':
-					PRINTF("[MD9] Level: 3\n\r");
-					md_level = LEVEL_3;
-					play_mp3(MODE_FILESET, MP3_INSTRUCTIONS);
-					md_next_state = STATE_GENQUES;
+					md9_start_level(LEVEL_3);
 					break;
 
 				default:
@@ -243,6 +536,11 @@ void md9_main(void) {
 			break;
 
 		case STATE_INPUT:
+			// Time the answer from when the question has been read out
+			if (!md_timing && playlist_empty) {
+				md_asked_at = scheduler_uptime_ms();
+				md_timing = true;
+			}
 			if (io_user_abort == true) {
 				PRINTF("[MD12] User aborted input\n\r");
 				md_next_state = STATE_REPROMPT;
@@ -251,6 +549,8 @@ void md9_main(void) {
 			}
 			if (get_number(&md_input_valid, &md_usr_res)) {
 				if (md_input_valid) {
+					md_answer_ms = md_timing ?
+						scheduler_uptime_ms() - md_asked_at : 0;
 					sprintf(dbgstr, "[MD9] User answer: %d\n\r", md_usr_res);
 					PRINTF(dbgstr);
 					play_mp3(MODE_FILESET, MP3_YOU_ANSWERED);
@@ -263,6 +563,9 @@ void md9_main(void) {
 			break;
 
 		case STATE_CHECKANS:
+			if (!md_judged) {
+				md9_judge(md_usr_res == md_res, md_answer_ms);
+			}
 			if (md_usr_res == md_res) {
 				// Correct answer
 				md_incorrect_tries = 0;
@@ -296,6 +599,9 @@ void md9_main(void) {
 
 					// Skipping question
 					case ENTER:
+						if (!md_judged) {
+							md9_judge(false, 0);
+						}
 						md_next_state = STATE_GENQUES;
 						break;
 
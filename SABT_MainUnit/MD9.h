@@ -7,6 +7,34 @@
 #ifndef _MD9_H_
 #define _MD9_H_
 
+#include <stdbool.h>
+
+// Adaptive difficulty. Each operation climbs its own ladder of MD9_STEPS
+// steps; a step sets the size of the operands and whether the question must
+// carry. After MD9_WINDOW questions, MD9_PROMOTE or more answered right
+// first time and within the time allowed move up a step, and MD9_DEMOTE or
+// fewer right move down one.
+#define MD9_STEPS 10
+#define MD9_WINDOW 5
+#define MD9_PROMOTE 4
+#define MD9_DEMOTE 2
+#define MD9_FAST_MS 6000                // Time allowed for a one digit answer
+#define MD9_DIGIT_MS 3000               // and for each further digit
+#define MD9_GENERATE_TRIES 32
+
+typedef struct md9_step {
+	int max_1;                          // Largest first operand, e.g. 9, 99 or 999
+	int max_2;                          // Largest second operand
+	bool carries;                       // Whether the question must carry
+} md9_step_t;
+
+typedef struct md9_progress {
+	unsigned char step;
+	unsigned char answered;             // Questions so far in the window
+	unsigned char correct;              // Right first time
+	unsigned char fast;                 // Right first time and quick
+} md9_progress_t;
+
 void md9_main(void);
 void md9_reset(void);
 void md9_call_mode_yes_answer(void);
@@ -23,4 +23,26 @@
 #include "MD10.h"// Braille Contractions
 #include "MD11.h"// Everyday Noises Game
 #include "md12.h"// Kannada braille practice
+#include "MD13.h"// SD card games
+#include "MD14.h"// Log in
+#include "MD15.h"// Letter reference
+
+#define MODE_INTRO_SIZE 5
+
+// Describes a mode to UI_Handle.c. Rows live in program memory, so read the
+// fields with pgm_read_*. Every mode needs reset and main; the other handlers
+// are NULL when a mode does not use them.
+typedef struct mode_descriptor {
+  unsigned char id;                 // Mode number used in MODES.DAT
+  char intro[MODE_INTRO_SIZE];      // MP3 played while browsing modes
+  void (*reset)(void);
+  void (*main)(void);
+  void (*yes_answer)(void);
+  void (*no_answer)(void);
+  void (*left)(void);
+  void (*right)(void);
+  void (*input_dot)(char this_dot);
+  void (*input_cell)(char this_cell);
+} mode_descriptor_t;
+
 #endif /* _MODES_H_ */
@@ -15,7 +15,8 @@
  *        its type and sends the appropriate message to PC
  *        The two possibilities are that you sent 'x' - PC_CMD_INIT - this just gets
  *        response from the system. The other message is 'M' - PC_CMD_NEWMODES
- *        this message type will change the mode file
+ *        this message type will change the mode file. 'D' - PC_CMD_DIAGNOSTICS
+ *        reports the state of the serial links
  * @return Void
  */
 void pc_parse_message()
@@ -36,9 +37,13 @@ void pc_parse_message()
     case PC_CMD_NEWMODES:
       pc_requests_to_modify_modes_file();
       break;
+      // Report diagnostics
+    case PC_CMD_DIAGNOSTICS:
+      pc_report_diagnostics();
+      break;
       // Incorrect message type
     default:
-      PRINTF("SABT-INCORRECT MESSAGE TYPE! MUST BE 'M' OR 'x'.\r\n");
+      PRINTF("SABT-INCORRECT MESSAGE TYPE! MUST BE 'M', 'D' OR 'x'.\r\n");
       break;
   }
 }
@@ -81,3 +86,26 @@ void pc_requests_to_modify_modes_file(void)
     TX_NEWLINE_PC;
   }
 }
+
+/**
+ * @brief Sends the number of bytes each USART receive buffer has had to drop
+ *        because the main loop did not drain it in time, and the time spent
+ *        awake and asleep since power on
+ * @return Void
+ */
+void pc_report_diagnostics(void)
+{
+  char diag_str[48];
+  uint32_t active_ms, sleep_ms;
+
+  sprintf(diag_str, "SABT-RX OVERFLOW UI:%u PC:%u",
+      rx_buffer_overflows(&usart_keypad_rx_buffer),
+      rx_buffer_overflows(&usart_pc_rx_buffer));
+  usart_transmit_string_to_pc((unsigned char*)diag_str);
+  TX_NEWLINE_PC;
+
+  scheduler_power_stats(&active_ms, &sleep_ms);
+  sprintf(diag_str, "SABT-ACTIVE MS:%lu SLEEP MS:%lu", active_ms, sleep_ms);
+  usart_transmit_string_to_pc((unsigned char*)diag_str);
+  TX_NEWLINE_PC;
+}
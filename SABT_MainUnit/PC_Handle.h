@@ -14,10 +14,12 @@
 
 #define PC_CMD_INIT         'x'    //'x' for Init command
 #define PC_CMD_NEWMODES     'M'    //'M' followed  by new modes string
+#define PC_CMD_DIAGNOSTICS  'D'    //'D' reports link and power diagnostics
 
 //Dealing with the user data
 //uint16_t PC_calculate_CRC(unsigned char* pstrMsg);
 void pc_requests_to_modify_modes_file(void);
+void pc_report_diagnostics(void);
 void pc_parse_message(void);
 void pc_control_key_pressed(void);
 
@@ -37,6 +37,120 @@ void timer_routine(void)
   }
 }
 
+/**
+ * @brief Input task - decode bytes from the UI board and act on complete
+ *        packets
+ *        [U][I][msglen][msg_number][msg_type][payload][CRC1][CRC2]
+ *        msg_type:
+ *         A: contains braille dot at this location in the UI
+ *         B: contains braille character at this location in the UI
+ *         C: payload contains an error message
+ *         D: payload contains a control button input from UI
+ *         E: miscellaneous
+ * @return Void
+ */
+static void input_task(void)
+{
+  if(usart_keypad_data_ready)
+  {
+    usart_keypad_receive_action();
+  }
+
+  if(usart_ui_message_ready) //If a message ready from the user interface, process it
+  {
+    ui_parse_message(playing_sound);
+    scheduler_post(EVENT_MODE);
+  }
+
+  // More bytes were left behind the packet just handled
+  if(usart_keypad_data_ready)
+  {
+    scheduler_post(EVENT_KEYPAD_RX);
+  }
+}
+
+/**
+ * @brief Audio task - play the next queued MP3 file
+ * @return Void
+ */
+static void audio_task(void)
+{
+  if(playlist_empty == false)
+  {
+    play_next_mp3();
+  }
+
+  if(playlist_empty == false)
+  {
+    scheduler_post(EVENT_AUDIO);
+  }
+  else
+  {
+    // Let the mode move on now that its prompts have finished
+    scheduler_post(EVENT_MODE);
+  }
+
+  // play_mp3_file() hands back packets it does not handle itself
+  if(usart_ui_message_ready)
+  {
+    scheduler_post(EVENT_KEYPAD_RX);
+  }
+}
+
+/**
+ * @brief Mode task - run the main function of the current mode. Modes are
+ *        polled state machines, so keep running the mode until it stops to
+ *        wait for user input.
+ * @return Void
+ */
+static void mode_task(void)
+{
+  io_waiting_for_input = false;
+
+  ui_run_main_of_current_mode();
+
+  if(ui_is_mode_selected && !io_waiting_for_input)
+  {
+    scheduler_post(EVENT_MODE);
+  }
+}
+
+/**
+ * @brief Logging task - PC link and timer housekeeping
+ * @return Void
+ */
+static void logging_task(void)
+{
+  if(usart_pc_data_ready)
+  {
+    usart_pc_receive_action();
+  }
+
+  if(usart_pc_message_ready) //If a message ready from the PC, process it
+  {
+    pc_parse_message();
+  }
+
+  if(usart_pc_data_ready)
+  {
+    scheduler_post(EVENT_PC_RX);
+  }
+
+  if(timer_interrupt)
+  {
+    timer_interrupt = false;
+    //  timer_routine();
+  }
+}
+
+// Main loop tasks in priority order, highest first
+static const task_t main_tasks[] = {
+  { EVENT_KEYPAD_RX,           input_task   },
+  { EVENT_AUDIO,               audio_task   },
+  { EVENT_MODE,                mode_task    },
+  { EVENT_PC_RX | EVENT_TIMER, logging_task },
+};
+
 /**
  * @brief the main routine
  * @return Void
@@ -45,54 +159,7 @@ int main(void)
 {
   initialize_system();
 
-  while(1)
-  {
-    // read in the dict file till done
-    // check to see if we've received data from UI board
-    // if true, process the single byte
-    if(usart_keypad_data_ready)
-    {
-      /* one of two types:
-       * [U][I][msglen][msg_number][msg_type][payload][CRC1][CRC2]
-       * [M][C][msglen][msg_number][msg_type][payload][CRC1][CRC2]
-       * msg_type:
-       *  A: contains braille dot at this location in the UI
-       *  B: contains braille character at this location in the UI
-       *  C: payload contains an error message
-       *  D: payload contains a control button input from UI
-       *  E: miscellaneous */
-      usart_keypad_receive_action();
-    }
-
-    // check to see if we've received data from a connected PC 
-    // if true, process the single byte
-    if(usart_pc_data_ready)
-    {
-      usart_pc_receive_action();
-    }
-
-    if(timer_interrupt)
-    {
-      timer_interrupt = false;
-      //  timer_routine();
-    }
-
-    if(usart_pc_message_ready) //If a message ready from the PC, process it
-    {
-      pc_parse_message();
-    }
-
-    if(usart_ui_message_ready) //If a message ready from the user interface, process it
-    {
-      ui_parse_message(playing_sound);
-    }
-
-    ui_run_main_of_current_mode();
-
-    if (playlist_empty == false) {
-      play_next_mp3();
-    }
-  }
+  scheduler_run(main_tasks, sizeof(main_tasks) / sizeof(main_tasks[0]));
   return 1;
 }
 
@@ -108,6 +175,7 @@ int main(void)
 ISR(TIMER1_COMPA_vect)
 {
   timer_interrupt = true;
+  scheduler_timer_tick();
 }
 
 
@@ -121,8 +189,9 @@ ISR(TIMER1_COMPA_vect)
  */
 ISR(USART1_RX_vect)
 {
-  usart_keypad_received_data = UDR1;
+  rx_buffer_put(&usart_keypad_rx_buffer, UDR1);
   usart_keypad_data_ready = true;
+  scheduler_post(EVENT_KEYPAD_RX);
 };
 
 /**
@@ -136,9 +205,26 @@ ISR(USART1_RX_vect)
 ISR(USART0_RX_vect)
 {
   // Temporarily disabled the PC communications since we are simulating the UI with PC
-  usart_pc_received_data = UDR0;
+  unsigned char data = UDR0;
+
+  rx_buffer_put(&usart_pc_rx_buffer, data);
   usart_pc_data_ready = true;
-  usart_transmit_byte_to_pc(usart_pc_received_data);
+  scheduler_post(EVENT_PC_RX);
+  usart_transmit_byte_to_pc(data);
+};
+
+/**
+ * @brief ISR is an interrupt handler that will be called when its argument
+ *        corresponds to the interupt called. Fires when the VS1053 raises
+ *        DREQ; there is nothing to do beyond waking play_mp3_file() from
+ *        sleep.
+ * @param Interrupt vector.  Compared to interupt that is fired to see if correct
+ *        function to call
+ * @ref   http://www.nongnu.org/avr-libc/
+ * @return  Void
+ */
+ISR(PCINT1_vect)
+{
 };
 
 /**
@@ -147,6 +233,9 @@ ISR(USART0_RX_vect)
  */
 void initialize_system(void)
 {
+  uint8_t volume;
+
+  scheduler_init();             // Nothing pending before interrupts start
   timer_interrupt = false;      // Clear the timer interrupt flag
   playing_sound = false;
   message_count = 0;
@@ -176,6 +265,10 @@ void initialize_system(void)
   spi_initialize();
   PRINTF("OK\n\r");
 
+  // Wake from sleep when the MP3 decoder asks for more data
+  PCMSK1 |= _BV(MP3_DREQ);  // PORTB pins are PCINT8-15
+  PCICR |= _BV(PCIE1);
+
   PRINTF("Interrupt flag...");
   sei();  // sets the interrupt flag (enables interrupts)
   PRINTF("OK\n\r");
@@ -183,11 +276,23 @@ void initialize_system(void)
   init_sd_card(true);
   PRINTF("SD card...OK\n\r");
 
+  // After the SD card, whose start-up time varies
+  random_seed();
+
+  // Saved volume, before anything is played
+  settings_init();
+  if(settings_get(SETTINGS_VOLUME, &volume, sizeof(volume)))
+  {
+    vs1053_set_vol(volume);
+  }
+
   play_mp3_file((unsigned char*)"SYS_WELC.mp3");
 
   ui_check_modes();
   PRINTF("Parsing modes...OK\n\r");
 
+  user_login(USER_GUEST);
+
   PRINTF("Reading dictionary file...");
   init_read_dict((unsigned char *)"wordsEn.txt");
   while(!done_rd_dict){
@@ -17,142 +17,448 @@
 
 #include <string.h>
 
-#define MAX_MODE_FILE_LENGTH 128
 #define MAX_MODE_NUMBER_DIGITS 2
+#define UI_MODES_FILE "MODES.DAT"
+#define UI_MODES_MAX_TOKEN 16
 
 static unsigned char incorrect_tries = 0;
 
+// One row per mode; adding a mode only needs a row here and its number in
+// MODES.DAT
+static const mode_descriptor_t ui_mode_table[] PROGMEM = {
+  { 1, "MD1", md1_reset, md1_main, md1_call_mode_yes_answer,
+    md1_call_mode_no_answer, NULL, NULL, md1_input_dot, md1_input_cell },
+  { 2, "MD2", md2_reset, md2_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 3, "MD3", md3_reset, md3_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 4, "MD4", md4_reset, md4_main, md4_call_mode_yes_answer,
+    md4_call_mode_no_answer, NULL, NULL, md4_input_dot, md4_input_cell },
+  { 5, "MD5", md5_reset, md5_main, md5_call_mode_yes_answer,
+    md5_call_mode_no_answer, NULL, NULL, md5_input_dot, md5_input_cell },
+  { 6, "MD6", md6_reset, md6_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 7, "MD7", md7_reset, md7_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 8, "MD8", md8_reset, md8_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 9, "MD9", md9_reset, md9_main, md9_call_mode_yes_answer,
+    md9_call_mode_no_answer, md9_call_mode_left, md9_call_mode_right,
+    md9_input_dot, md9_input_cell },
+  { 10, "MD10", md10_reset, md10_main, md10_call_mode_yes_answer,
+    md10_call_mode_no_answer, md10_call_mode_left, md10_call_mode_right,
+    md10_input_dot, md10_input_cell },
+  { 11, "MD11", md11_reset, md11_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 12, "MD12", md12_reset, md12_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 13, "MD13", md13_reset, md13_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 14, "MD14", md14_reset, md14_main, NULL, NULL, NULL, NULL, NULL, NULL },
+  { 15, "MD15", md15_reset, md15_main, md15_call_mode_yes_answer, NULL,
+    md15_call_mode_left, md15_call_mode_right, NULL, NULL },
+};
+
+#define UI_NUMBER_OF_MODE_ROWS \
+  (sizeof(ui_mode_table) / sizeof(ui_mode_table[0]))
+
+// Row of the mode being browsed or run, NULL before one is picked
+static const mode_descriptor_t* ui_current_mode = NULL;
+
+// Handlers of the current mode, read from the table in program memory
+#define UI_MODE_HANDLER(field) \
+  ((void (*)(void)) pgm_read_word(&ui_current_mode->field))
+#define UI_MODE_INPUT_HANDLER(field) \
+  ((void (*)(char)) pgm_read_word(&ui_current_mode->field))
+
 /**
- * @brief  reads modes from MODES.DAT file and tells computer how many modes and 
- *         what they are
- * @return bool  - return true on succesful completion of transmission, false on 
- *         failure
+ * @brief  finds the table row of a mode
+ * @param  mode_number - unsigned short, mode number from MODES.DAT
+ * @return const mode_descriptor_t* - row in program memory, NULL if there is
+ *         no such mode
  */
-void ui_check_modes(void)
+static const mode_descriptor_t* ui_find_mode(unsigned short mode_number)
 {
-  /*
-   * The modes.dat contains the numbers of modes that 
-   * need to be activated in this device. It contains the 
-   * mode numbers of the required modes as follows:
-   *    MODENO#MODENO#$ ETC. (Last character is $)
-   * For example if we need modes 2, 5 and 14 to be activated:
-   * <2><5><14>$
-   */
-  char file_content[MAX_MODE_FILE_LENGTH];
-  int i = 0;
-  //const char* modes_file = "MODES.DAT";
-  char mode_number[MAX_MODE_NUMBER_DIGITS + 1] = "";
-  short mode_number_index = 0;
-  int parsed_mode_number = 0;
-  char debug[64] = "";
+  unsigned char i;
 
-  //Global variable being initialised
-  number_of_modes = 0;
+  for(i = 0; i < UI_NUMBER_OF_MODE_ROWS; i++)
+  {
+    if(pgm_read_byte(&ui_mode_table[i].id) == mode_number)
+    {
+      return &ui_mode_table[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  makes the mode at a position in ui_modes the current mode
+ * @param  index - int, position in ui_modes
+ * @return Void
+ */
+static void ui_select_mode_index(int index)
+{
+  ui_current_mode_index = index;
+  ui_current_mode_number = ui_modes[index];
+  ui_current_mode = ui_find_mode(ui_modes[index]);
+}
+
+// Modes offered when MODES.DAT is missing or lists no usable mode
+static const unsigned char ui_default_modes[] PROGMEM = {
+  1, 2, 7, 12, 6, 3, 11, 4, 5, 8, 9, 10
+};
 
-  // Clear file content array  
-  for(i = 0; i < MAX_MODE_FILE_LENGTH; i++)
-    file_content[i] = 0;
+// Options for each entry of ui_modes
+static mode_options_t ui_mode_options[MAX_NUMBER_OF_MODES];
+static const mode_options_t ui_no_options = { "", UI_LEVEL_DEFAULT, "" };
 
-  /* Populate file contents;
-  if(read_and_retrieve_file_contents((unsigned char*)modes_file, &file_content[0]) > 0)
+// MODES.DAT parser state
+static unsigned int ui_modes_line;
+static int ui_modes_entry;          // Entry that options apply to, -1 if none
+static unsigned char ui_modes_errors;
+
+/**
+ * @brief  reports a problem in MODES.DAT over the PC link
+ * @param  message - const char*, what is wrong
+ * @param  token - const char*, text it was found in
+ * @return Void
+ */
+static void ui_modes_error(const char* message, const char* token)
+{
+  ui_modes_errors++;
+  snprintf(dbgstr, sizeof(dbgstr), "[Modes] Line %u: %s '%s'\n\r",
+      ui_modes_line, message, token);
+  PRINTF(dbgstr);
+}
+
+/**
+ * @brief  adds a mode to the end of the menu
+ * @param  mode_number - unsigned short, mode number
+ * @return bool - false if the menu is full
+ */
+static bool ui_modes_append(unsigned short mode_number)
+{
+  if(number_of_modes >= MAX_NUMBER_OF_MODES)
   {
-    PRINTF("Mode file could not be read\n\r");
-    while (1) { }
-  }*/
-
-  strcpy(file_content, "1,2,7,12,6,3,11,4,5,8,9,10,;");
-  // Print file contents to debug stream
-  PRINTF("Mode file contents\n\r");
-  PRINTF(file_content);
-  NEWLINE;
+    return false;
+  }
+  ui_modes[number_of_modes] = mode_number;
+  ui_mode_options[number_of_modes] = ui_no_options;
+  number_of_modes++;
+  return true;
+}
 
-  for (i = 0;
-      (i < MAX_MODE_FILE_LENGTH) && (file_content[i] != ';') &&
-        (number_of_modes < MAX_NUMBER_OF_MODES);
-      i++) {
-
-    switch (file_content[i]) {
-      case ',':
-        //Add NULL terminator to mode number string to be parsed
-        mode_number[mode_number_index] = 0;
-        mode_number_index = 0;
-
-        parsed_mode_number = atoi(mode_number);
-        if (parsed_mode_number == 0) {
-          //If "mode number" could not be parsed or is 0, discard it
-          break;
-        }
+/**
+ * @brief  handles a mode number in MODES.DAT; following options apply to it
+ * @param  token - const char*, digits of the mode number
+ * @return Void
+ */
+static void ui_modes_number(const char* token)
+{
+  int mode_number = atoi(token);
+  int i;
 
-        //Update global mode array
-        ui_modes[number_of_modes] = parsed_mode_number;
-        number_of_modes++;
-        break;
-      
-      case '1': case '2': case '3': case '4': case '5': case '6': case '7':
-      case '8': case '9': case '0':
-        mode_number[mode_number_index] = file_content[i];
-        mode_number_index++;
-        if (mode_number_index > MAX_MODE_NUMBER_DIGITS) {
-          //Mode numbers cannot be longer than a certain number of digits
-          break;
+  ui_modes_entry = -1;
+  if(strspn(token, "0123456789") != strlen(token) ||
+      strlen(token) > MAX_MODE_NUMBER_DIGITS || ui_find_mode(mode_number) == NULL)
+  {
+    ui_modes_error("unknown mode", token);
+    return;
+  }
+  for(i = 0; i < number_of_modes; i++)
+  {
+    if(ui_modes[i] == mode_number)
+    {
+      ui_modes_error("mode listed twice", token);
+      return;
+    }
+  }
+  if(!ui_modes_append(mode_number))
+  {
+    ui_modes_error("too many modes", token);
+    return;
+  }
+  ui_modes_entry = number_of_modes - 1;
+}
+
+/**
+ * @brief  handles an option "name=value" for the last mode number
+ * @param  token - char*, option text, split in place
+ * @return Void
+ */
+static void ui_modes_option(char* token)
+{
+  char* value = strchr(token, '=');
+  mode_options_t* options;
+  int level;
+
+  if(ui_modes_entry < 0)
+  {
+    ui_modes_error("option without a mode", token);
+    return;
+  }
+  options = &ui_mode_options[ui_modes_entry];
+  *value++ = '\0';
+
+  if(strcmp(token, "lang") == 0)
+  {
+    if(strlen(value) != UI_LANGUAGE_SIZE - 1 || find_language_script(value) == NULL)
+    {
+      ui_modes_error("unknown language", value);
+      return;
+    }
+    strcpy(options->language, value);
+  }
+  else if(strcmp(token, "level") == 0)
+  {
+    level = atoi(value);
+    if(strlen(value) != 1 || level < 1 || level > UI_LEVEL_MAX)
+    {
+      ui_modes_error("bad level", value);
+      return;
+    }
+    options->level = level;
+  }
+  else if(strcmp(token, "words") == 0)
+  {
+    if(strlen(value) == 0 || strlen(value) >= UI_WORDS_SIZE)
+    {
+      ui_modes_error("bad word list", value);
+      return;
+    }
+    strcpy(options->words, value);
+  }
+  else
+  {
+    ui_modes_error("unknown option", token);
+  }
+}
+
+/**
+ * @brief  handles one word of MODES.DAT
+ * @param  token - char*, the word
+ * @return Void
+ */
+static void ui_modes_token(char* token)
+{
+  if(token[0] >= '0' && token[0] <= '9')
+  {
+    ui_modes_number(token);
+  }
+  else if(strchr(token, '=') != NULL)
+  {
+    ui_modes_option(token);
+  }
+  else
+  {
+    ui_modes_error("unexpected", token);
+  }
+}
+
+/**
+ * @brief  reads MODES.DAT straight from the card, one character at a time.
+ *
+ *         Each entry is a mode number followed by options, e.g.
+ *           6 lang=HIN
+ *           9 level=2
+ *           3 words=FRUITS
+ *         Entries end at a comma, a line break or '>', so the older
+ *         "1,2,3;" and "<1><2><3>$" files still work. '#' starts a comment
+ *         that runs to the end of the line, and ';' or '$' ends the file.
+ *         Mistakes are reported over the PC link and the entry is skipped.
+ * @return bool - false if the file is not on the card
+ */
+static bool ui_read_modes_file(void)
+{
+  unsigned char file_name[FILE_NAME_LEN];
+  struct file_stream stream;
+  char token[UI_MODES_MAX_TOKEN + 1];
+  unsigned char length = 0;
+  bool too_long = false;
+  bool comment = false;
+  int c;
+
+  strcpy((char*) file_name, UI_MODES_FILE);
+  if(!open_file_stream(&stream, file_name))
+  {
+    PRINTF("[Modes] MODES.DAT not found\n\r");
+    return false;
+  }
+
+  ui_modes_line = 1;
+  ui_modes_entry = -1;
+  while(1)
+  {
+    c = read_file_stream(&stream);
+    if(comment && c >= 0 && c != '\n')
+    {
+      continue;
+    }
+
+    switch(c)
+    {
+      case ' ': case '\t': case '\r': case '\n': case ',': case '<': case '>':
+      case '#': case ';': case '$': case -1:
+        if(length > 0)
+        {
+          token[length] = '\0';
+          if(too_long)
+          {
+            ui_modes_error("entry too long", token);
+          }
+          else
+          {
+            ui_modes_token(token);
+          }
+          length = 0;
+          too_long = false;
         }
         break;
 
       default:
-        PRINTF("Invalid character in mode file: ");
-        SENDBYTE(file_content[i]);
-        NEWLINE;
-        break;
+        if(length < UI_MODES_MAX_TOKEN)
+        {
+          token[length++] = c;
+        }
+        else
+        {
+          too_long = true;
+        }
+        continue;
+    }
+
+    if(c == -1 || c == ';' || c == '$')
+    {
+      return true;
+    }
+    if(c == '\n' || c == ',' || c == '>')
+    {
+      ui_modes_entry = -1;
+    }
+    if(c == '\n')
+    {
+      ui_modes_line++;
+      comment = false;
+    }
+    if(c == '#')
+    {
+      comment = true;
     }
   }
+}
 
-  // Print the number of modes found to a string
-  sprintf(debug, "%d modes deteceted\n\r", number_of_modes);
-  PRINTF(debug);
+/**
+ * @brief  reads the modes to offer from MODES.DAT, falling back to the
+ *         built in list if the file is missing or has no usable mode, and
+ *         sends the result to the PC
+ * @return Void
+ */
+void ui_check_modes(void)
+{
+  unsigned char i;
+
+  //Global variable being initialised
+  number_of_modes = 0;
+  ui_modes_errors = 0;
+
+  if(!ui_read_modes_file() || number_of_modes == 0)
+  {
+    PRINTF("[Modes] Using the built in mode list\n\r");
+    number_of_modes = 0;
+    for(i = 0; i < sizeof(ui_default_modes); i++)
+    {
+      ui_modes_append(pgm_read_byte(&ui_default_modes[i]));
+    }
+  }
+
+  sprintf(dbgstr, "%d modes detected, %d errors\n\r", number_of_modes,
+      ui_modes_errors);
+  PRINTF(dbgstr);
 
   //Send the actual modes to debug stream
   PRINTF("Modes enabled: ");
   for(i = 0; i < number_of_modes; i++)
   {
-    sprintf(debug, "%d, ", ui_modes[i]);
-    PRINTF(debug);
+    sprintf(dbgstr, "%d %s %d %s, ", ui_modes[i], ui_mode_options[i].language,
+        ui_mode_options[i].level, ui_mode_options[i].words);
+    PRINTF(dbgstr);
   }
   NEWLINE;
 
   ui_is_mode_selected = false;
   ui_current_mode_index = -1;
   ui_current_mode_number = -1;
+  ui_current_mode = NULL;
+}
+
+/**
+ * @brief  options given in MODES.DAT for the current mode
+ * @return const mode_options_t* - options, all unset if there is no current
+ *         mode
+ */
+const mode_options_t* ui_current_mode_options(void)
+{
+  if(ui_current_mode_index < 0 || ui_current_mode_index >= number_of_modes)
+  {
+    return &ui_no_options;
+  }
+  return &ui_mode_options[ui_current_mode_index];
 }
 
 /**
- * @brief calculate CRC (cyclic redundancy check)
+ * @brief  level to start the current mode at: the level the current user
+ *         last reached in it, or else the level given in MODES.DAT. Modes
+ *         save the level with user_set_level when it changes.
+ * @return unsigned char - 1 to UI_LEVEL_MAX, UI_LEVEL_DEFAULT if neither is
+ *         set
+ */
+unsigned char ui_current_mode_level(void)
+{
+  unsigned char level = user_level(ui_current_mode_number);
+
+  if(level == UI_LEVEL_DEFAULT || level > UI_LEVEL_MAX)
+  {
+    level = ui_current_mode_options()->level;
+  }
+  return level;
+}
+
+// CRC-16/CCITT (polynomial 0x1021) remainders for each value of a nibble
+static const uint16_t ui_crc_table[16] PROGMEM = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/**
+ * @brief add one byte to a running CRC-16/CCITT, four bits at a time
+ * @param crc - uint16_t, CRC so far (UI_CRC_INIT for the first byte)
+ * @param data - unsigned char, next byte of the message
+ * @return updated CRC value
+ */
+uint16_t ui_crc_update(uint16_t crc, unsigned char data)
+{
+  crc = (crc << 4) ^ pgm_read_word(&ui_crc_table[(crc >> 12) ^ (data >> 4)]);
+  crc = (crc << 4) ^ pgm_read_word(&ui_crc_table[(crc >> 12) ^ (data & 0x0F)]);
+  return crc;
+}
+
+/**
+ * @brief calculate CRC (cyclic redundancy check) of a whole packet
+ *        Covers [msglen][msg_number][msgtype][payload], i.e. everything
+ *        except the header and the two checksum bytes
  * @param message message (?)
  * @return CRC value
  */
 uint16_t ui_calculate_crc(unsigned char* message)
 {
-  unsigned char msglen = *(message + 2) - 5; // Not including the checksum bytes
-  uint16_t chksum = 0;
+  unsigned char msglen = *(message + 2) - 4; // Not including header or checksum
+  uint16_t chksum = UI_CRC_INIT;
 
-  message += 3;
-  while(msglen > 1)
+  message += 2;
+  while(msglen-- > 0)
   {
-    chksum += (*(message) << 8) | *(message + 1);
-    chksum = chksum & 0xffff;
-    msglen -= 2;
-    message += 2;
-  }
-  if(msglen > 0) //If the packet size is odd numbered
-  {
-    chksum = chksum ^ (int)*(message++);
+    chksum = ui_crc_update(chksum, *(message++));
   }
   return chksum;
 }
 
 /**
  * @brief  Reads a message in USART_UI_ReceivedPacket. Then determines what type of
- *         message it has received. It then interacts with the mode accordingly and
- *         sends a message of recieval at the end. 
+ *         message it has received. It then interacts with the mode accordingly.
+ *         usart_keypad_receive_action() has already checked the CRC, sent the
+ *         acknowledgement and dropped duplicates.
  *
  * UI string: [U][I][msglen][msg_number][msgtype][payload][CRC1][CRC2]
  * msgtypes: 
@@ -161,74 +467,58 @@ uint16_t ui_calculate_crc(unsigned char* message)
  */
 bool ui_parse_message(bool mp3_is_playing)
 {
-  //First things first, check the CRC
-  unsigned char message_len = usart_ui_received_packet[2];
   unsigned char message_type;
   unsigned char adc_message[10];
-  uint16_t chksum = ui_calculate_crc((unsigned char*)&usart_ui_received_packet);
 
+  // The checksum was verified and the packet acknowledged as it arrived
+  message_type = usart_ui_received_packet[4];
+  random_stir();
 
-  // Check the checksum
-  if (chksum == (usart_ui_received_packet[message_len - 2] << 8 
-        | usart_ui_received_packet[message_len - 1]))
+  // Process the message
+  if(mp3_is_playing) //If a MP3 file is being played, only the commands are processed
   {
-    // If correct, store the message elements
-    message_type = usart_ui_received_packet[4];
-
-    // Process the message
-    if(mp3_is_playing) //If a MP3 file is being played, only the commands are processed
+    if(message_type == 'D')               // Control key pressed
     {
-      if(message_type == 'D')               // Control key pressed
-      {
-        ui_control_key_pressed();
-        usart_ui_message_ready = false;      // Once control handled, exit
-        return true;
-      }
+      ui_control_key_pressed();
+      usart_ui_message_ready = false;      // Once control handled, exit
+      return true;
     }
+  }
 
-    // Handle each type of message separately
-    switch(message_type)
-    {
-      case 'A':                             // Single braille dot
-        io_dot = usart_ui_received_packet[5];
-        ui_input_dot_to_current_mode(usart_ui_received_packet[5]);
-        break;
-      case 'B':  
-        ui_input_cell_to_current_mode(usart_ui_received_packet[5]);
-        break;
-      case 'C':                             // Error message
-        PRINTF("[ui_parse_message] An error occurred in the UI.");
-        break;
-      case 'D':                             // Control button
-        //PRINTF("CONTROL BUTTON PRESSED");
-        ui_control_key_pressed();
-        break;
-      case 'E':                             // Acknowledgement
-        // TODO what does this section do? 'E' marked misceaneous in doc
-        adc_message[0] = usart_ui_received_packet[5];
-        adc_message[1] = usart_ui_received_packet[6];
-        adc_message[2] = usart_ui_received_packet[7];
-        usart_transmit_string_to_pc_from_flash(PSTR("Analog Input channel,MSB,LSB :"));
-        sprintf((char*)adc_message,
-            "%d,%d,%d",
-            usart_ui_received_packet[5],
-            usart_ui_received_packet[6],
-            usart_ui_received_packet[7]);
-        usart_transmit_string_to_pc((unsigned char*)&adc_message);
-        TX_NEWLINE_PC;
-        TX_NEWLINE_PC;
-        break;
-      default:
-        break;
-    }
-    // In the end: send acknowledgement to the sender 
-    // (with the message number, of course !!!)
-  } 
-  else // Checksum not valid
+  // Handle each type of message separately
+  switch(message_type)
   {
-    PRINTF("[IO] CRC failed\n\r");
-    usart_ui_message_ready = false;
-    return false;
+    case 'A':                             // Single braille dot
+      io_dot = usart_ui_received_packet[5];
+      ui_input_dot_to_current_mode(usart_ui_received_packet[5]);
+      break;
+    case 'B':  
+      ui_input_cell_to_current_mode(usart_ui_received_packet[5]);
+      break;
+    case 'C':                             // Error message
+      PRINTF("[ui_parse_message] An error occurred in the UI.");
+      break;
+    case 'D':                             // Control button
+      //PRINTF("CONTROL BUTTON PRESSED");
+      ui_control_key_pressed();
+      break;
+    case 'E':                             // Acknowledgement
+      // TODO what does this section do? 'E' marked misceaneous in doc
+      adc_message[0] = usart_ui_received_packet[5];
+      adc_message[1] = usart_ui_received_packet[6];
+      adc_message[2] = usart_ui_received_packet[7];
+      usart_transmit_string_to_pc_from_flash(PSTR("Analog Input channel,MSB,LSB :"));
+      sprintf((char*)adc_message,
+          "%d,%d,%d",
+          usart_ui_received_packet[5],
+          usart_ui_received_packet[6],
+          usart_ui_received_packet[7]);
+      usart_transmit_string_to_pc((unsigned char*)&adc_message);
+      TX_NEWLINE_PC;
+      TX_NEWLINE_PC;
+      break;
+    default:
+      break;
   }
 
   usart_ui_message_ready = false;
@@ -255,6 +545,7 @@ void ui_control_key_pressed(void)
         if(ui_current_mode_index >= 0)
         {
           ui_is_mode_selected = true;
+          settings_commit();
           io_init();
           ui_reset_the_current_mode();
         }
@@ -300,8 +591,7 @@ void ui_control_key_pressed(void)
       if(!ui_is_mode_selected)
       {
         //ui_current_mode_index = (ui_current_mode_index + 1) % number_of_modes;
-        ui_current_mode_index = ui_current_mode_index + 1 > number_of_modes - 1 ? 0 : ui_current_mode_index + 1;
-        ui_current_mode_number = ui_modes[ui_current_mode_index];
+        ui_select_mode_index(ui_current_mode_index + 1 > number_of_modes - 1 ? 0 : ui_current_mode_index + 1);
         vs1053_skip_play = true;
         ui_play_intro_current_mode();
       } else {
@@ -313,8 +603,7 @@ void ui_control_key_pressed(void)
       io_dot = LEFT;
       if(!ui_is_mode_selected)
       {
-        ui_current_mode_index = ui_current_mode_index - 1 < 0 ? number_of_modes - 1 : ui_current_mode_index - 1;
-        ui_current_mode_number = ui_modes[ui_current_mode_index];
+        ui_select_mode_index(ui_current_mode_index - 1 < 0 ? number_of_modes - 1 : ui_current_mode_index - 1);
         vs1053_skip_play = true;
         ui_play_intro_current_mode();
       } else {
@@ -326,11 +615,13 @@ void ui_control_key_pressed(void)
       //only increase sound if you are not playing a sound
       PRINTF("[UI] Volume up\n\r");
       vs1053_increase_vol();
+      user_volume_changed();
       break;
     case UI_CMD_VOLD: // Volume down
       //only increase sound if you are not playing a sound
       PRINTF("[UI] Volume down\n\r");
       vs1053_decrease_vol();
+      user_volume_changed();
       break;
     default:
       break;
@@ -343,8 +634,13 @@ void ui_control_key_pressed(void)
  */
 void ui_play_intro_current_mode(void)
 {
-  char filename[5];
-  sprintf(filename, "MD%d", ui_current_mode_number);
+  char filename[MODE_INTRO_SIZE];
+
+  if(ui_current_mode == NULL)
+  {
+    return;
+  }
+  strncpy_P(filename, ui_current_mode->intro, MODE_INTRO_SIZE);
   play_mp3("",filename);
 }
 
@@ -354,28 +650,16 @@ void ui_play_intro_current_mode(void)
  */
 void ui_call_mode_yes_answer(void)
 {
-  switch(ui_current_mode_number)
-  {
-    case 1:
-      md1_call_mode_yes_answer();
-      break;
-    case 4:
-      md4_call_mode_yes_answer();
-      break;
-    case 5:
-      md5_call_mode_yes_answer();
-      break;
-    case 9:
-      md9_call_mode_yes_answer();
-      break;
+  void (*yes_answer)(void);
 
-	case 10:
-	  md10_call_mode_yes_answer();
-	  break;
-
-
-    default:
-      break;
+  if(ui_current_mode == NULL)
+  {
+    return;
+  }
+  yes_answer = UI_MODE_HANDLER(yes_answer);
+  if(yes_answer != NULL)
+  {
+    yes_answer();
   }
 }
 
@@ -385,25 +669,16 @@ void ui_call_mode_yes_answer(void)
  */
 void ui_call_mode_no_answer(void)
 {
-  switch(ui_current_mode_number)
+  void (*no_answer)(void);
+
+  if(ui_current_mode == NULL)
   {
-    case 1:
-      md1_call_mode_no_answer();
-      break;
-    case 4:
-      md4_call_mode_no_answer();
-      break;
-    case 5:
-      md5_call_mode_no_answer();
-      break;
-    case 9:
-      md9_call_mode_no_answer();
-      break;
-    case 10:
-	  md10_call_mode_no_answer();
-	  break;
-    default:
-      break;
+    return;
+  }
+  no_answer = UI_MODE_HANDLER(no_answer);
+  if(no_answer != NULL)
+  {
+    no_answer();
   }
 }
 
@@ -413,29 +688,13 @@ void ui_call_mode_no_answer(void)
  */
 void ui_input_dot_to_current_mode(char this_dot)
 {
-  if (ui_is_mode_selected) {
-      switch(ui_current_mode_number)
-      {
-        case 1:
-          md1_input_dot(this_dot);
-          break;
-        case 4:
-          md4_input_dot(this_dot);
-          break;
-        case 5:
-          md5_input_dot(this_dot);
-          break;
-        case 9:
-          md9_input_dot(this_dot);
-          break;
-
-        case 10:
-		  md10_input_dot(this_dot);
-		  break;
-
-        default:
-          break;
-      }
+  void (*input_dot)(char);
+
+  if (ui_is_mode_selected && ui_current_mode != NULL) {
+    input_dot = UI_MODE_INPUT_HANDLER(input_dot);
+    if (input_dot != NULL) {
+      input_dot(this_dot);
+    }
   } else {
     play_mp3("ENG_",MP3_INVALID_PATTERN);
     incorrect_tries++;
@@ -452,26 +711,12 @@ void ui_input_dot_to_current_mode(char this_dot)
  */
 void ui_input_cell_to_current_mode(char this_cell)
 {
-  if (ui_is_mode_selected) {
-    switch(ui_current_mode_number)
-    {
-      case 1:
-        md1_input_cell(this_cell);
-        break;
-      case 4:
-        md4_input_cell(this_cell);
-        break;
-      case 5:
-        md5_input_cell(this_cell);
-        break;
-      case 9:
-        md9_input_cell(this_cell);
-        break;
-	  case 10:
-        md10_input_cell(this_cell);
-        break;
-      default:
-        break;
+  void (*input_cell)(char);
+
+  if (ui_is_mode_selected && ui_current_mode != NULL) {
+    input_cell = UI_MODE_INPUT_HANDLER(input_cell);
+    if (input_cell != NULL) {
+      input_cell(this_cell);
     }
   } else {
     play_mp3("SYS_",MP3_INVALID_PATTERN);
@@ -484,54 +729,13 @@ void ui_input_cell_to_current_mode(char this_cell)
 }
 
 /**
- * @brief   Decides which of the three UI modes to go into based on ui_current_mode_number
+ * @brief   Runs the main function of the current mode
  * @return  Void
  */
 void ui_run_main_of_current_mode(void)
 {
-  if(ui_is_mode_selected){
-    switch(ui_current_mode_number)
-    {
-      case 1:
-        md1_main();
-        break;
-      case 2:
-        md2_main();
-        break;
-      case 3:
-        md3_main();
-        break;
-      case 4:
-        md4_main();
-        break;
-      case 5:
-        md5_main();
-        break;
-      case 6:
-        md6_main();
-        break;
-      case 7:
-        md7_main();
-        break;
-      case 8:
-        md8_main();
-        break;
-      case 9:
-        md9_main();
-        break;
-      case 10:
-	  	  md10_main();
-		  break;
-	  case 11:
-	  	  md11_main();
-		    break;
-      case 12:
-        md12_main();
-        break;
-
-      default:
-        break;
-    }
+  if(ui_is_mode_selected && ui_current_mode != NULL){
+    UI_MODE_HANDLER(main)();
   }
 }
 
@@ -541,49 +745,8 @@ void ui_run_main_of_current_mode(void)
  */
 void ui_reset_the_current_mode(void)
 {
-  if(ui_is_mode_selected){
-    switch(ui_current_mode_number)
-    {
-      case 1:
-        md1_reset();
-        break;
-      case 2:
-        md2_reset();
-        break;
-      case 3:
-        md3_reset();
-        break;
-      case 4:
-        md4_reset();
-        break;
-      case 5:
-        md5_reset();
-        break;
-      case 6:
-        md6_reset();
-        break;
-      case 7:
-        md7_reset();
-        break;
-      case 8:
-        md8_reset();
-        break;
-      case 9:
-        md9_reset();
-        break;
-	  case 10:
-	    md10_reset();  
-        break;
-	  case 11:
-	    md11_reset();  
-        break;
-
-      case 12:
-        md12_reset();
-
-      default:
-        break;
-    }
+  if(ui_is_mode_selected && ui_current_mode != NULL){
+    UI_MODE_HANDLER(reset)();
   }
 }
 
@@ -594,16 +757,14 @@ void ui_reset_the_current_mode(void)
  * @return void
  */
 void ui_call_mode_left(void) {
-  switch (ui_current_mode_number) {
-    case 9:
-      md9_call_mode_left();
-      break;
-	case 10:
-	  md10_call_mode_left();
-	  break;
+  void (*left)(void);
 
-    default:
-      break;
+  if (ui_current_mode == NULL) {
+    return;
+  }
+  left = UI_MODE_HANDLER(left);
+  if (left != NULL) {
+    left();
   }
 }
 
@@ -613,15 +774,13 @@ void ui_call_mode_left(void) {
  * @return void
  */
 void ui_call_mode_right(void) {
-  switch (ui_current_mode_number) {
-    case 9:
-      md9_call_mode_right();
-      break;    
-	case 10:
-	  md10_call_mode_right();
-	  break;  
+  void (*right)(void);
 
-    default:
-      break;
+  if (ui_current_mode == NULL) {
+    return;
+  }
+  right = UI_MODE_HANDLER(right);
+  if (right != NULL) {
+    right();
   }
 }
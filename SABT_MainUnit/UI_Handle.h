@@ -21,12 +21,29 @@
 #define UI_CMD_VOLU 5
 #define UI_CMD_VOLD 6
 
+#define UI_CRC_INIT 0xFFFF
+
+// Per-mode options from MODES.DAT
+#define UI_LANGUAGE_SIZE 4
+#define UI_LEVEL_DEFAULT 0
+#define UI_LEVEL_MAX 3
+#define UI_WORDS_SIZE 9
+
+typedef struct mode_options {
+  char language[UI_LANGUAGE_SIZE];  // Language code such as "HIN", "" if not set
+  unsigned char level;              // 1 to UI_LEVEL_MAX, UI_LEVEL_DEFAULT if not set
+  char words[UI_WORDS_SIZE];        // Word list such as "FRUITS", "" if not set
+} mode_options_t;
+
 bool ui_is_mode_selected;
 char ui_current_mode_number;
 int ui_current_mode_index;
 
 //Dealing with the user data
 void ui_check_modes(void);
+const mode_options_t* ui_current_mode_options(void);
+unsigned char ui_current_mode_level(void);
+uint16_t ui_crc_update(uint16_t crc, unsigned char data);
 uint16_t ui_calculate_crc(unsigned char* message);
 bool ui_parse_message(bool mp3_is_playing);
 void ui_control_key_pressed(void);
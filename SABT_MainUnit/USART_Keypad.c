@@ -13,6 +13,16 @@ unsigned char usart_ui_prefix[3];
 unsigned char usart_ui_receive_msgcnt;
 unsigned char usart_ui_received_payload_len;
 
+// CRC of the packet being received, updated as each byte arrives
+uint16_t usart_ui_running_crc;
+
+// Message number of the last packet handed to ui_parse_message(), -1 before
+// the first. The UI board numbers its first packet after a reset 0 and never
+// uses 0 again, so a UI board reset cannot be mistaken for a duplicate.
+int usart_ui_last_msg_number;
+
+rx_buffer_t usart_keypad_rx_buffer;
+
 
 /**
  * @brief Initializes the baud communication over USART.
@@ -29,27 +39,58 @@ void init_usart_keypad(void)
   usart_ui_length_received = false;
   usart_ui_header_received = false;
   usart_ui_message_ready = false;
+  usart_ui_last_msg_number = -1;
+  rx_buffer_init(&usart_keypad_rx_buffer);
 }
 
 
 /**
- * @brief   Receives message stored in globabl usart_keypad_received_data
- *          Then proceeds to decode message, use its value, and allow for more 
- *          messages to be sent. usart_ui_prefix - mini shift register which shifts
- *          from 2 -> 1 -> 0
- *          Transfers data from USART_Keypad_Reiceved_Data->usart_ui_received_packet
- * @ref  tech_report.pdf
+ * @brief   Checks a complete packet in usart_ui_received_packet, replies to the
+ *          UI board and flags the packet for ui_parse_message() unless it is a
+ *          retransmission of a packet that was already accepted. The CRC was
+ *          accumulated byte by byte, so only the final compare is left.
  * @return Void
  */
-void usart_keypad_receive_action(void)
+static void usart_keypad_accept_packet(void)
 {
+  unsigned char msg_len = usart_ui_received_packet[2];
+  unsigned char msg_number = usart_ui_received_packet[3];
+  uint16_t msg_crc = usart_ui_received_packet[msg_len - 2] << 8 |
+    usart_ui_received_packet[msg_len - 1];
 
-  usart_keypad_data_ready = false;
+  if(usart_ui_running_crc != msg_crc)
+  {
+    PRINTF("[IO] CRC failed\n\r");
+    usart_keypad_send_reply(msg_number, UI_MSG_NAK);
+    return;
+  }
+
+  // Acknowledge duplicates too - our previous ACK may have been lost
+  usart_keypad_send_reply(msg_number, UI_MSG_ACK);
+
+  if(msg_number == usart_ui_last_msg_number)
+  {
+    return;
+  }
 
+  usart_ui_last_msg_number = msg_number;
+  usart_ui_message_ready = true;
+}
+
+/**
+ * @brief   Decodes one byte received from the UI board and adds it to
+ *          usart_ui_received_packet. usart_ui_prefix - mini shift register
+ *          which shifts from 2 -> 1 -> 0
+ * @param data - unsigned char, byte taken from usart_keypad_rx_buffer
+ * @ref  tech_report.pdf
+ * @return Void
+ */
+static void usart_keypad_process_byte(unsigned char data)
+{
   // If no header has been found, build it
   if(!usart_ui_header_received)
   {
-    usart_ui_prefix[2] = usart_keypad_received_data;
+    usart_ui_prefix[2] = data;
     usart_ui_prefix[0] = usart_ui_prefix[1];
     usart_ui_prefix[1] = usart_ui_prefix[2];
 
@@ -65,10 +106,12 @@ void usart_keypad_receive_action(void)
   // Get the length of the payload
   else if(!usart_ui_length_received)
   {
-    if(usart_ui_receive_msgcnt == 2)
+    if(usart_ui_receive_msgcnt == 2 && data >= UI_MIN_PACKET_LENGTH &&
+        data <= UI_MAX_PACKET_LENGTH)
     {
-      usart_ui_received_payload_len = usart_keypad_received_data;
-      usart_ui_received_packet[2] = usart_keypad_received_data;
+      usart_ui_received_payload_len = data;
+      usart_ui_running_crc = ui_crc_update(UI_CRC_INIT, data);
+      usart_ui_received_packet[2] = data;
       usart_ui_length_received = true;
       usart_ui_receive_msgcnt++;
     }
@@ -80,7 +123,12 @@ void usart_keypad_receive_action(void)
   // Build the actual message
   else
   {
-    usart_ui_received_packet[usart_ui_receive_msgcnt++] = usart_keypad_received_data;
+    // Everything up to the two checksum bytes is covered by the CRC
+    if(usart_ui_receive_msgcnt < usart_ui_received_payload_len - 2)
+    {
+      usart_ui_running_crc = ui_crc_update(usart_ui_running_crc, data);
+    }
+    usart_ui_received_packet[usart_ui_receive_msgcnt++] = data;
 
     if (usart_ui_receive_msgcnt >= 19) {
       usart_ui_message_ready = false;
@@ -91,13 +139,67 @@ void usart_keypad_receive_action(void)
     // Full message has been received
     if(usart_ui_receive_msgcnt == usart_ui_received_payload_len) 
     {
-      usart_ui_message_ready = true;
       usart_ui_header_received = false;
       usart_ui_length_received = false;
+      usart_keypad_accept_packet();
     }
   }
 }
 
+/**
+ * @brief   Drains the bytes stored in usart_keypad_rx_buffer by the RX
+ *          interrupt, decoding each one. Stops early once a full packet is
+ *          ready so it is not overwritten before ui_parse_message() sees it;
+ *          the remaining bytes are picked up on the next call.
+ * @ref  tech_report.pdf
+ * @return Void
+ */
+void usart_keypad_receive_action(void)
+{
+  unsigned char data;
+
+  usart_keypad_data_ready = false;
+
+  while(!usart_ui_message_ready &&
+      rx_buffer_get(&usart_keypad_rx_buffer, &data))
+  {
+    usart_keypad_process_byte(data);
+  }
+
+  // Leave the flag up if bytes are still waiting behind a complete packet
+  if(!rx_buffer_empty(&usart_keypad_rx_buffer))
+  {
+    usart_keypad_data_ready = true;
+  }
+}
+
+/**
+ * @brief Sends an ACK or NAK for a packet back to the UI board
+ * @param msg_number - unsigned char, message number of the packet
+ * @param reply - unsigned char, UI_MSG_ACK or UI_MSG_NAK
+ * @return Void
+ */
+void usart_keypad_send_reply(unsigned char msg_number, unsigned char reply)
+{
+  unsigned char reply_packet[UI_REPLY_LENGTH];
+  uint16_t chksum;
+  int i;
+
+  reply_packet[0] = 'M';
+  reply_packet[1] = 'C';
+  reply_packet[2] = UI_REPLY_LENGTH;
+  reply_packet[3] = msg_number;
+  reply_packet[4] = reply;
+  chksum = ui_calculate_crc(reply_packet);
+  reply_packet[5] = (unsigned char)(chksum >> 8);
+  reply_packet[6] = (unsigned char)(chksum & 0xFF);
+
+  for(i = 0; i < UI_REPLY_LENGTH; i++)
+  {
+    usart_transmit_byte_to_keypad(reply_packet[i]);
+  }
+}
+
 /**
  * @brief Transmits byte data from MC --> UI over UDR1
  * @param data - unsigned char, byte to transmit to UI
@@ -10,23 +10,37 @@
 #define _USART_KEYPAD_H_
 
 #include <stdbool.h> 
+#include "rx_buffer.h"
 
 #define CHAR 0
 #define INT  1
 #define LONG 2
 
+// Replies sent back to the UI board for every packet received
+// [M][C][msglen][msg_number][UI_MSG_ACK/UI_MSG_NAK][CRC1][CRC2]
+#define UI_MSG_ACK            'K'
+#define UI_MSG_NAK            'N'
+#define UI_REPLY_LENGTH       7
+
+// Bounds on the length byte of a packet from the UI board
+#define UI_MIN_PACKET_LENGTH  7
+#define UI_MAX_PACKET_LENGTH  18
+
 #define TX_NEWLINE_KP { usart_transmit_byte_to_keypad(0x0d); \
                         usart_transmit_byte_to_keypad(0x0a);}
 
-volatile char usart_keypad_received_data;
 volatile char usart_keypad_data_to_transmit;
 volatile bool usart_keypad_data_ready;
 volatile bool usart_ui_message_ready;
 
 volatile unsigned char usart_ui_received_packet[20];
 
+// Bytes received by the USART1 RX interrupt, waiting to be parsed
+extern rx_buffer_t usart_keypad_rx_buffer;
+
 void init_usart_keypad(void);
 void usart_keypad_receive_action(void);
+void usart_keypad_send_reply(unsigned char msg_number, unsigned char reply);
 void usart_transmit_byte_to_keypad(unsigned char);
 void usart_transmit_string_to_keypad(unsigned char*);
 void usart_transmit_string_to_keypad_from_flash(char*);
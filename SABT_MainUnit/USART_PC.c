@@ -13,6 +13,8 @@ int usart_received_payload_len;
 unsigned char usart_pc_prefix[3];
 unsigned char usart_pc_receive_msgcnt;
 
+rx_buffer_t usart_pc_rx_buffer;
+
 /**
  * @brief Initializes the buad communication over USART.
  * @return Void
@@ -25,23 +27,22 @@ void init_usart_pc(void)
   UBRR0L = 0x19;
   UBRR0H = 0x00; //set baud rate to 19,200 with 8MHz clock
   UCSR0B = 0x98; //RXCIE1=1, RXEN1=1, TXEN1=1
+  rx_buffer_init(&usart_pc_rx_buffer);
 }
 
 /**
- * @brief   Receives message stored in global usart_pc_received_data
- *          Then proceeds to decode message, use its value, and allow for more
- *          message to be processed by PC_parse_message()
+ * @brief   Decodes one byte received from the PC and adds it to
+ *          usart_pc_received_packet
+ * @param data - unsigned char, byte taken from usart_pc_rx_buffer
  * @ref  tech_report.pdf
- * @return always 0?
+ * @return Void
  */
-unsigned char usart_pc_receive_action(void)
+static void usart_pc_process_byte(unsigned char data)
 {
-  usart_pc_data_ready = false;
-
   message_count++;
 
   // Received an entire line; process it
-  if(usart_pc_received_data == CARR_RETURN)
+  if(data == CARR_RETURN)
   {
     message_count = 0;
     if(!valid_message)
@@ -54,7 +55,7 @@ unsigned char usart_pc_receive_action(void)
   // if header not yet received, build it
   if(!usart_pc_header_received)
   {
-    usart_pc_prefix[2] = usart_pc_received_data;
+    usart_pc_prefix[2] = data;
     usart_pc_prefix[0] = usart_pc_prefix[1];
     usart_pc_prefix[1] = usart_pc_prefix[2];
 
@@ -74,13 +75,37 @@ unsigned char usart_pc_receive_action(void)
   else
   {
     // If carraige return found --> end of the command
-    if(usart_pc_received_data == CARR_RETURN)
+    if(data == CARR_RETURN)
     {
       usart_received_payload_len = usart_pc_receive_msgcnt;
       usart_pc_message_ready = true;
       usart_pc_header_received = false;
     }
-    usart_pc_received_packet[usart_pc_receive_msgcnt++] = usart_pc_received_data;
+    usart_pc_received_packet[usart_pc_receive_msgcnt++] = data;
+  }
+}
+
+/**
+ * @brief   Drains the bytes stored in usart_pc_rx_buffer by the RX interrupt,
+ *          decoding each one. Stops early once a full message is ready so it
+ *          can be processed by pc_parse_message() before more bytes arrive.
+ * @ref  tech_report.pdf
+ * @return always 0?
+ */
+unsigned char usart_pc_receive_action(void)
+{
+  unsigned char data;
+
+  usart_pc_data_ready = false;
+
+  while(!usart_pc_message_ready && rx_buffer_get(&usart_pc_rx_buffer, &data))
+  {
+    usart_pc_process_byte(data);
+  }
+
+  if(!rx_buffer_empty(&usart_pc_rx_buffer))
+  {
+    usart_pc_data_ready = true;
   }
 
   return 0;
@@ -10,6 +10,7 @@
 #define _USART_PC_H_
 
 #include <stdbool.h> 
+#include "rx_buffer.h"
 
 #define CHAR        0
 #define INT         1
@@ -19,7 +20,6 @@
 #define TX_NEWLINE_PC { usart_transmit_byte_to_pc(0x0d); \
                         usart_transmit_byte_to_pc(0x0a);}
 
-volatile char usart_pc_received_data;
 volatile char usart_pc_data_to_transmit;
 volatile bool usart_pc_data_ready;
 volatile bool usart_pc_message_ready;
@@ -31,6 +31,9 @@ bool valid_message;
 
 volatile unsigned char usart_pc_received_packet[20];
 
+// Bytes received by the USART0 RX interrupt, waiting to be parsed
+extern rx_buffer_t usart_pc_rx_buffer;
+
 void init_usart_pc(void);
 unsigned char usart_pc_receive_action(void);
 void usart_transmit_byte_to_pc(unsigned char);
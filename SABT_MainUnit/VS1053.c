@@ -179,6 +179,41 @@ bool vs1053_decrease_vol(void)
   return true;
 }
 
+/**
+ * @brief Current volume setting
+ * @return uint8_t - volume of each channel, VOL_INCR (loudest) to VOL_MIN
+ */
+uint8_t vs1053_get_vol(void)
+{
+  return mono_volume;
+}
+
+/**
+ * @brief Sets the volume without playing the volume sound, e.g. to restore a
+ *        saved setting
+ * @param volume - uint8_t, volume from vs1053_get_vol(); clamped to the range
+ *        the volume buttons allow
+ * @return bool - did the volume change properly
+ */
+bool vs1053_set_vol(uint8_t volume)
+{
+  int retry = 0;
+
+  if(volume < VOL_INCR)
+    volume = VOL_INCR;
+  if(volume > VOL_MIN)
+    volume = VOL_MIN;
+
+  mono_volume = volume;
+  stereo_volume = CHANGE_VOLUME(mono_volume);
+  while(vs1053_read_command(0x0B) != stereo_volume)   // REDO if not written properly
+  {
+    vs1053_write_command(0x0B, stereo_volume);        // Set the requested volume
+    if(retry++ > 10) return false;
+  }
+  return true;
+}
+
 /**
  * @brief ?
  * @param data - unsigned char, transmits data on SPI interface
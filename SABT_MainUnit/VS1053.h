@@ -20,6 +20,8 @@ unsigned char vs1053_initialize(void);                // Init decoder chip
 void vs1053_software_reset(void);                     // Software reset routine
 bool vs1053_increase_vol(void);
 bool vs1053_decrease_vol(void);
+uint8_t vs1053_get_vol(void);
+bool vs1053_set_vol(uint8_t volume);
 
 //controls sound level
 
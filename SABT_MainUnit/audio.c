@@ -7,9 +7,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "VS1053.h"
 #include "glyph.h"
+#include "audio.h"
 #include "Globals.h"
 #include "common.h"
 #include "io.h"
@@ -22,22 +24,37 @@
 /* System files fileset on SD card */
 #define SYSTEM_FILESET "SYS_"
 
-/** Number name parsers, macro refers to number it's position away from decimal
-	point */
-#define PLACE_ONES 0x01
-#define PLACE_TENS 0x02
-#define PLACE_HUNDREDS 0x03
-#define PLACE_THOUSANDS 0x04
-#define PLACE_TEN_THOUSANDS 0x05
-// ints on this platform are 2 bytes long - largest signed int is 32,768
+/** Number clips, by their position in number_locations: #0 to #19 first,
+	then the tens from #20 to #90 and the words */
+#define NUMBER_TENS 20
+#define NUMBER_HUNDRED 28
+#define NUMBER_THOUSAND 29
+#define NUMBER_NEGATIVE 30
+#define NUMBER_CLIP_COUNT 31
+#define NUMBER_MAX 9999
 
 bool playlist_empty = true;
 
 /** Playlist supports queuing some files at a time with filenames of up to 13
 	characters */
-static char playlist[MAX_FILENAME_SIZE][MAX_PLAYLIST_SIZE];
+static char playlist[MAX_PLAYLIST_SIZE][MAX_FILENAME_SIZE];
 static short playlist_size = 0;
 static short playlist_index = 0;
+/** Where each queued file is, first_cluster 0 if it has to be looked up by
+	name when it is played */
+static struct file_location playlist_location[MAX_PLAYLIST_SIZE];
+
+/** Dot clips, by their position in dot_locations: DOT1 to DOT6, then DOTE
+	and DOTC */
+#define DOT_ENTER 6
+#define DOT_CANCEL 7
+#define DOT_CLIP_COUNT 8
+
+/** Number and dot clips are looked up once per language and kept, as most
+	prompts are made of several of them */
+static struct file_location number_locations[NUMBER_CLIP_COUNT];
+static struct file_location dot_locations[DOT_CLIP_COUNT];
+static char* cached_fileset = NULL;
 
 /** Set via set_mode_globals() in each mode so that audio library
 	does not have to be constantly passed filesets */
@@ -77,8 +94,10 @@ bool play_mp3(char* fileset, char* mp3) {
 		sprintf(playlist[playlist_size - 1], "%s%s.mp3", fileset, mp3);
  	else
  		sprintf(playlist[playlist_size - 1], "%s.mp3", mp3);
+	playlist_location[playlist_size - 1].first_cluster = 0;
 
 	playlist_empty = false;
+	scheduler_post(EVENT_AUDIO);
 	return true;
 }
 
@@ -120,6 +139,43 @@ void clear_playlist(void) {
 	playlist_index = 0;
 }
 
+/**
+ * @brief Stops the MP3 file being played, if any, and drops the rest of the
+ *	playlist, so that a new prompt starts straight away
+ * @param void
+ * @return void
+ */
+void stop_playlist(void) {
+	clear_playlist();
+	vs1053_software_reset();
+}
+
+/**
+ * @brief Sets up a clip of the language fileset, looking it up on the card
+ *	only the first time it is used with the current language
+ * @param clip_t* clip - Clip to set up
+ * @param struct file_location* cached - Where the clip's location is kept
+ * @param char* mp3 - Pointer to MP3 filename (4 characters)
+ * @return void
+ */
+static void cached_clip(clip_t* clip, struct file_location* cached,
+	char* mp3) {
+	if (cached_fileset != lang_fileset) {
+		memset(number_locations, 0, sizeof(number_locations));
+		memset(dot_locations, 0, sizeof(dot_locations));
+		cached_fileset = lang_fileset;
+	}
+
+	if (cached->first_cluster == 0) {
+		set_clip(clip, lang_fileset, mp3);
+		*cached = clip->location;
+	} else {
+		clip->fileset = lang_fileset;
+		strcpy(clip->mp3, mp3);
+		clip->location = *cached;
+	}
+}
+
 /**
  * @brief Plays next queued MP3 file. Only called when queue is not empty.
  *		is called repeatedly till queue is empty
@@ -138,7 +194,11 @@ void play_next_mp3(void) {
 	PRINTF(playlist[playlist_index]);
 	NEWLINE;
 	
-	play_mp3_file((unsigned char*)playlist[playlist_index]);
+	if (playlist_location[playlist_index].first_cluster != 0) {
+		play_mp3_location(&playlist_location[playlist_index]);
+	} else {
+		play_mp3_file((unsigned char*)playlist[playlist_index]);
+	}
 
 	playlist_index++;
 
@@ -156,42 +216,48 @@ void play_next_mp3(void) {
  */
 void play_dot(char dot) {
 	char mp3[5];
+	clip_t clip;
+	unsigned char index;
 	switch (dot) {
-		case '1': case '2': case '3': case '4': case '5': case '6': break;
-		case ENTER: dot = 'E'; break;
-		case CANCEL: dot = 'C'; break;
+		case '1': case '2': case '3': case '4': case '5': case '6':
+			index = dot - '1';
+			break;
+		case ENTER: dot = 'E'; index = DOT_ENTER; break;
+		case CANCEL: dot = 'C'; index = DOT_CANCEL; break;
 		case LEFT: case RIGHT: case NO_DOTS: return;
 		default:
 			sprintf(dbgstr, "[Audio] Invalid dot: %c\n\r", dot);
 			PRINTF(dbgstr);
-			break;
+			sprintf(mp3, "DOT%c", dot);
+			play_mp3(lang_fileset, mp3);
+			return;
 	}
 	sprintf(mp3, "DOT%c", dot);
-	play_mp3(lang_fileset, mp3);
+	cached_clip(&clip, &dot_locations[index], mp3);
+	play_clips(&clip, 1);
 }
 
 /**
  * @brief Play sound file corresponding to an glyph, checks for NULL arg
- * @param glyph_t* this_glyph - Pointer to glyph to play
+ * @param const glyph_t* this_glyph - Pointer to glyph to play
  * @return void
  */
-void play_glyph(glyph_t *this_glyph) {
-	char mp3[5];
+void play_glyph(const glyph_t *this_glyph) {
+	char mp3[GLYPH_SOUND_SIZE];
 	if (this_glyph != NULL) {
-		sprintf(mp3, this_glyph->sound);
-		play_mp3(lang_fileset, mp3);
+		glyph_sound(this_glyph, mp3);
+		play_mp3(glyph_sound_fileset(mp3, lang_fileset), mp3);
 	}
 }
 
 /**
  * @brief Play sound file corresponding to an word, checks for NULL arg
- * @param word_node_t* this_word - Pointer to word to play
+ * @param const word_t* this_word - Pointer to word to play
  * @return void
  */
-void play_word(word_node_t *this_word) {
-	while(this_word != NULL) {
-		play_glyph(this_word->data);
-		this_word = this_word->next;
+void play_word(const word_t *this_word) {
+	for (int i = 0; i < this_word->length; i++) {
+		play_glyph(this_word->glyphs[i]);
 	}
 }
 
@@ -216,20 +282,23 @@ void play_pattern(unsigned char pattern) {
 
 /**
  * @brief Play dot sequence corresponding to an glyph, checks for NULL arg
- * @param glyph_t *this_glyph - glyph to play dot sequence for
+ * @param const glyph_t *this_glyph - glyph to play dot sequence for
  * @return void
  */
-void play_dot_sequence(glyph_t *this_glyph) {
+void play_dot_sequence(const glyph_t *this_glyph) {
 	char pattern; 
+	const glyph_t* next_glyph;
+	char sound[GLYPH_SOUND_SIZE];
 	if (this_glyph != NULL) {
-		pattern = this_glyph->pattern;
+		pattern = glyph_pattern(this_glyph);
 		play_pattern(pattern);
-		if (this_glyph->next != NULL) {
+		next_glyph = glyph_next(this_glyph);
+		if (next_glyph != NULL) {
 			// Plays all the next glyphs in the linked list
-			sprintf(dbgstr, "[Audio] Playing next pattern: %s\n\r",
-				this_glyph->next->sound);
+			glyph_sound(next_glyph, sound);
+			sprintf(dbgstr, "[Audio] Playing next pattern: %s\n\r", sound);
 			play_mp3(lang_fileset, MP3_NEXT_CELL);
-			play_dot_sequence(this_glyph->next);
+			play_dot_sequence(next_glyph);
 			play_silence(250);
 		}
 	} else {
@@ -237,71 +306,128 @@ void play_dot_sequence(glyph_t *this_glyph) {
 	}
 }
 
-/**	
-	@brief Plays number
-	@param int number - Number to be played. Must be under between -9,999 and
-	9,999
-	@return void
-*/
-void play_number(int number) {
-	
-	int curr_digit = -1;
-	int digits = -1;
-	char mp3[5] = "";
+/**
+ * @brief Sets up a clip and looks up where its file is on the card
+ * @param clip_t* clip - Clip to set up
+ * @param char* fileset - (optional) Pointer to fileset
+ * @param char* mp3 - Pointer to MP3 filename (up to CLIP_NAME_SIZE - 1 characters)
+ * @return bool - False if the file is missing; the clip can still be played
+ *	and is then looked up by name
+ */
+bool set_clip(clip_t* clip, char* fileset, char* mp3) {
+	unsigned char file_name[FILE_NAME_LEN];
 
+	clip->fileset = fileset;
+	strncpy(clip->mp3, mp3, CLIP_NAME_SIZE - 1);
+	clip->mp3[CLIP_NAME_SIZE - 1] = '\0';
 
-	// If number is just 0, play #0 and return
-	if (number == 0) {
-		play_mp3(lang_fileset, "#0");
-		return;
+	if (fileset != NULL)
+		sprintf((char*)file_name, "%s%s.mp3", fileset, clip->mp3);
+	else
+		sprintf((char*)file_name, "%s.mp3", clip->mp3);
+	return find_file_location(file_name, &clip->location);
+}
+
+/**
+ * @brief Queues clips set up with set_clip() or number_clips()
+ * @param const clip_t* clips - Clips to play, in order
+ * @param unsigned char count - Number of clips
+ * @return bool - False if the playlist filled up
+ */
+bool play_clips(const clip_t* clips, unsigned char count) {
+	for (unsigned char i = 0; i < count; i++) {
+		if (!play_mp3(clips[i].fileset, (char*)clips[i].mp3)) {
+			return false;
+		}
+		playlist_location[playlist_size - 1] = clips[i].location;
+	}
+	return true;
+}
+
+/**
+ * @brief Sets up the clip of a number word
+ * @param clip_t* clip - Clip to set up
+ * @param unsigned char index - Position of the clip in number_locations
+ * @return void
+ */
+static void number_clip(clip_t* clip, unsigned char index) {
+	char mp3[CLIP_NAME_SIZE];
+
+	if (index < NUMBER_TENS) {
+		sprintf(mp3, "#%d", index);
+	} else if (index < NUMBER_HUNDRED) {
+		sprintf(mp3, "#%d0", index - NUMBER_TENS + 2);
+	} else if (index == NUMBER_HUNDRED) {
+		strcpy(mp3, "#HUN");
+	} else if (index == NUMBER_THOUSAND) {
+		strcpy(mp3, "#THO");
+	} else {
+		strcpy(mp3, "#NEG");
+	}
+	cached_clip(clip, &number_locations[index], mp3);
+}
+
+/**
+ * @brief Sets up the clips that say a number, with their files already
+ *	found, so that they can be queued with play_clips()
+ * @param int number - Number, between -9,999 and 9,999
+ * @param clip_t* clips - Set to the clips, NUMBER_MAX_CLIPS of room
+ * @return unsigned char - Number of clips, 0 if the number is out of range
+ */
+unsigned char number_clips(int number, clip_t* clips) {
+	unsigned char indices[NUMBER_MAX_CLIPS];
+	unsigned char count = 0;
+
+	if (number < -NUMBER_MAX || number > NUMBER_MAX) {
+		PRINTF("[Audio] Error: Number greater than 4 digits\n\r");
+		return 0;
 	}
 
 	if (number < 0) {
 		// Say "Negative" and take absolute value
-		play_mp3(lang_fileset, "#NEG");
+		indices[count++] = NUMBER_NEGATIVE;
 		number = 0 - number;
 	}
+	if (number >= 1000) {
+		indices[count++] = number / 1000;
+		indices[count++] = NUMBER_THOUSAND;
+		number %= 1000;
+	}
+	if (number >= 100) {
+		indices[count++] = number / 100;
+		indices[count++] = NUMBER_HUNDRED;
+		number %= 100;
+	}
+	// Teens have clips of their own
+	if (number >= 20) {
+		indices[count++] = NUMBER_TENS + number / 10 - 2;
+		number %= 10;
+	}
+	if (number != 0 || count == 0) {
+		indices[count++] = number;
+	}
 
-	// Count number of digits
-	digits = get_num_of_digits(number);
-
-	while (number != 0) {
-		// Extract current digit and adjust number
-		curr_digit = number / ten_to_the(digits - 1);
-
-		if (curr_digit != 0) {
-			sprintf(mp3, "#%d", curr_digit);
-			switch (digits) {
-				case PLACE_ONES:
-					play_mp3(lang_fileset, mp3);
-					break;
-
-				case PLACE_TENS:
-					if (curr_digit == 1) {
-						// If teen, play teen and return immediately
-						sprintf(mp3, "#%d", number);
-						play_mp3(lang_fileset, mp3);
-						return;
-					} else {
-						// Is a multiple of ten
-						sprintf(mp3, "#%d0", curr_digit);
-						play_mp3(lang_fileset, mp3);
-					}
-					break;
-
-				case PLACE_HUNDREDS:
-					play_mp3(lang_fileset, mp3);
-					play_mp3(lang_fileset, "#HUN");
-					break;
-
-				default:
-					PRINTF("[Audio] Error: Number greater than 3 digits\n\r");
-					quit_mode();
-			}
-		}
-		number -= curr_digit * ten_to_the(digits - 1);	
-		digits--;
+	for (unsigned char i = 0; i < count; i++) {
+		number_clip(&clips[i], indices[i]);
+	}
+	return count;
+}
+
+/**	
+	@brief Plays number
+	@param int number - Number to be played. Must be under between -9,999 and
+	9,999
+	@return void
+*/
+void play_number(int number) {
+	clip_t clips[NUMBER_MAX_CLIPS];
+	unsigned char count = number_clips(number, clips);
+
+	if (count == 0) {
+		quit_mode();
+		return;
 	}
+	play_clips(clips, count);
 }
 
 /**
@@ -309,8 +435,8 @@ void play_number(int number) {
 * @param glyph_t* - Pointer to line
 * @return void
 */
-void play_line(glyph_t** line) {
-	glyph_t* curr_glyph = NULL;
+void play_line(const glyph_t** line) {
+	const glyph_t* curr_glyph = NULL;
 	for (int i = 0; i < MAX_BUF_SIZE; i++) {
 		curr_glyph = line[i];
 		if (curr_glyph) {
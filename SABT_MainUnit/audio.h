@@ -10,6 +10,19 @@
 #include <stdbool.h>
 
 #include "glyph.h"
+#include "FAT32.h"
+
+#define CLIP_NAME_SIZE GLYPH_SOUND_SIZE
+// Most clips in a number: "#NEG #9 #THO #9 #HUN #90 #9"
+#define NUMBER_MAX_CLIPS 7
+
+/** An MP3 file found on the card when it is set up, so that it is queued with
+	its location and starts playing without a search of the root directory */
+typedef struct clip {
+	char* fileset;
+	char mp3[CLIP_NAME_SIZE];
+	struct file_location location;
+} clip_t;
 
 extern bool playlist_empty;
 extern char* lang_fileset;
@@ -18,13 +31,17 @@ extern char* mode_fileset;
 bool play_mp3(char* fileset, char* mp3);
 void play_next_mp3(void);
 void clear_playlist(void);
+void stop_playlist(void);
 void play_dot(char dot);
-void play_pattern(char pattern);
-void play_glyph(glyph_t *this_glyph);
-void play_dot_sequence(glyph_t *this_glyph);
+void play_pattern(unsigned char pattern);
+void play_glyph(const glyph_t *this_glyph);
+void play_dot_sequence(const glyph_t *this_glyph);
 void play_silence(int milliseconds);
 void play_number(int number);
-void play_line(glyph_t** line);
-void play_word(word_node_t *this_word);
+bool set_clip(clip_t* clip, char* fileset, char* mp3);
+bool play_clips(const clip_t* clips, unsigned char count);
+unsigned char number_clips(int number, clip_t* clips);
+void play_line(const glyph_t** line);
+void play_word(const word_t *this_word);
 
 #endif /* _AUDIO_H_ */
@@ -0,0 +1,501 @@
+/**
+ * @file backtranslate.c
+ * @brief Braille to text back-translation for English, the reverse of
+ *        translate_text. Each cell updates the number, capital and Grade 1
+ *        indicator state and an uncontracted reading of the word straight
+ *        away. Cells that can only be contractions are noted, and only those
+ *        words are matched against the rule file when the blank cell that ends
+ *        them arrives.
+ */
+
+#include <ctype.h>
+#include <string.h>
+#include "Globals.h"
+#include "glyph.h"
+#include "script_english.h"
+#include "script_digits.h"
+#include "backtranslate.h"
+
+// Capital indicator state
+#define BACKTRANSLATE_CAPS_NONE   0
+#define BACKTRANSLATE_CAPS_LETTER 1
+#define BACKTRANSLATE_CAPS_WORD   2
+
+// Longest rule found starting at each cell of the current word
+typedef struct backtranslate_match {
+  int rule;                         // Rule number in the file + 1, 0 if none
+  unsigned char num_cells;
+  unsigned char text_length;
+  unsigned char offset;             // Where the letters go in the word
+} backtranslate_match_t;
+
+static backtranslate_match_t backtranslate_matches[BACKTRANSLATE_MAX_CELLS];
+
+static char backtranslate_grade;
+
+// Cells of the word being written
+static char backtranslate_cells[BACKTRANSLATE_MAX_CELLS];
+static unsigned char backtranslate_num_cells;
+
+// Uncontracted reading of the word being written
+static char backtranslate_text[TRANSLATE_MAX_WORD + 1];
+static unsigned char backtranslate_length;
+static bool backtranslate_valid;
+
+static bool backtranslate_number_mode;
+static bool backtranslate_numbers;      // Word has a number sign
+static char backtranslate_capitals;
+static bool backtranslate_contracted;   // Word has cells that need the rules
+
+// Last finished word
+static char backtranslate_result[TRANSLATE_MAX_WORD + 1];
+
+/**
+ * @brief Clears the state kept for the word being written
+ * @return Void
+ */
+static void backtranslate_reset_word(void)
+{
+  backtranslate_num_cells = 0;
+  backtranslate_length = 0;
+  backtranslate_text[0] = '\0';
+  backtranslate_valid = true;
+  backtranslate_number_mode = false;
+  backtranslate_numbers = false;
+  backtranslate_capitals = BACKTRANSLATE_CAPS_NONE;
+  backtranslate_contracted = false;
+}
+
+/**
+ * @brief Starts a new line of text
+ * @param grade - char, TRANSLATE_GRADE_1 or TRANSLATE_GRADE_2
+ * @return Void
+ */
+void backtranslate_reset(char grade)
+{
+  backtranslate_grade = grade;
+  backtranslate_result[0] = '\0';
+  backtranslate_reset_word();
+}
+
+/**
+ * @brief Letter written with a cell
+ * @param cell - char, cell pattern
+ * @return char - 'a' to 'z', '\0' if the cell is not a letter
+ */
+static char backtranslate_letter(char cell)
+{
+  const glyph_t* glyph = search_script(&script_english, cell);
+
+  if(glyph == NULL)
+  {
+    return '\0';
+  }
+  return 'a' + (glyph - script_english.glyphs);
+}
+
+/**
+ * @brief Adds a character to the uncontracted reading
+ * @param c - char, character to add
+ * @return Void
+ */
+static void backtranslate_append(char c)
+{
+  if(backtranslate_length >= TRANSLATE_MAX_WORD)
+  {
+    backtranslate_valid = false;
+    return;
+  }
+  backtranslate_text[backtranslate_length++] = c;
+  backtranslate_text[backtranslate_length] = '\0';
+}
+
+/**
+ * @brief Updates the indicator state and the uncontracted reading with one
+ *        cell of the current word
+ * @param cell - char, cell pattern
+ * @return Void
+ */
+static void backtranslate_read_cell(char cell)
+{
+  bool word_start = backtranslate_length == 0;
+  char letter = backtranslate_letter(cell);
+  char mark;
+
+  if(cell == NUMSIGN)
+  {
+    backtranslate_number_mode = true;
+    backtranslate_numbers = true;
+    return;
+  }
+
+  // a-j after a number sign are the digits 1-9 and 0
+  if(backtranslate_number_mode && letter != '\0' && letter <= 'j')
+  {
+    backtranslate_append(letter == 'j' ? '0' : letter - 'a' + '1');
+    return;
+  }
+  backtranslate_number_mode = false;
+
+  if(cell == TRANSLATE_GRADE_1_SIGN)
+  {
+    // Inside a word it starts a contraction such as "ence"
+    if(!word_start)
+    {
+      backtranslate_contracted = true;
+    }
+    return;
+  }
+
+  if(cell == TRANSLATE_CAPITAL_SIGN)
+  {
+    if(!word_start)
+    {
+      backtranslate_contracted = true;
+      backtranslate_capitals = BACKTRANSLATE_CAPS_LETTER;
+    }
+    else if(backtranslate_capitals == BACKTRANSLATE_CAPS_NONE)
+    {
+      backtranslate_capitals = BACKTRANSLATE_CAPS_LETTER;
+    }
+    else
+    {
+      backtranslate_capitals = BACKTRANSLATE_CAPS_WORD;
+    }
+    return;
+  }
+
+  if(letter != '\0')
+  {
+    if(backtranslate_capitals != BACKTRANSLATE_CAPS_NONE)
+    {
+      letter = toupper((unsigned char) letter);
+    }
+    if(backtranslate_capitals == BACKTRANSLATE_CAPS_LETTER)
+    {
+      backtranslate_capitals = BACKTRANSLATE_CAPS_NONE;
+    }
+    backtranslate_append(letter);
+    return;
+  }
+
+  mark = translate_punctuation_char(cell);
+  if(mark != '\0')
+  {
+    // The lower cells are also groupsigns and wordsigns in Grade 2
+    backtranslate_contracted = true;
+    backtranslate_append(mark);
+    return;
+  }
+
+  // Not readable letter by letter
+  backtranslate_valid = false;
+  backtranslate_contracted = true;
+}
+
+/**
+ * @brief Records a rule at every cell of the word where it applies and covers
+ *        more cells than what was found there before
+ * @param rule - const translate_rule_t*, rule from the rule file
+ * @param number - int, rule number in the file, from 1
+ * @param cells - const char*, cells of the word without indicators
+ * @param length - int, number of cells
+ * @return Void
+ */
+static void backtranslate_apply_rule(const translate_rule_t* rule, int number,
+  const char* cells, int length)
+{
+  int pos, first, last;
+
+  if(!translate_rule_range(rule->where, rule->num_cells, length,
+    &first, &last))
+  {
+    return;
+  }
+
+  for(pos = first; pos <= last; pos++)
+  {
+    if(rule->num_cells > backtranslate_matches[pos].num_cells &&
+      memcmp(cells + pos, rule->cells, rule->num_cells) == 0)
+    {
+      backtranslate_matches[pos].rule = number;
+      backtranslate_matches[pos].num_cells = rule->num_cells;
+      backtranslate_matches[pos].text_length = rule->text_length;
+    }
+  }
+}
+
+/**
+ * @brief Reads contracted cells with the rules in TRANSLATE_RULES_FILE. The
+ *        first pass over the file finds the longest rule at each cell and the
+ *        cells are then read left to right like translate_contracted writes
+ *        them; the second pass copies in the letters of the rules used, so
+ *        rule text is never kept per cell.
+ * @param cells - const char*, cells of the word without indicators
+ * @param length - int, number of cells
+ * @param text - char*, set to the lower case letters, not terminated
+ * @param max_text - int, room in text
+ * @return int - number of letters, -1 if the cells cannot be read
+ */
+static int backtranslate_contracted_cells(const char* cells, int length,
+  char* text, int max_text)
+{
+  struct file_stream stream;
+  translate_rule_t rule;
+  bool rules_used = false;
+  int text_length = 0;
+  int number, pos;
+
+  if(!translate_open_rules(&stream))
+  {
+    return -1;
+  }
+
+  memset(backtranslate_matches, 0, sizeof(backtranslate_matches));
+  for(number = 1; translate_next_rule(&stream, &rule); number++)
+  {
+    backtranslate_apply_rule(&rule, number, cells, length);
+  }
+
+  for(pos = 0; pos < length; )
+  {
+    backtranslate_match_t* match = &backtranslate_matches[pos];
+
+    if(match->rule == 0)
+    {
+      char letter = backtranslate_letter(cells[pos]);
+
+      if(letter == '\0' || text_length >= max_text)
+      {
+        return -1;
+      }
+      text[text_length++] = letter;
+      pos++;
+      continue;
+    }
+
+    if(text_length + match->text_length > max_text)
+    {
+      return -1;
+    }
+    match->offset = text_length;
+    text_length += match->text_length;
+    rules_used = true;
+    pos += match->num_cells;
+  }
+
+  if(!rules_used)
+  {
+    return text_length;
+  }
+
+  if(!seek_file_stream(&stream, 0))
+  {
+    return -1;
+  }
+  for(number = 1; translate_next_rule(&stream, &rule); number++)
+  {
+    for(pos = 0; pos < length; pos += backtranslate_matches[pos].num_cells ?
+      backtranslate_matches[pos].num_cells : 1)
+    {
+      if(backtranslate_matches[pos].rule == number)
+      {
+        memcpy(text + backtranslate_matches[pos].offset, rule.text,
+          rule.text_length);
+      }
+    }
+  }
+  return text_length;
+}
+
+/**
+ * @brief Reads the current word as contracted braille: punctuation around
+ *        it, then a Grade 1 sign or capital signs, then the contracted cells
+ * @param word - char*, buffer of TRANSLATE_MAX_WORD + 1 for the text
+ * @return bool - false if the cells cannot be read this way
+ */
+static bool backtranslate_contracted_word(char* word)
+{
+  int first = 0;
+  int last = backtranslate_num_cells;
+  int length = 0;
+  int capitals = 0;
+  int start, letters, i;
+
+  // Punctuation around a word is written separately, see translate_text
+  while(last - first > 1 &&
+    translate_punctuation_char(backtranslate_cells[last - 1]) != '\0')
+  {
+    last--;
+  }
+  while(last - first > 1 &&
+    translate_punctuation_char(backtranslate_cells[first]) != '\0')
+  {
+    word[length++] = translate_punctuation_char(backtranslate_cells[first++]);
+  }
+
+  // A letter after a Grade 1 sign is just the letter
+  if(backtranslate_cells[first] == TRANSLATE_GRADE_1_SIGN)
+  {
+    return false;
+  }
+
+  while(capitals < 2 && first < last &&
+    backtranslate_cells[first] == TRANSLATE_CAPITAL_SIGN)
+  {
+    capitals++;
+    first++;
+  }
+  if(first == last)
+  {
+    return false;
+  }
+
+  start = length;
+  letters = backtranslate_contracted_cells(backtranslate_cells + first,
+    last - first, word + length, TRANSLATE_MAX_WORD - length);
+  if(letters < 0)
+  {
+    return false;
+  }
+  length += letters;
+
+  for(i = start; i < length; i++)
+  {
+    if(capitals == 2 || (capitals == 1 && i == start))
+    {
+      word[i] = toupper((unsigned char) word[i]);
+    }
+  }
+
+  for(i = last; i < backtranslate_num_cells; i++)
+  {
+    if(length >= TRANSLATE_MAX_WORD)
+    {
+      return false;
+    }
+    word[length++] = translate_punctuation_char(backtranslate_cells[i]);
+  }
+  word[length] = '\0';
+  return true;
+}
+
+/**
+ * @brief Checks a finished word against the dictionary. Numbers and
+ *        punctuation on its own are always accepted.
+ * @param word - const char*, text of the word
+ * @return char - BACKTRANSLATE_WORD or BACKTRANSLATE_UNKNOWN
+ */
+static char backtranslate_lookup(const char* word)
+{
+  unsigned char lower[TRANSLATE_MAX_WORD + 1];
+  int first = 0;
+  int last = strlen(word);
+  int i;
+
+  while(first < last && ispunct((unsigned char) word[first]))
+  {
+    first++;
+  }
+  while(last > first && ispunct((unsigned char) word[last - 1]))
+  {
+    last--;
+  }
+  if(first == last)
+  {
+    return BACKTRANSLATE_WORD;
+  }
+
+  for(i = first; i < last; i++)
+  {
+    if(isdigit((unsigned char) word[i]))
+    {
+      return BACKTRANSLATE_WORD;
+    }
+    lower[i - first] = tolower((unsigned char) word[i]);
+  }
+  lower[last - first] = '\0';
+
+  return bin_srch_dict(lower) ? BACKTRANSLATE_WORD : BACKTRANSLATE_UNKNOWN;
+}
+
+/**
+ * @brief Finishes the current word. In Grade 2 the rules are only read for
+ *        words with contraction cells or a lone letter, which may be a
+ *        wordsign; if the rules do not fit, the word is read letter by letter.
+ * @return char - BACKTRANSLATE_WORD, BACKTRANSLATE_UNKNOWN or
+ *                BACKTRANSLATE_INVALID
+ */
+static char backtranslate_finish_word(void)
+{
+  bool contracted = false;
+  char result;
+
+  if(backtranslate_grade == TRANSLATE_GRADE_2 && !backtranslate_numbers &&
+    (backtranslate_contracted || backtranslate_length == 1))
+  {
+    contracted = backtranslate_contracted_word(backtranslate_result);
+  }
+
+  if(contracted)
+  {
+    result = backtranslate_lookup(backtranslate_result);
+  }
+  else if(backtranslate_valid &&
+    backtranslate_capitals != BACKTRANSLATE_CAPS_LETTER)
+  {
+    strcpy(backtranslate_result, backtranslate_text);
+    result = backtranslate_lookup(backtranslate_result);
+  }
+  else
+  {
+    // Keep whatever was readable so the mode can tell the user
+    strcpy(backtranslate_result, backtranslate_text);
+    result = BACKTRANSLATE_INVALID;
+  }
+
+  sprintf(dbgstr, "[Backtranslate] Word \"%s\": %d\n\r", backtranslate_result,
+    result);
+  PRINTF(dbgstr);
+
+  backtranslate_reset_word();
+  return result;
+}
+
+/**
+ * @brief Takes the next cell of the line. A blank cell or END_OF_TEXT ends
+ *        the current word, which can then be read with backtranslate_word.
+ * @param cell - char, cell pattern
+ * @return char - BACKTRANSLATE_PENDING while the word is being written,
+ *                otherwise the result for the word just finished
+ */
+char backtranslate_cell(char cell)
+{
+  if(cell == NO_DOTS || cell == (char) END_OF_TEXT)
+  {
+    if(backtranslate_num_cells == 0)
+    {
+      return BACKTRANSLATE_PENDING;
+    }
+    return backtranslate_finish_word();
+  }
+
+  if(backtranslate_num_cells >= BACKTRANSLATE_MAX_CELLS)
+  {
+    backtranslate_valid = false;
+    backtranslate_contracted = false;
+    return BACKTRANSLATE_PENDING;
+  }
+  backtranslate_cells[backtranslate_num_cells++] = cell;
+  backtranslate_read_cell(cell);
+  return BACKTRANSLATE_PENDING;
+}
+
+/**
+ * @brief Text of the last finished word
+ * @return const char* - word, empty before the first word is finished
+ */
+const char* backtranslate_word(void)
+{
+  return backtranslate_result;
+}
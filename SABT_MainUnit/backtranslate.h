@@ -0,0 +1,26 @@
+/**
+ * @file backtranslate.h
+ * @brief Braille to text back-translation for English, fed one cell at a
+ *        time so each word can be checked as soon as it is finished
+ */
+
+#ifndef _BACKTRANSLATE_H_
+#define _BACKTRANSLATE_H_
+
+#include <stdbool.h>
+#include "translate.h"
+
+// Results of backtranslate_cell
+#define BACKTRANSLATE_PENDING 0   // Word not finished yet
+#define BACKTRANSLATE_WORD    1   // Word in the dictionary, a number or punctuation
+#define BACKTRANSLATE_UNKNOWN 2   // Readable word that is not in the dictionary
+#define BACKTRANSLATE_INVALID 3   // Cells that do not spell anything
+
+// Cells kept for the current word, indicators included
+#define BACKTRANSLATE_MAX_CELLS TRANSLATE_MAX_WORD
+
+void backtranslate_reset(char grade);
+char backtranslate_cell(char cell);
+const char* backtranslate_word(void);
+
+#endif /* _BACKTRANSLATE_H_ */
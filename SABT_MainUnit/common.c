@@ -9,8 +9,12 @@
 #include "common.h"
 #include "script_common.h"
 #include "glyph.h"
+#include "script_english.h"
+#include "script_hindi.h"
+#include "script_kannada.h"
 
 #include <stdbool.h>
+#include <string.h>
 
 /**
 * @brief Sets script globals for a new language
@@ -27,12 +31,65 @@ void set_mode_globals(script_t* new_script, char* new_lang_fileset,
 }
 
 /**
- * @brief Generates a pseudo-random integer based on the system timer
- * @param void
- * @return int - Pseudo-random value
+* @brief Finds the script for a language code from MODES.DAT
+* @param const char* language - Language code, e.g. "HIN" for HIN_ files
+* @return script_t* - Matching script, NULL if there is none
+*/
+script_t* find_language_script(const char* language) {
+	script_t* scripts[] = {&script_english, &script_hindi, &script_kannada};
+
+	for (int i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++) {
+		if (strncmp(scripts[i]->fileset, language, strlen(language)) == 0 &&
+			scripts[i]->fileset[strlen(language)] == '_') {
+			return scripts[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Fills a shuffle bag with the numbers 0 to size - 1
+ * @param shuffle_bag_t* bag - Bag to fill
+ * @param unsigned char size - Number of items, at most SHUFFLE_BAG_SIZE
+ * @return void
  */
-int timer_rand(void) {
-	return TCNT1 * 53;
+void shuffle_bag_init(shuffle_bag_t* bag, unsigned char size) {
+	if (size > SHUFFLE_BAG_SIZE) {
+		size = SHUFFLE_BAG_SIZE;
+	}
+	for (unsigned char i = 0; i < size; i++) {
+		bag->items[i] = i;
+	}
+	bag->size = size;
+	bag->left = size;
+}
+
+/**
+ * @brief Draws the next item from a shuffle bag. This is one step of a
+ *        Fisher-Yates shuffle, so each draw takes one random number; the bag
+ *        refills itself when it is empty.
+ * @param shuffle_bag_t* bag - Bag to draw from
+ * @return unsigned char - Item, 0 if the bag is empty
+ */
+unsigned char shuffle_bag_draw(shuffle_bag_t* bag) {
+	unsigned char pick, item;
+
+	if (bag->size == 0) {
+		return 0;
+	}
+	if (bag->left == 0) {
+		// The last item drawn is left at the front; keep it out of the first draw
+		bag->left = bag->size;
+		pick = (bag->size > 1) ? 1 + random_below(bag->size - 1) : 0;
+	} else {
+		pick = random_below(bag->left);
+	}
+
+	bag->left--;
+	item = bag->items[pick];
+	bag->items[pick] = bag->items[bag->left];
+	bag->items[bag->left] = item;
+	return item;
 }
 
 /**
@@ -51,6 +108,8 @@ char add_dot(char bits, char dot) {
  * @return void
  */
 void quit_mode(void) {
+	userlog_flush();
+	settings_commit();
 	ui_is_mode_selected = false;
   ui_current_mode_index = -1;
   play_mp3("SYS_","MM");
@@ -13,8 +13,22 @@
 #define PLUS_ONE_MOD(X, BOUND) ((X + 1 > BOUND - 1) ? (0) : (X + 1))	
 #define MINUS_ONE_MOD(X, BOUND) ((X - 1 < 0) ? (BOUND - 1) : (X - 1))
 
+// Most items a shuffle bag can hold
+#define SHUFFLE_BAG_SIZE 16
+
+// Hands out the numbers 0 to size - 1 in random order, each once, then
+// starts again with a new order. The first item of a new round is never the
+// last item of the round before.
+typedef struct shuffle_bag {
+	unsigned char items[SHUFFLE_BAG_SIZE];
+	unsigned char size;		/* Number of items in the bag */
+	unsigned char left;		/* Items not drawn yet this round */
+} shuffle_bag_t;
+
 void set_mode_globals(script_t* new_script, char* new_lang_fileset, char* new_mode_fileset);
-int timer_rand(void);
+script_t* find_language_script(const char* language);
+void shuffle_bag_init(shuffle_bag_t* bag, unsigned char size);
+unsigned char shuffle_bag_draw(shuffle_bag_t* bag);
 char add_dot(char bits, char dot);
 void quit_mode(void);
 int ten_to_the(int);
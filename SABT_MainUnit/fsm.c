@@ -0,0 +1,483 @@
+/**
+ * @file fsm.c
+ * @brief Interpreter for game scripts read from the SD card. A script is a
+ *        set of states; each state runs instructions until it ends the game,
+ *        enters another state or waits for input. Instructions are fetched
+ *        through a small cache, so only a few lines of the script are in RAM
+ *        at any time.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "fsm.h"
+
+static unsigned char fsm_cache[FSM_CACHE_LINES][FSM_CACHE_LINE_SIZE];
+static unsigned int fsm_cache_tag[FSM_CACHE_LINES];   // Line number + 1, 0 if empty
+static unsigned char fsm_cache_victim;
+
+static unsigned char fsm_num_states;
+static unsigned int fsm_pc;
+static unsigned int fsm_op_pc;
+static unsigned int fsm_wait_pc;        // Handler list of the last WAIT, 0 if none
+static char fsm_status = FSM_ENDED;
+static bool fsm_failed;
+
+static int fsm_vars[FSM_NUM_VARS];
+static char fsm_word[FSM_MAX_WORD + 1];
+static unsigned char fsm_word_length;
+static unsigned char fsm_cell;          // Dots entered since the last ENTER
+
+/**
+ * @brief Reads a byte of the script, filling a cache line if needed. The line
+ *        used least recently is replaced.
+ * @param offset - unsigned int, offset into the script
+ * @return unsigned char - the byte, 0 (END) if the script could not be read
+ */
+static unsigned char fsm_read_byte(unsigned int offset)
+{
+  unsigned int tag = offset / FSM_CACHE_LINE_SIZE + 1;
+  unsigned char line;
+
+  for(line = 0; line < FSM_CACHE_LINES; line++)
+  {
+    if(fsm_cache_tag[line] == tag)
+    {
+      break;
+    }
+  }
+
+  if(line == FSM_CACHE_LINES)
+  {
+    line = fsm_cache_victim;
+    if(!fsm_platform_read((tag - 1) * FSM_CACHE_LINE_SIZE, fsm_cache[line],
+      FSM_CACHE_LINE_SIZE))
+    {
+      fsm_cache_tag[line] = 0;
+      fsm_failed = true;
+      return FSM_OP_END;
+    }
+    fsm_cache_tag[line] = tag;
+  }
+
+  fsm_cache_victim = (line + 1) % FSM_CACHE_LINES;
+  return fsm_cache[line][offset % FSM_CACHE_LINE_SIZE];
+}
+
+/**
+ * @brief Reads the next byte of code
+ * @return unsigned char - byte at the program counter
+ */
+static unsigned char fsm_fetch(void)
+{
+  return fsm_read_byte(fsm_pc++);
+}
+
+/**
+ * @brief Reads the next 2 bytes of code, low byte first
+ * @return unsigned int - value read
+ */
+static unsigned int fsm_fetch_word(void)
+{
+  unsigned int low = fsm_fetch();
+  return low | ((unsigned int)fsm_fetch() << 8);
+}
+
+/**
+ * @brief Reads a signed 2 byte number from the code
+ * @return int - value read
+ */
+static int fsm_fetch_number(void)
+{
+  return (int16_t)fsm_fetch_word();
+}
+
+/**
+ * @brief Reads a variable number from the code
+ * @return int* - the variable, NULL if the number is out of range
+ */
+static int* fsm_fetch_var(void)
+{
+  unsigned char var = fsm_fetch();
+
+  if(var >= FSM_NUM_VARS)
+  {
+    fsm_failed = true;
+    return NULL;
+  }
+  return &fsm_vars[var];
+}
+
+/**
+ * @brief Reads a string (length byte and characters) from the code
+ * @param dest - char*, set to the string, at least FSM_MAX_STRING + 1 bytes
+ * @return bool - false if the string is too long
+ */
+static bool fsm_fetch_string(char* dest)
+{
+  unsigned char length = fsm_fetch();
+  unsigned char i;
+
+  if(length > FSM_MAX_STRING)
+  {
+    fsm_failed = true;
+    return false;
+  }
+  for(i = 0; i < length; i++)
+  {
+    dest[i] = fsm_fetch();
+  }
+  dest[length] = '\0';
+  return true;
+}
+
+/**
+ * @brief Moves the program counter to the code of a state
+ * @param state - unsigned char, state number
+ * @return bool - false if there is no such state
+ */
+static bool fsm_enter_state(unsigned char state)
+{
+  if(state >= fsm_num_states)
+  {
+    fsm_failed = true;
+    return false;
+  }
+  fsm_pc = FSM_HEADER_SIZE + 2 * state;
+  fsm_pc = fsm_fetch_word();
+  fsm_wait_pc = 0;
+  return true;
+}
+
+/**
+ * @brief Runs a compare and jump instruction
+ * @param op - unsigned char, FSM_OP_JEQ, JNE, JLT or JGT
+ * @return Void
+ */
+static void fsm_compare(unsigned char op)
+{
+  int* var = fsm_fetch_var();
+  int number = fsm_fetch_number();
+  unsigned int target = fsm_fetch_word();
+  bool jump;
+
+  if(var == NULL)
+  {
+    return;
+  }
+  switch(op)
+  {
+    case FSM_OP_JEQ:
+      jump = (*var == number);
+      break;
+    case FSM_OP_JNE:
+      jump = (*var != number);
+      break;
+    case FSM_OP_JLT:
+      jump = (*var < number);
+      break;
+    default:
+      jump = (*var > number);
+      break;
+  }
+  if(jump)
+  {
+    fsm_pc = target;
+  }
+}
+
+/**
+ * @brief Runs one instruction
+ * @return char - FSM_RUNNING, or the status the instruction left the game in
+ */
+static char fsm_step(void)
+{
+  unsigned char op;
+  int* var;
+  int* var2;
+  int number;
+  unsigned int target;
+  char fileset[FSM_MAX_STRING + 1];
+  char name[FSM_MAX_STRING + 1];
+
+  fsm_op_pc = fsm_pc;
+  op = fsm_fetch();
+  switch(op)
+  {
+    case FSM_OP_END:
+      // fsm_fetch returns FSM_OP_END when the script cannot be read
+      return fsm_failed ? FSM_ERROR : FSM_ENDED;
+
+    case FSM_OP_PLAY:
+      if(fsm_fetch_string(fileset) && fsm_fetch_string(name))
+      {
+        fsm_platform_play(fileset, name);
+      }
+      break;
+
+    case FSM_OP_SAYNUM:
+    case FSM_OP_SAYCELL:
+      var = fsm_fetch_var();
+      if(var == NULL)
+      {
+        break;
+      }
+      if(op == FSM_OP_SAYNUM)
+      {
+        fsm_platform_say_number(*var);
+      }
+      else
+      {
+        fsm_platform_say_cell((char)*var);
+      }
+      break;
+
+    case FSM_OP_SET:
+    case FSM_OP_ADD:
+    case FSM_OP_RAND:
+      var = fsm_fetch_var();
+      number = fsm_fetch_number();
+      if(var == NULL)
+      {
+        break;
+      }
+      if(op == FSM_OP_SET)
+      {
+        *var = number;
+      }
+      else if(op == FSM_OP_ADD)
+      {
+        *var += number;
+      }
+      else
+      {
+        *var = (number > 0) ? fsm_platform_random(number) : 0;
+      }
+      break;
+
+    case FSM_OP_MOV:
+      var = fsm_fetch_var();
+      var2 = fsm_fetch_var();
+      if(var != NULL && var2 != NULL)
+      {
+        *var = *var2;
+      }
+      break;
+
+    case FSM_OP_JMP:
+      fsm_pc = fsm_fetch_word();
+      break;
+
+    case FSM_OP_JEQ:
+    case FSM_OP_JNE:
+    case FSM_OP_JLT:
+    case FSM_OP_JGT:
+      fsm_compare(op);
+      break;
+
+    case FSM_OP_JEQV:
+      var = fsm_fetch_var();
+      var2 = fsm_fetch_var();
+      target = fsm_fetch_word();
+      if(var != NULL && var2 != NULL && *var == *var2)
+      {
+        fsm_pc = target;
+      }
+      break;
+
+    case FSM_OP_GOTO:
+      fsm_enter_state(fsm_fetch());
+      break;
+
+    case FSM_OP_WAIT:
+      fsm_wait_pc = fsm_pc;
+      return FSM_WAITING;
+
+    case FSM_OP_STAY:
+      if(fsm_wait_pc == 0)
+      {
+        fsm_failed = true;
+        break;
+      }
+      return FSM_WAITING;
+
+    case FSM_OP_WCLR:
+      fsm_word_length = 0;
+      fsm_word[0] = '\0';
+      break;
+
+    case FSM_OP_WADD:
+      var = fsm_fetch_var();
+      // Characters past the end of the word are dropped
+      if(var != NULL && fsm_word_length < FSM_MAX_WORD)
+      {
+        fsm_word[fsm_word_length++] = (char)*var;
+        fsm_word[fsm_word_length] = '\0';
+      }
+      break;
+
+    case FSM_OP_LETTER:
+      var = fsm_fetch_var();
+      if(var != NULL)
+      {
+        *var = (unsigned char)fsm_platform_letter((char)*var);
+      }
+      break;
+
+    case FSM_OP_JDICT:
+      target = fsm_fetch_word();
+      if(fsm_word_length > 0 && fsm_platform_in_dictionary(fsm_word))
+      {
+        fsm_pc = target;
+      }
+      break;
+
+    default:
+      fsm_failed = true;
+      break;
+  }
+
+  return fsm_failed ? FSM_ERROR : FSM_RUNNING;
+}
+
+/**
+ * @brief Checks the script header, clears all variables and enters state 0
+ * @return bool - false if the script could not be read or is not a script
+ */
+bool fsm_start(void)
+{
+  unsigned char i;
+  char magic[FSM_MAGIC_SIZE];
+
+  memset(fsm_cache_tag, 0, sizeof(fsm_cache_tag));
+  memset(fsm_vars, 0, sizeof(fsm_vars));
+  fsm_cache_victim = 0;
+  fsm_failed = false;
+  fsm_word_length = 0;
+  fsm_word[0] = '\0';
+  fsm_cell = 0;
+  fsm_op_pc = 0;
+  fsm_status = FSM_ERROR;
+
+  for(i = 0; i < FSM_MAGIC_SIZE; i++)
+  {
+    magic[i] = fsm_read_byte(i);
+  }
+  fsm_num_states = fsm_read_byte(FSM_MAGIC_SIZE);
+  if(fsm_failed || memcmp(magic, FSM_MAGIC, FSM_MAGIC_SIZE) != 0 ||
+    fsm_num_states == 0)
+  {
+    return false;
+  }
+
+  if(!fsm_enter_state(0))
+  {
+    return false;
+  }
+  fsm_status = FSM_RUNNING;
+  return true;
+}
+
+/**
+ * @brief Runs the script until it waits for input or ends, or for at most
+ *        FSM_MAX_STEPS instructions so a looping script cannot stall the
+ *        main loop
+ * @return char - FSM_RUNNING, FSM_WAITING, FSM_ENDED or FSM_ERROR
+ */
+char fsm_run(void)
+{
+  unsigned char steps;
+
+  for(steps = 0; steps < FSM_MAX_STEPS && fsm_status == FSM_RUNNING; steps++)
+  {
+    fsm_status = fsm_step();
+  }
+  return fsm_status;
+}
+
+/**
+ * @brief Passes an input event to the waiting script. The first handler
+ *        matching the event runs next, with the event value in variable
+ *        FSM_VAR_INPUT. Dots no handler takes are collected into a cell;
+ *        ENTER after them becomes a FSM_EVENT_CELL event and CANCEL drops
+ *        them.
+ * @param event - char, FSM_EVENT_*
+ * @param value - char, dot number for FSM_EVENT_DOT, otherwise ignored
+ * @return bool - true if a handler matched
+ */
+bool fsm_input(char event, char value)
+{
+  unsigned char handler_event;
+  unsigned char handler_value;
+  unsigned int target;
+  unsigned int pc;
+
+  if(fsm_status != FSM_WAITING)
+  {
+    return false;
+  }
+
+  switch(event)
+  {
+    case FSM_EVENT_DOT:
+      if(value < 1 || value > 6)
+      {
+        return false;
+      }
+      break;
+    case FSM_EVENT_ENTER:
+      if(fsm_cell != 0)
+      {
+        event = FSM_EVENT_CELL;
+      }
+      value = fsm_cell;
+      fsm_cell = 0;
+      break;
+    case FSM_EVENT_CANCEL:
+      fsm_cell = 0;
+      value = 0;
+      break;
+    default:
+      value = 0;
+      break;
+  }
+
+  pc = fsm_wait_pc;
+  while(1)
+  {
+    handler_event = fsm_read_byte(pc++);
+    if(handler_event == 0)
+    {
+      break;
+    }
+    handler_value = fsm_read_byte(pc++);
+    target = fsm_read_byte(pc++);
+    target |= (unsigned int)fsm_read_byte(pc++) << 8;
+    if(handler_event == (unsigned char)event &&
+      (handler_value == FSM_ANY || handler_value == (unsigned char)value))
+    {
+      fsm_vars[FSM_VAR_INPUT] = (unsigned char)value;
+      fsm_pc = target;
+      fsm_status = FSM_RUNNING;
+      return true;
+    }
+  }
+
+  if(fsm_failed)
+  {
+    fsm_status = FSM_ERROR;
+  }
+  else if(event == FSM_EVENT_DOT)
+  {
+    fsm_cell |= 1 << (value - 1);
+  }
+  return false;
+}
+
+/**
+ * @brief Offset of the instruction that was running when the script failed
+ * @return unsigned int - offset into the script
+ */
+unsigned int fsm_error_offset(void)
+{
+  return fsm_op_pc;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file fsm.h
+ * @brief Interpreter for game scripts (state machines compiled to bytecode)
+ *        that are read from the SD card as they run. fsm.c has no hardware
+ *        dependencies: the mode that runs a script, and the host tools in
+ *        tools/fsm, provide the fsm_platform_* functions.
+ */
+
+#ifndef _FSM_H_
+#define _FSM_H_
+
+#include <stdbool.h>
+
+// Script layout: FSM_MAGIC, the number of states, then the code offset of
+// each state (2 bytes, low byte first). State 0 runs first.
+#define FSM_MAGIC "FSM1"
+#define FSM_MAGIC_SIZE 4
+#define FSM_HEADER_SIZE (FSM_MAGIC_SIZE + 1)
+#define FSM_MAX_STATES 255
+
+#define FSM_NUM_VARS 16
+#define FSM_VAR_INPUT 0           // Set to the value of each input event
+#define FSM_MAX_WORD 16
+#define FSM_MAX_STRING 8
+#define FSM_MAX_STEPS 200         // Instructions per call to fsm_run
+
+// Code is read through a small cache of script lines
+#define FSM_CACHE_LINES 2
+#define FSM_CACHE_LINE_SIZE 32
+
+// Opcodes. v is a variable number, n a 2 byte signed number, a a 2 byte code
+// offset, s a state number and str a length byte followed by the characters.
+#define FSM_OP_END     0x00       // Ends the game
+#define FSM_OP_PLAY    0x01       // str fileset, str name: play an MP3
+#define FSM_OP_SAYNUM  0x02       // v: say a number
+#define FSM_OP_SAYCELL 0x03       // v: say the dots of a cell pattern
+#define FSM_OP_SET     0x04       // v n: v = n
+#define FSM_OP_ADD     0x05       // v n: v += n
+#define FSM_OP_MOV     0x06       // v v2: v = v2
+#define FSM_OP_RAND    0x07       // v n: v = random number from 0 to n - 1
+#define FSM_OP_JMP     0x08       // a
+#define FSM_OP_JEQ     0x09       // v n a: jump if v == n
+#define FSM_OP_JNE     0x0A       // v n a: jump if v != n
+#define FSM_OP_JLT     0x0B       // v n a: jump if v < n
+#define FSM_OP_JGT     0x0C       // v n a: jump if v > n
+#define FSM_OP_JEQV    0x0D       // v v2 a: jump if v == v2
+#define FSM_OP_GOTO    0x0E       // s: enter a state
+#define FSM_OP_WAIT    0x0F       // Handler list: wait for input
+#define FSM_OP_STAY    0x10       // Wait again on the last handler list
+#define FSM_OP_WCLR    0x11       // Clear the word
+#define FSM_OP_WADD    0x12       // v: add character v to the word
+#define FSM_OP_LETTER  0x13       // v: v = letter written by cell pattern v, 0 if none
+#define FSM_OP_JDICT   0x14       // a: jump if the word is in the dictionary
+
+// Input events. A WAIT is followed by handlers - event, value (or FSM_ANY)
+// and code offset - and a 0 byte. The first matching handler runs.
+#define FSM_EVENT_DOT    1        // Value is the dot number
+#define FSM_EVENT_CELL   2        // ENTER after dots; value is the pattern
+#define FSM_EVENT_ENTER  3        // ENTER with no dots
+#define FSM_EVENT_CANCEL 4
+#define FSM_EVENT_LEFT   5
+#define FSM_EVENT_RIGHT  6
+#define FSM_ANY          0xFF
+
+// Results of fsm_run
+#define FSM_RUNNING 0             // Out of steps for this call, call again
+#define FSM_WAITING 1             // Waiting for fsm_input
+#define FSM_ENDED   2
+#define FSM_ERROR   3
+
+bool fsm_start(void);
+char fsm_run(void);
+bool fsm_input(char event, char value);
+unsigned int fsm_error_offset(void);
+
+// Provided by whatever runs the script
+bool fsm_platform_read(unsigned int offset, unsigned char* dest,
+  unsigned char length);
+void fsm_platform_play(char* fileset, char* name);
+void fsm_platform_say_number(int number);
+void fsm_platform_say_cell(char pattern);
+int fsm_platform_random(int limit);
+char fsm_platform_letter(char pattern);
+bool fsm_platform_in_dictionary(char* word);
+
+#endif /* _FSM_H_ */
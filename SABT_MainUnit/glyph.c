@@ -4,24 +4,79 @@
 * @author Vivek Nair (viveknair@cmu.edu)
 */
 
+#include <avr/pgmspace.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 #include "glyph.h"
 #include "globals.h"
 
+/**
+* @brief Reads a glyph's cell pattern
+* @param const glyph_t* this_glyph - Glyph to read
+* @return char - 6-bit cell pattern
+*/
+char glyph_pattern(const glyph_t* this_glyph) {
+	return pgm_read_byte(&this_glyph->pattern);
+}
+
+/**
+* @brief Copies a glyph's sound name into RAM
+* @param const glyph_t* this_glyph - Glyph to read
+* @param char* sound - Buffer of at least GLYPH_SOUND_SIZE characters
+* @return void
+*/
+void glyph_sound(const glyph_t* this_glyph, char* sound) {
+	strncpy_P(sound, this_glyph->sound, GLYPH_SOUND_SIZE - 1);
+	sound[GLYPH_SOUND_SIZE - 1] = '\0';
+}
+
+/**
+* @brief Returns the fileset to play a glyph's sound with
+* @param const char* sound - Sound from glyph_sound()
+* @param char* fileset - Fileset of the glyph's language
+* @return char* - fileset, or NULL if the sound is a whole file name
+*/
+char* glyph_sound_fileset(const char* sound, char* fileset) {
+	return (strchr(sound, GLYPH_SOUND_FILESET_MARK) != NULL) ? NULL : fileset;
+}
+
+/**
+* @brief Returns the previous glyph in a multi-cell sequence
+* @param const glyph_t* this_glyph - Glyph to start from
+* @return const glyph_t* - Previous glyph, NULL if this is the first cell
+*/
+const glyph_t* glyph_prev(const glyph_t* this_glyph) {
+	signed char offset = pgm_read_byte(&this_glyph->prev);
+	return (offset == 0) ? NULL : this_glyph + offset;
+}
+
+/**
+* @brief Returns the next glyph in a multi-cell sequence
+* @param const glyph_t* this_glyph - Glyph to start from
+* @return const glyph_t* - Next glyph, NULL if this is the last cell
+*/
+const glyph_t* glyph_next(const glyph_t* this_glyph) {
+	signed char offset = pgm_read_byte(&this_glyph->next);
+	return (offset == 0) ? NULL : this_glyph + offset;
+}
+
 /**
 * @brief Compares 2 glyphs
 * @param glyph_t* g1, g2 - The 2 glyphs to compare
 * @bool true if cell patterns match, false otherwise
 */
-bool glyph_equals(glyph_t* g1, glyph_t* g2) {
-	sprintf(dbgstr, "[Script] Gylph 1: %s\n\r", g1->sound);
-	PRINTF(dbgstr);
-	sprintf(dbgstr, "[Script] Gylph 2: %s\n\r", g2->sound);
-	PRINTF(dbgstr);
+bool glyph_equals(const glyph_t* g1, const glyph_t* g2) {
+	char sound[GLYPH_SOUND_SIZE];
+
 	if (g1 == NULL || g2 == NULL) {
 		return false;
-	} else {
-		return (g1->pattern == g2->pattern);
 	}
-}
\ No newline at end of file
+	glyph_sound(g1, sound);
+	sprintf(dbgstr, "[Script] Gylph 1: %s\n\r", sound);
+	PRINTF(dbgstr);
+	glyph_sound(g2, sound);
+	sprintf(dbgstr, "[Script] Gylph 2: %s\n\r", sound);
+	PRINTF(dbgstr);
+	return (glyph_pattern(g1) == glyph_pattern(g2));
+}
@@ -9,16 +9,36 @@
 
 #include <stdbool.h>
 
+// Scripts carry a flash-resident index with one byte per 6-bit cell pattern.
+// An entry holds the position of the first glyph with that pattern plus one
+// (SCRIPT_INDEX_NONE if there is none); SCRIPT_INDEX_PREFIX is set when that
+// glyph starts a multi-cell sequence.
+#define SCRIPT_INDEX_SIZE 64
+#define SCRIPT_INDEX_NONE 0x00
+#define SCRIPT_INDEX_PREFIX 0x80
+#define SCRIPT_INDEX_MASK 0x7F
+
+// Sound names are BBBB in AAA_BBBB.mp3, up to 4 characters, or a whole file
+// name with its own fileset, up to 8 characters, if they contain
+// GLYPH_SOUND_FILESET_MARK (two-cell contractions are "CON1_W4" and so on)
+#define GLYPH_SOUND_SIZE 9
+#define GLYPH_SOUND_FILESET_MARK '_'
+
+// Longest word that can be held in a word_t
+#define MAX_WORD_LENGTH 16
+
 typedef struct glyph glyph_t;
 typedef struct script script_t;
-typedef struct word_node word_node_t;
+typedef struct word word_t;
 
-// Stores information about single glyph; used to build scripts
+// Stores information about single glyph; used to build scripts. Glyph tables
+// live in program memory, so fields must be read through the glyph_*
+// accessors rather than dereferenced directly.
 struct glyph {
 	char pattern;			/* 0bxxxxxx 6-bit pattern Braille representation */
-	char sound[5];			/* BBBB in AAA_BBBB.mp3 soundfile */
-	glyph_t* prev;			/* Pointer to previous glyph in linked list */
-	glyph_t* next;			/* Pointer to next glyph in linked list */
+	char sound[GLYPH_SOUND_SIZE];	/* BBBB in AAA_BBBB.mp3 soundfile, see above */
+	signed char prev;		/* Offset to previous glyph in the same table, 0 if none */
+	signed char next;		/* Offset to next glyph in the same table, 0 if none */
 };
 
 // Structure representing a script
@@ -26,15 +46,25 @@ struct script {
 	int length;				/* Length of first cell glyph array */
 	int index;				/* Current index */
 	char fileset[5];		/* Fileset on SD card; 4 characters long */
-	glyph_t* glyphs; 		/* Pointer to array of first cell glyphs */
+	const glyph_t* glyphs; 	/* PROGMEM array of first cell glyphs */
+	const unsigned char* lookup;	/* PROGMEM pattern index; SCRIPT_INDEX_SIZE entries */
 };
 
-struct word_node {
-	glyph_t* data;
-	struct word_node* next;	
+// A word is a flat array of glyphs. Words are owned by the mode that uses
+// them, so building one never touches the heap.
+struct word {
+	unsigned char length;	/* Number of glyphs in use */
+	const glyph_t* glyphs[MAX_WORD_LENGTH];
 };
 
+// Glyph accessors
+char glyph_pattern(const glyph_t* this_glyph);
+void glyph_sound(const glyph_t* this_glyph, char* sound);
+char* glyph_sound_fileset(const char* sound, char* fileset);
+const glyph_t* glyph_prev(const glyph_t* this_glyph);
+const glyph_t* glyph_next(const glyph_t* this_glyph);
+
 // Common glyph functions
-bool glyph_equals(glyph_t* g1, glyph_t* g2);
+bool glyph_equals(const glyph_t* g1, const glyph_t* g2);
 
 #endif /* _GLYPH_H_ */
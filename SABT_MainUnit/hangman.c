@@ -0,0 +1,296 @@
+/**
+ * @file hangman.c
+ * @brief Hangman game shared by mode 4 (one player) and mode 5 (two players).
+ *        When a word is set, each letter gets a mask of the positions it
+ *        fills, so a guess is a lookup and two bit operations whatever the
+ *        length of the word. The modes pick the word and then hand over to
+ *        hangman_main() for the turns.
+ */
+
+#include <string.h>
+#include "Globals.h"
+#include "audio.h"
+#include "letter_globals.h"
+#include "script_common.h"
+#include "hangman.h"
+
+// Prompts, in the fileset of the mode
+#define MP3_AND_MISTAKES "AMSK"
+#define MP3_MISTAKES "MSTK"
+#define MP3_GUESS "GAL"
+#define MP3_YOU_LOSE "YOLO"
+#define MP3_YOU_WIN "YOWI"
+#define MP3_SO_FAR "SOFA"
+
+// Prompts, in the fileset of the language
+#define MP3_YES "YES"
+#define MP3_NO "NO"
+
+static hangman_t hangman_game;
+static uint8_t hangman_state = HANGMAN_STATE_DONE;
+static uint8_t hangman_index;
+static char* hangman_mode_fileset;
+static char* hangman_lang_fileset;
+static char hangman_cell;
+static bool hangman_cell_ready = false;
+
+/**
+ * @brief Sets the word to guess and clears the guesses
+ * @param game - hangman_t*, game to set up
+ * @param word - const char*, letters a to z, 1 to HANGMAN_MAX_LENGTH of them
+ * @param check_dictionary - bool, only accept words in the dictionary file
+ * @return bool - false if the word is not acceptable
+ */
+bool hangman_set_word(hangman_t* game, const char* word,
+  bool check_dictionary)
+{
+  uint8_t i;
+
+  memset(game, 0, sizeof(*game));
+  for(i = 0; word[i] != '\0'; i++)
+  {
+    if(i == HANGMAN_MAX_LENGTH || word[i] < 'a' || word[i] > 'z')
+    {
+      return false;
+    }
+    game->word[i] = word[i];
+    game->positions[word[i] - 'a'] |= 1 << i;
+  }
+  game->length = i;
+
+  if(game->length == 0 ||
+    (check_dictionary && !bin_srch_dict((unsigned char*) game->word)))
+  {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Guesses a letter. Wrong letters and anything that is not a letter
+ *        count as mistakes, unless the letter was guessed before.
+ * @param game - hangman_t*, game being played
+ * @param letter - char, 'a' to 'z'
+ * @return uint8_t - HANGMAN_HIT, _MISS, _INVALID or _REPEAT
+ */
+uint8_t hangman_guess(hangman_t* game, char letter)
+{
+  uint8_t n = letter - 'a';
+
+  if(letter < 'a' || letter > 'z')
+  {
+    game->mistakes++;
+    return HANGMAN_INVALID;
+  }
+  if(game->guessed & (1UL << n))
+  {
+    return HANGMAN_REPEAT;
+  }
+
+  game->guessed |= 1UL << n;
+  if(game->positions[n] == 0)
+  {
+    game->mistakes++;
+    return HANGMAN_MISS;
+  }
+  game->revealed |= game->positions[n];
+  return HANGMAN_HIT;
+}
+
+/**
+ * @brief Whether every letter of the word has been found
+ * @param game - const hangman_t*, game being played
+ * @return bool - true if won
+ */
+bool hangman_won(const hangman_t* game)
+{
+  return game->length > 0 && game->revealed == (1U << game->length) - 1;
+}
+
+/**
+ * @brief Whether the player has run out of mistakes
+ * @param game - const hangman_t*, game being played
+ * @return bool - true if lost
+ */
+bool hangman_lost(const hangman_t* game)
+{
+  return game->mistakes >= HANGMAN_MAX_MISTAKES;
+}
+
+/**
+ * @brief Whether the letter at a position of the word has been found
+ * @param game - const hangman_t*, game being played
+ * @param position - uint8_t, position in the word
+ * @return bool - true if found
+ */
+bool hangman_is_revealed(const hangman_t* game, uint8_t position)
+{
+  return (game->revealed & (1U << position)) != 0;
+}
+
+/**
+ * @brief Plays a letter
+ * @param letter - char, 'a' to 'z'
+ * @return Void
+ */
+static void hangman_play_letter(char letter)
+{
+  char name[2] = { letter, '\0' };
+
+  play_mp3(hangman_lang_fileset, name);
+}
+
+/**
+ * @brief Starts a game of the shared turns run by hangman_main()
+ * @param word - const char*, word to guess
+ * @param check_dictionary - bool, only accept words in the dictionary file
+ * @param mode_fileset - char*, fileset of the mode's prompts
+ * @param lang_fileset - char*, fileset of letters and numbers
+ * @return bool - false if the word is not acceptable; no game is started
+ */
+bool hangman_start(const char* word, bool check_dictionary,
+  char* mode_fileset, char* lang_fileset)
+{
+  hangman_state = HANGMAN_STATE_DONE;
+  if(!hangman_set_word(&hangman_game, word, check_dictionary))
+  {
+    return false;
+  }
+  hangman_mode_fileset = mode_fileset;
+  hangman_lang_fileset = lang_fileset;
+  hangman_index = 0;
+  hangman_cell_ready = false;
+  hangman_state = HANGMAN_STATE_SAY_STATUS;
+  return true;
+}
+
+/**
+ * @brief Runs the next step of the game. Call from the mode's main function.
+ * @return bool - true once the game is over and the word has been read out
+ */
+bool hangman_main(void)
+{
+  char name[5];
+
+  switch(hangman_state)
+  {
+    case HANGMAN_STATE_SAY_STATUS:
+      if(hangman_index == hangman_game.length)
+      {
+        hangman_index = 0;
+        if(hangman_game.mistakes > 0)
+        {
+          play_mp3(hangman_mode_fileset, MP3_AND_MISTAKES);
+          hangman_state = HANGMAN_STATE_SAY_MISTAKES;
+        }
+        else
+        {
+          hangman_state = HANGMAN_STATE_ASK_FOR_GUESS;
+        }
+      }
+      else
+      {
+        if(hangman_is_revealed(&hangman_game, hangman_index))
+        {
+          hangman_play_letter(hangman_game.word[hangman_index]);
+        }
+        else
+        {
+          play_mp3(hangman_lang_fileset, MP3_BLANK);
+        }
+        hangman_index++;
+      }
+      break;
+
+    case HANGMAN_STATE_SAY_MISTAKES:
+      sprintf(name, "#%d", hangman_game.mistakes);
+      play_mp3(hangman_lang_fileset, name);
+      play_mp3(hangman_mode_fileset, MP3_MISTAKES);
+      hangman_state = HANGMAN_STATE_ASK_FOR_GUESS;
+      break;
+
+    case HANGMAN_STATE_ASK_FOR_GUESS:
+      play_mp3(hangman_mode_fileset, MP3_GUESS);
+      hangman_state = HANGMAN_STATE_WAIT_INPUT;
+      break;
+
+    case HANGMAN_STATE_WAIT_INPUT:
+      if(!hangman_cell_ready)
+      {
+        wait_for_input();
+        break;
+      }
+      hangman_cell_ready = false;
+      hangman_state = HANGMAN_STATE_EVALUATE;
+
+      // Nothing was entered, so the word is read out again
+      if(hangman_cell == 0)
+      {
+        break;
+      }
+      entered_letter = get_letter_from_bits(hangman_cell);
+      switch(hangman_guess(&hangman_game, entered_letter))
+      {
+        case HANGMAN_INVALID:
+          play_mp3(hangman_lang_fileset, MP3_INVALID_PATTERN);
+          break;
+
+        case HANGMAN_HIT:
+        case HANGMAN_REPEAT:
+          hangman_play_letter(entered_letter);
+          play_mp3(hangman_lang_fileset,
+            hangman_game.positions[entered_letter - 'a'] ? MP3_YES : MP3_NO);
+          break;
+
+        case HANGMAN_MISS:
+          hangman_play_letter(entered_letter);
+          play_mp3(hangman_lang_fileset, MP3_NO);
+          break;
+      }
+      break;
+
+    case HANGMAN_STATE_EVALUATE:
+      if(hangman_won(&hangman_game))
+      {
+        play_mp3(hangman_mode_fileset, MP3_YOU_WIN);
+        hangman_state = HANGMAN_STATE_READ_WORD;
+      }
+      else if(hangman_lost(&hangman_game))
+      {
+        play_mp3(hangman_mode_fileset, MP3_YOU_LOSE);
+        hangman_state = HANGMAN_STATE_READ_WORD;
+      }
+      else
+      {
+        play_mp3(hangman_mode_fileset, MP3_SO_FAR);
+        hangman_state = HANGMAN_STATE_SAY_STATUS;
+      }
+      hangman_index = 0;
+      break;
+
+    case HANGMAN_STATE_READ_WORD:
+      if(hangman_index == hangman_game.length)
+      {
+        hangman_state = HANGMAN_STATE_DONE;
+        return true;
+      }
+      hangman_play_letter(hangman_game.word[hangman_index++]);
+      break;
+
+    default:
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Passes a cell entered by the player to the game. A cell with no
+ *        dots reads the word out again.
+ * @param cell - char, cell pattern
+ * @return Void
+ */
+void hangman_input_cell(char cell)
+{
+  hangman_cell = cell;
+  hangman_cell_ready = true;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file hangman.h
+ * @brief Hangman game shared by mode 4 (one player) and mode 5 (two players)
+ */
+
+#ifndef _HANGMAN_H_
+#define _HANGMAN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HANGMAN_MAX_LENGTH 10           // Must fit the bits of a uint16_t
+#define HANGMAN_MAX_MISTAKES 7
+#define HANGMAN_LETTERS 26
+
+// Results of hangman_guess()
+#define HANGMAN_HIT     0
+#define HANGMAN_MISS    1
+#define HANGMAN_INVALID 2               // Not a letter; counts as a mistake
+#define HANGMAN_REPEAT  3               // Guessed before; never a mistake
+
+// Turn states of hangman_main()
+#define HANGMAN_STATE_SAY_STATUS    0   // Read out the letters found so far
+#define HANGMAN_STATE_SAY_MISTAKES  1   // Read out the number of mistakes
+#define HANGMAN_STATE_ASK_FOR_GUESS 2   // Prompt for a letter
+#define HANGMAN_STATE_WAIT_INPUT    3   // Waiting for hangman_input_cell()
+#define HANGMAN_STATE_EVALUATE      4   // Check for a win or a loss
+#define HANGMAN_STATE_READ_WORD     5   // Spell out the word, game over
+#define HANGMAN_STATE_DONE          6
+
+typedef struct hangman {
+  char word[HANGMAN_MAX_LENGTH + 1];
+  uint8_t length;
+  uint8_t mistakes;
+  uint32_t guessed;                     // Bit n: letter 'a' + n was guessed
+  uint16_t positions[HANGMAN_LETTERS];  // Bit i: word[i] is letter 'a' + n
+  uint16_t revealed;                    // Bit i: word[i] was guessed
+} hangman_t;
+
+bool hangman_set_word(hangman_t* game, const char* word,
+  bool check_dictionary);
+uint8_t hangman_guess(hangman_t* game, char letter);
+bool hangman_won(const hangman_t* game);
+bool hangman_lost(const hangman_t* game);
+bool hangman_is_revealed(const hangman_t* game, uint8_t position);
+
+bool hangman_start(const char* word, bool check_dictionary,
+  char* mode_fileset, char* lang_fileset);
+bool hangman_main(void);
+void hangman_input_cell(char cell);
+
+#endif /* _HANGMAN_H_ */
@@ -9,6 +9,8 @@
 #include "globals.h"
 #include "audio.h"
 #include "script_common.h"
+#include "script_digits.h"
+#include "backtranslate.h"
 
 #include <stdbool.h>
 
@@ -19,15 +21,23 @@
 // Public IO variables
 char io_dot = NO_DOTS;
 char io_cell = NO_DOTS;
-char io_line[MAX_BUF_SIZE] = "";
-glyph_t* io_parsed[MAX_BUF_SIZE] = {NULL};
+char io_line[MAX_LINE_SIZE] = "";
+unsigned char io_parsed[MAX_LINE_SIZE] = {IO_PARSED_END};
 bool io_user_cancel = false;
 bool io_user_abort = false;
+// Set when get_dot() finds no input, so the scheduler knows the current mode
+// is idle until the next packet from the UI board
+bool io_waiting_for_input = false;
 
 // Basic IO state variables
 static char io_cell_state = NO_DOTS;
 static unsigned int io_line_cell_index = 0;
 static bool io_line_ready = false;
+// Cells written so far, and how many of them do not parse
+static unsigned int io_line_length = 0;
+static unsigned int io_line_errors = 0;
+// Cells of io_line passed to backtranslate_cell() by get_word()
+static unsigned int io_word_cells = 0;
 
 // Advanced IO state variables
 // Dialog state variables
@@ -47,9 +57,12 @@ void io_line_next_cell(void);
 void io_line_prev_cell(void);
 void io_line_clear_cell(void);
 void io_line_reset(void);
+void io_line_commit(int index);
 
 // Intermediate IO helper functions
-bool io_convert_line(void);
+unsigned char io_glyph_code(const glyph_t* glyph);
+void io_parsed_set(int index, unsigned char code);
+void io_line_parse(int first, int last);
 bool io_parse_number(int* res);
 
 // Advanced IO helper functions
@@ -82,12 +95,27 @@ void io_init(void) {
 * @return char - Current dot
 */
 char get_dot(void) {
+	if (io_dot == NO_DOTS) {
+		io_waiting_for_input = true;
+	}
 	play_dot(io_dot);
 	char ret_val = io_dot;
 	io_dot = NO_DOTS;
 	return ret_val;
 }
 
+/**
+* @brief Tells the scheduler the current mode has nothing to do until the next
+*	packet from the UI board or the end of the playlist. get_dot() does this
+*	itself; states that wait for the mode's input_dot or input_cell handler
+*	call it instead.
+* @param void
+* @return void
+*/
+void wait_for_input(void) {
+	io_waiting_for_input = true;
+}
+
 /**
 *	@brief Gets current cell
 * @param void
@@ -168,7 +196,8 @@ char get_cell(void) {
 }
 
 /**
-* @brief Gets a line of raw cells from the user
+* @brief Gets a line of raw cells from the user. Each cell is parsed into
+*	io_parsed as soon as it is written, so the line is ready to use on ENTER.
 * @param void
 * @return bool - true if io_line is ready for further processing, false
 * otherwise
@@ -191,15 +220,16 @@ bool get_line(void) {
 		return false;
 	}
 
-	// Otherwise, if cell was recorded, save it to io_line
+	// Otherwise, if cell was recorded, save it to io_line and parse it
 	if (pattern) {
 		io_line[io_line_cell_index] = pattern;
+		io_line_commit(io_line_cell_index);
 	}
 	switch (control) {
-		// ENTER - Advance cell, add EOT and return true
-		case 0b11:
-			io_line_next_cell();
-			io_line[io_line_cell_index] = END_OF_TEXT;
+		// ENTER - Add EOT after the last cell written and return true
+		case WITH_ENTER:
+			io_line[io_line_length] = END_OF_TEXT;
+			io_parsed[io_line_length] = IO_PARSED_END;
 			io_line_ready = false;
 			return true;
 			break;
@@ -207,7 +237,7 @@ bool get_line(void) {
 		/* RIGHT is used to switch to previous cell because Brialle is entered
 			this way */
 		// RIGHT - Select prev cell
-		case 0b01:
+		case WITH_RIGHT:
 			play_mp3(lang_fileset, MP3_PREV_CELL);
 			io_line_prev_cell();
 			if (!pattern) {
@@ -219,7 +249,7 @@ bool get_line(void) {
 		/* RIGHT is used to switch to next cell because Brialle is entered
 			this way */
 		// LEFT - Select next cell
-		case 0b10:
+		case WITH_LEFT:
 			play_mp3(lang_fileset, MP3_NEXT_CELL);
 			io_line_next_cell();
 			if (!pattern) {
@@ -229,7 +259,7 @@ bool get_line(void) {
 			break;
 
 		// CANCEL - Clear current cell
-		case 0b00:
+		case WITH_CANCEL:
 			io_line_clear_cell();
 			return false;
 			break;
@@ -262,7 +292,7 @@ bool get_number(bool* valid, int* res) {
 	}
 
 	// If cell sequence has invalid patterns, return false
-	if (!io_convert_line()) {
+	if (io_line_errors > 0) {
 		play_mp3(lang_fileset, MP3_INVALID_PATTERN);
 		*valid = false;
 		return true;
@@ -284,7 +314,8 @@ bool get_number(bool* valid, int* res) {
 * @param glyph_t* res - Pointer to placeholder for pointer
 * @return bool - true if ready for further processing
 */
-bool get_character(glyph_t** res) {
+bool get_character(const glyph_t** res) {
+	char sound[GLYPH_SOUND_SIZE];
 	
 	// Let user finish input
 	if (!get_line()) {
@@ -297,19 +328,88 @@ bool get_character(glyph_t** res) {
 	If conversion is unsuccessful, return NULL, otherwise return first
 	character
 	*/
-	if (!io_convert_line()) {
+	if (io_line_errors > 0 || io_line_length == 0) {
 		PRINTF("[IO] Line conversion unsuccessful\n\r");
 		play_mp3(lang_fileset, MP3_INVALID_PATTERN);
 		*res = NULL;
 		return true;
 	} else {
-		*res = io_parsed[0];
-		sprintf(dbgstr, "[IO] Returning character: %s\n\r", (*res)->sound);
+		int index = 0;
+		*res = get_parsed_glyph(&index);
+		glyph_sound(*res, sound);
+		sprintf(dbgstr, "[IO] Returning character: %s\n\r", sound);
 		PRINTF(dbgstr);
 		return true;
 	}
 }
 
+/**
+* @brief Gets a line of words from the user. Each word is back-translated as
+*	soon as the blank cell after it is written, so a mode can check it without
+*	waiting for ENTER.
+* @param char grade - TRANSLATE_GRADE_1 or TRANSLATE_GRADE_2
+* @param char* res - Set to the backtranslate_cell() result for the word just
+*	finished, BACKTRANSLATE_PENDING if none was; backtranslate_word() has its
+*	text
+* @return bool - true once ENTER ends the line
+*/
+bool get_word(char grade, char* res) {
+	bool line_done = get_line();
+	// Cells before the one being written are finished; skipped cells are blank
+	unsigned int last = line_done ? io_line_length : io_line_cell_index;
+	char result;
+
+	*res = BACKTRANSLATE_PENDING;
+	if (io_word_cells == 0) {
+		backtranslate_reset(grade);
+	}
+	while (io_word_cells < last) {
+		result = backtranslate_cell(io_line[io_word_cells++]);
+		if (result != BACKTRANSLATE_PENDING) {
+			*res = result;
+		}
+	}
+	if (line_done) {
+		result = backtranslate_cell(END_OF_TEXT);
+		if (result != BACKTRANSLATE_PENDING) {
+			*res = result;
+		}
+	}
+	return line_done;
+}
+
+/**
+* @brief Gets the glyph starting at a cell of the last line
+* @param int* index - Cell the glyph starts at, set to its last cell
+* @return const glyph_t* - Glyph, NULL at the end of the line or if the cell
+*	does not parse
+*/
+const glyph_t* get_parsed_glyph(int* index) {
+	int last = *index;
+	unsigned char code;
+
+	while (last < MAX_LINE_SIZE && io_parsed[last] == IO_PARSED_PREFIX) {
+		last++;
+	}
+	if (last == MAX_LINE_SIZE) {
+		return NULL;
+	}
+	*index = last;
+
+	code = io_parsed[last];
+	switch (code) {
+		case IO_PARSED_END: case IO_PARSED_INVALID:
+			return NULL;
+		case IO_PARSED_BLANK:
+			return &blank_cell;
+		default:
+			if (code & IO_PARSED_DIGITS) {
+				return &(script_digits.glyphs[(code & ~IO_PARSED_DIGITS) - 1]);
+			}
+			return &(lang_script->glyphs[code - 1]);
+	}
+}
+
 // ********************************
 // ********* Advanced IO **********
 // ********************************
@@ -400,7 +500,7 @@ char create_dialog(char* prompt, char control_mask) {
 */
 void io_line_next_cell(void) {
 	// Next cell only if not at end of buffer (saves space for EOT)
-	if (io_line_cell_index + 2 < MAX_BUF_SIZE) {
+	if (io_line_cell_index + 2 < MAX_LINE_SIZE) {
 		io_line_cell_index++;
 	} else {
 		play_mp3(lang_fileset, MP3_LAST_CELL);
@@ -428,6 +528,9 @@ void io_line_prev_cell(void) {
 */
 void io_line_clear_cell(void) {
 	io_line[io_line_cell_index] = NO_DOTS;
+	if (io_line_cell_index < io_line_length) {
+		io_line_commit(io_line_cell_index);
+	}
 }
 
 /**
@@ -436,67 +539,133 @@ void io_line_clear_cell(void) {
 * @return void
 */
 void io_line_reset(void) {
-	for (int i = 0; i < MAX_BUF_SIZE; i++) {
+	for (int i = 0; i < MAX_LINE_SIZE; i++) {
 		io_line[i] = NO_DOTS;
+		io_parsed[i] = IO_PARSED_END;
 	}
 	io_line_cell_index = 0;
+	io_line_length = 0;
+	io_line_errors = 0;
+	io_word_cells = 0;
 	io_line_ready = true;
 }
 
+/**
+* @brief Adds a written or changed cell to the line and parses it. Blank cells
+*	skipped over with LEFT become part of the line too. Changing a cell that
+*	get_word() has already back-translated makes it start the line over.
+* @param int index - Cell that changed
+* @return void
+*/
+void io_line_commit(int index) {
+	int first = index;
+
+	if (index < io_word_cells) {
+		io_word_cells = 0;
+	}
+
+	if (index >= io_line_length) {
+		first = io_line_length;
+		io_line_length = index + 1;
+	}
+	io_line_parse(first, index);
+}
+
 // ******************************************************
 // ********** Intermediate IO helper functions **********
 // ******************************************************
 
 
 /**
-* @brief Converts raw cell patterns from io_line to glyphs in io_parsed
-* @param void
-* @return bool - true if all raw cells were valid, false otherwise
+* @brief Encodes a glyph returned by get_glyph() for io_parsed
+* @param const glyph_t* glyph - Glyph from lang_script or script_digits
+* @return unsigned char - io_parsed code
 */
-bool io_convert_line(void) {
-	int line_index = 0;
-	int parse_index = 0;
-	glyph_t* curr_glyph = NULL;
-	
-	// Iterate through io_line, find matching glyph for each cell pattern as long
-	// as it isn't END_OF_TEXT, and add to io_parsed
-	for (line_index = 0, parse_index = 0;
-		line_index - 2 < MAX_BUF_SIZE;
-		line_index++, parse_index++) {
-		
-		if (io_line[line_index] == END_OF_TEXT) {
-			break;
-		}
-		
-		curr_glyph = get_glyph(lang_script, io_line, &line_index);
-		if (curr_glyph == NULL) {
-			return false;
-		} else {
-			sprintf(dbgstr, "[IO] Parsed glyph: %s\n\r", curr_glyph->sound);
-			PRINTF(dbgstr);
-			io_parsed[parse_index] = curr_glyph;
-		}
+unsigned char io_glyph_code(const glyph_t* glyph) {
+	if (is_blank(glyph)) {
+		return IO_PARSED_BLANK;
 	}
+	if (glyph >= lang_script->glyphs &&
+		glyph < lang_script->glyphs + lang_script->length) {
+		return (glyph - lang_script->glyphs) + 1;
+	}
+	return IO_PARSED_DIGITS | ((glyph - script_digits.glyphs) + 1);
+}
 
-	// If control returns from loop then matching glyphs were found for all
-	// raw cells, add a NULL terminator and return true
-	io_parsed[line_index] = NULL;
-	return true;
+/**
+* @brief Sets a cell's io_parsed code, keeping count of cells that do not parse
+* @param int index - Cell to set
+* @param unsigned char code - New code
+* @return void
+*/
+void io_parsed_set(int index, unsigned char code) {
+	if (io_parsed[index] == IO_PARSED_INVALID) {
+		io_line_errors--;
+	}
+	if (code == IO_PARSED_INVALID) {
+		io_line_errors++;
+	}
+	io_parsed[index] = code;
 }
 
 /**
-* @brief Parses io_line buffer for a number and stores it in io_parsed
-* @param void
+* @brief Re-parses the glyphs covering cells first to last. Parsing starts at
+*	the first cell of the glyph holding cell first - a cell that did not parse
+*	may be a prefix completed by a later cell - and goes on past cell last
+*	until a glyph ends where one ended before, since everything after that is
+*	unchanged. This keeps each edit down to a few cells.
+* @param int first - First changed cell
+* @param int last - Last changed cell
 * @return void
 */
+void io_line_parse(int first, int last) {
+	const glyph_t* curr_glyph;
+	unsigned char old_code;
+	int start = first;
+	int end;
+
+	while (start > 0 && (io_parsed[start - 1] == IO_PARSED_PREFIX ||
+		io_parsed[start - 1] == IO_PARSED_INVALID)) {
+		start--;
+	}
+
+	while (start < io_line_length) {
+		end = start;
+		curr_glyph = get_glyph(lang_script, io_line, &end);
+		if (curr_glyph == NULL) {
+			end = start;
+		}
+
+		for (int i = start; i < end; i++) {
+			io_parsed_set(i, IO_PARSED_PREFIX);
+		}
+		old_code = io_parsed[end];
+		io_parsed_set(end, curr_glyph == NULL ? IO_PARSED_INVALID :
+			io_glyph_code(curr_glyph));
+
+		start = end + 1;
+		if (end >= last && old_code != IO_PARSED_PREFIX &&
+			old_code != IO_PARSED_END) {
+			break;
+		}
+	}
+}
+
+/**
+* @brief Parses the glyphs in io_parsed, after the number sign, as a number
+* @param int* res - Address to put resultant integer
+* @return bool - true if every glyph up to the first blank is a digit
+*/
 bool io_parse_number(int* res) {
-	glyph_t* curr_glyph = NULL;
+	const glyph_t* curr_glyph = NULL;
 	int i = 0, curr_digit = 0;
 
 	*res = 0;
 
-	for (i = 1; io_parsed[i] != NULL && is_blank(io_parsed[i]) == false; i++) {
-		curr_glyph = io_parsed[i];
+	// Skip the number sign
+	get_parsed_glyph(&i);
+	for (i++; (curr_glyph = get_parsed_glyph(&i)) != NULL &&
+		is_blank(curr_glyph) == false; i++) {
 		curr_digit = get_digit(curr_glyph);
 		if (curr_digit < 0) {
 			return false;
@@ -505,7 +674,6 @@ bool io_parse_number(int* res) {
 			*res += curr_digit; 
 		}
 	}
-	io_parsed[i] = NULL;
 	return true;
 }
 
@@ -12,6 +12,7 @@
 // General constants
 #define MAX_INCORRECT_TRIES 3
 #define MAX_BUF_SIZE 				256
+#define MAX_LINE_SIZE				64
 #define GET_CELL_CONTROL(c) (c & 0b11000000)
 #define GET_CELL_PATTERN(c) (c & 0b00111111)
 
@@ -41,22 +42,35 @@
 #define DOT_5								0b00010000
 #define DOT_6								0b00100000
 
+// io_parsed holds one byte per cell of io_line: the glyph that ends in that
+// cell as its position in lang_script (from 1) or, with IO_PARSED_DIGITS set,
+// in script_digits
+#define IO_PARSED_END				0x00	// Past the end of the line
+#define IO_PARSED_DIGITS		0x80
+#define IO_PARSED_BLANK			0xFD
+#define IO_PARSED_PREFIX		0xFE	// Not the last cell of a multi-cell glyph
+#define IO_PARSED_INVALID		0xFF
+
 // UI public variables
 extern char io_dot;
 extern char io_cell;
-extern char io_line[MAX_BUF_SIZE];
-extern glyph_t* io_parsed[MAX_BUF_SIZE];
+extern char io_line[MAX_LINE_SIZE];
+extern unsigned char io_parsed[MAX_LINE_SIZE];
 extern bool io_user_abort;
+extern bool io_waiting_for_input;
 
 // Basic IO functions
 void io_init(void);
 char get_dot(void);
+void wait_for_input(void);
 char get_cell(void);
 bool get_line(void);
 
 // Intermediate IO functions
 bool get_number(bool* valid, int* res);
-bool get_character(glyph_t** res);
+bool get_character(const glyph_t** res);
+bool get_word(char grade, char* res);
+const glyph_t* get_parsed_glyph(int* index);
 bool parse_letter(void);
 bool parse_digit(void);
 bool parse_symbol(void);
@@ -18,6 +18,10 @@
 #include "common.h"
 #include "debug.h"
 #include "script_common.h"
+#include "userlog.h"
+#include "user.h"
+#include "review.h"
+#include "UI_Handle.h"
 #include "learn_letter_mode.h"
 
 // State variables
@@ -26,8 +30,8 @@ static char next_state = STATE_NULL;
 static char user_response = NO_DOTS;
 static char submode = SUBMODE_NULL;
 static int index = 0;
-static glyph_t* curr_glyph = NULL;
-static glyph_t* user_glyph = NULL;
+static const glyph_t* curr_glyph = NULL;
+static const glyph_t* user_glyph = NULL;
 static char cell = 0;
 static char cell_pattern = 0;
 static char cell_control = 0;
@@ -53,7 +57,30 @@ void learn_letter_reset(script_t* new_script, char* new_lang_fileset, char* new_
 	PRINTF(dbgstr);
 }
 
+/**
+* @brief Starts Learn at the first letter the current user has not mastered,
+*	or at the first letter once they have mastered them all
+* @param script_t* SCRIPT_ADDRESS - Script of the mode
+* @return void
+*/
+static void learn_letter_resume(script_t* SCRIPT_ADDRESS) {
+	const glyph_t* glyph;
+
+	reset_script_indices(SCRIPT_ADDRESS);
+	while ((glyph = get_next_glyph(SCRIPT_ADDRESS)) != NULL) {
+		if (!user_mastered(ui_current_mode_number,
+			glyph - SCRIPT_ADDRESS->glyphs)) {
+			// Step back so that STATE_GENQUES asks this letter first
+			SCRIPT_ADDRESS->index--;
+			return;
+		}
+	}
+	reset_script_indices(SCRIPT_ADDRESS);
+}
+
 void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FILESET) {
+	char sound[GLYPH_SOUND_SIZE];
+
 	switch (next_state) {
 		case STATE_MENU:
 		switch(create_dialog(MP3_MENU, DOT_1 | DOT_2 | ENTER_CANCEL)) {
@@ -66,6 +93,7 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 				PRINTF(dbgstr);			
 				play_mp3(MODE_FILESET, MP3_INSTRUCTIONS);
 				submode = SUBMODE_LEARN;
+				learn_letter_resume(SCRIPT_ADDRESS);
 				next_state = STATE_GENQUES;
 				break;
 
@@ -74,6 +102,7 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 				PRINTF(dbgstr);
 				play_mp3(MODE_FILESET, MP3_INSTRUCTIONS);
 				submode = SUBMODE_PLAY;
+				review_init(SCRIPT_ADDRESS, ui_current_mode_number);
 				next_state = STATE_GENQUES;
 				break;
 
@@ -108,14 +137,18 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 				break;
 
 			case SUBMODE_PLAY:
-				curr_glyph = get_random_glyph(SCRIPT_ADDRESS);
+				curr_glyph = review_next();
+				if (curr_glyph == NULL) {
+					curr_glyph = get_random_glyph(SCRIPT_ADDRESS);
+				}
 				break;
 
 			default:
 				break;
 
 		}
-		sprintf(dbgstr, "[%s] Next glyph: %s\n\r",mode_name, curr_glyph->sound);
+		glyph_sound(curr_glyph, sound);
+		sprintf(dbgstr, "[%s] Next glyph: %s\n\r",mode_name, sound);
 		PRINTF(dbgstr);
 		play_mp3(LANG_FILESET, MP3_NEXT_LETTER);
 		next_state = STATE_PROMPT;
@@ -138,6 +171,7 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 			default:
 			break;
 		}
+		userlog_prompt();
 		next_state = STATE_INPUT;
 		break;
 
@@ -174,10 +208,16 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 
 		case STATE_CHECK:
 		if (glyph_equals(curr_glyph, user_glyph)) {
-			if(curr_glyph -> next == NULL) {
+			if(glyph_next(curr_glyph) == NULL) {
+				if (incorrect_tries == 0) {
+					user_set_mastered(ui_current_mode_number,
+						get_root(SCRIPT_ADDRESS, curr_glyph) - SCRIPT_ADDRESS->glyphs);
+				}
 				incorrect_tries = 0;
 				sprintf(dbgstr, "[%s] User answered correctly\n\r", mode_name);
 				PRINTF(dbgstr);
+				userlog_record(glyph_pattern(curr_glyph), USERLOG_CORRECT);
+				review_answer(curr_glyph, USERLOG_CORRECT);
 				play_mp3(LANG_FILESET, MP3_CORRECT);
 				play_mp3(SYS_FILESET, MP3_TADA);
 				next_state = STATE_GENQUES;
@@ -190,7 +230,9 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 			} else {
 			incorrect_tries++;
 			sprintf(dbgstr, "[%s] User answered incorrectly\n\r", mode_name);;
-			PRINTF(dbgstr);			
+			PRINTF(dbgstr);
+			userlog_record(glyph_pattern(curr_glyph), USERLOG_INCORRECT);
+			review_answer(curr_glyph, USERLOG_INCORRECT);
 			play_mp3(LANG_FILESET, MP3_INCORRECT);
 			play_mp3(LANG_FILESET, MP3_TRY_AGAIN);
 			curr_glyph = get_root(SCRIPT_ADDRESS, curr_glyph);
@@ -220,6 +262,10 @@ void learn_letter_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_
 			case ENTER:
 			sprintf(dbgstr, "[%s] Skipping character\n\r", mode_name);
 			PRINTF(dbgstr);
+			if (!scrolled) {
+				userlog_record(glyph_pattern(curr_glyph), USERLOG_SKIPPED);
+				review_answer(curr_glyph, USERLOG_SKIPPED);
+			}
 			if (scrolled)
 			next_state = STATE_PROMPT;
 			else
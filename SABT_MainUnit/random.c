@@ -0,0 +1,114 @@
+/**
+ * @file random.c
+ * @brief Pseudo-random numbers for the modes. A 32-bit xorshift generator is
+ *        seeded at power on from ADC noise and the time the SD card took to
+ *        start, and stirred with the timer whenever the user presses a key,
+ *        so every call gives a fresh number without waiting on the timer.
+ */
+
+#include "Globals.h"
+#include "random.h"
+
+// Any value but 0, which xorshift never leaves
+static uint32_t random_state = 2463534242UL;
+
+/**
+ * @brief Mixes a value into the state and steps the generator once
+ * @param value - uint32_t, value to mix in
+ * @return Void
+ */
+static void random_mix(uint32_t value)
+{
+  random_state = (random_state ^ value) * 2654435761UL;
+  if(random_state == 0)
+  {
+    random_state = 2463534242UL;
+  }
+  random_next();
+}
+
+/**
+ * @brief Seeds the generator. Call once at power on, after the SD card has
+ *        started. Leaves the ADC off.
+ * @return Void
+ */
+void random_seed(void)
+{
+  uint32_t noise = 0;
+  uint8_t i;
+
+  // Internal 1.1V bandgap against AVcc, ADC clock 8MHz / 64
+  PRR0 &= ~_BV(PRADC);
+  ADMUX = _BV(REFS0) | 0x1E;
+  ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1);
+
+  for(i = 0; i < RANDOM_SEED_SAMPLES; i++)
+  {
+    ADCSRA |= _BV(ADSC);
+    while(ADCSRA & _BV(ADSC))
+    {
+    }
+    noise = (noise << 1 | noise >> 31) ^ ADC;
+  }
+
+  ADCSRA = 0;
+  PRR0 |= _BV(PRADC);
+
+  random_mix(noise);
+  random_mix(TCNT1);
+}
+
+/**
+ * @brief Mixes the timer into the generator. Call on events whose timing
+ *        comes from the user, such as key presses.
+ * @return Void
+ */
+void random_stir(void)
+{
+  random_mix(TCNT1);
+}
+
+/**
+ * @brief Next number from the generator
+ * @return uint16_t - 0 to 65535
+ */
+uint16_t random_next(void)
+{
+  uint32_t x = random_state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  random_state = x;
+  return x >> 16;
+}
+
+/**
+ * @brief Number in a range, from one step of the generator. The bias is
+ *        below limit / 65536.
+ * @param limit - uint16_t, one more than the largest number wanted
+ * @return uint16_t - 0 to limit - 1, 0 if limit is 0
+ */
+uint16_t random_below(uint16_t limit)
+{
+  return ((uint32_t) random_next() * limit) >> 16;
+}
+
+/**
+ * @brief Puts items in random order (Fisher-Yates), one draw per item
+ * @param items - uint8_t*, items to shuffle
+ * @param count - uint8_t, number of items
+ * @return Void
+ */
+void random_shuffle(uint8_t* items, uint8_t count)
+{
+  uint8_t i, j, item;
+
+  for(i = count; i > 1; i--)
+  {
+    j = random_below(i);
+    item = items[i - 1];
+    items[i - 1] = items[j];
+    items[j] = item;
+  }
+}
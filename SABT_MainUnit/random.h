@@ -0,0 +1,22 @@
+/**
+ * @file random.h
+ * @brief Pseudo-random numbers for the modes, from a seeded xorshift
+ *        generator
+ */
+
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <stdint.h>
+
+// ADC conversions of the internal bandgap mixed into the seed at power on;
+// only their lowest bit is noisy
+#define RANDOM_SEED_SAMPLES 64
+
+void random_seed(void);
+void random_stir(void);
+uint16_t random_next(void);
+uint16_t random_below(uint16_t limit);
+void random_shuffle(uint8_t* items, uint8_t count);
+
+#endif /* _RANDOM_H_ */
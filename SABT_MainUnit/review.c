@@ -0,0 +1,241 @@
+/**
+ * @file review.c
+ * @brief Spaced repetition of the glyphs of a script. The glyphs are kept in
+ *        a binary min-heap ordered by the question they are next due at, so
+ *        picking the next one and putting it back both take O(log n); ties go
+ *        to the weaker glyph. There is no clock that survives power off, so
+ *        intervals count questions and only the strengths are saved.
+ */
+
+#include "Globals.h"
+#include "script_common.h"
+#include "review.h"
+
+#define REVIEW_UNANSWERED 0xFF
+
+// Questions before a glyph comes back, by strength
+static const uint8_t review_intervals[REVIEW_MAX_STRENGTH + 1] PROGMEM = {
+  3, 5, 8, 13, 21, 34, 55, 89
+};
+
+static script_t* review_script = NULL;
+static unsigned char review_mode;
+static review_item_t review_heap[REVIEW_MAX_ITEMS];
+static uint8_t review_count = 0;
+static review_item_t review_current;
+static bool review_holding = false;
+static uint16_t review_step;
+
+/**
+ * @brief Whether item a should be asked before item b
+ * @param a - const review_item_t*, first item
+ * @param b - const review_item_t*, second item
+ * @return bool - true if a comes first
+ */
+static bool review_before(const review_item_t* a, const review_item_t* b)
+{
+  // Signed difference, so the order holds when the question count wraps
+  int16_t diff = (int16_t)(a->due - b->due);
+
+  if(diff != 0)
+  {
+    return diff < 0;
+  }
+  return a->strength < b->strength;
+}
+
+/**
+ * @brief Adds an item to the heap
+ * @param item - const review_item_t*, item to add
+ * @return Void
+ */
+static void review_push(const review_item_t* item)
+{
+  uint8_t i = review_count++;
+  uint8_t parent;
+
+  while(i > 0)
+  {
+    parent = (i - 1) / 2;
+    if(!review_before(item, &review_heap[parent]))
+    {
+      break;
+    }
+    review_heap[i] = review_heap[parent];
+    i = parent;
+  }
+  review_heap[i] = *item;
+}
+
+/**
+ * @brief Takes the first item off the heap. The heap must not be empty.
+ * @param item - review_item_t*, set to the item taken
+ * @return Void
+ */
+static void review_pop(review_item_t* item)
+{
+  review_item_t last;
+  uint8_t i = 0;
+  uint8_t child;
+
+  *item = review_heap[0];
+  last = review_heap[--review_count];
+
+  while((child = 2 * i + 1) < review_count)
+  {
+    if(child + 1 < review_count &&
+      review_before(&review_heap[child + 1], &review_heap[child]))
+    {
+      child++;
+    }
+    if(!review_before(&review_heap[child], &last))
+    {
+      break;
+    }
+    review_heap[i] = review_heap[child];
+    i = child;
+  }
+  review_heap[i] = last;
+}
+
+/**
+ * @brief Questions before an item of this strength comes back
+ * @param strength - uint8_t, 0 to REVIEW_MAX_STRENGTH
+ * @return uint8_t - interval
+ */
+static uint8_t review_interval(uint8_t strength)
+{
+  return pgm_read_byte(&review_intervals[strength]);
+}
+
+/**
+ * @brief Puts the item asked last back on the heap, with its strength
+ *        updated from the answers given and saved for the user
+ * @return Void
+ */
+static void review_release(void)
+{
+  review_item_t* item = &review_current;
+
+  if(!review_holding)
+  {
+    return;
+  }
+  review_holding = false;
+
+  switch(item->result)
+  {
+    case USERLOG_CORRECT:
+      if(item->strength < REVIEW_MAX_STRENGTH)
+      {
+        item->strength++;
+      }
+      break;
+
+    case USERLOG_INCORRECT:
+      item->strength = 0;
+      break;
+
+    case USERLOG_SKIPPED:
+      if(item->strength > 0)
+      {
+        item->strength--;
+      }
+      break;
+
+    default:
+      break;
+  }
+  user_set_strength(review_mode, item->glyph, item->strength);
+
+  item->due = review_step + review_interval(item->strength);
+  item->result = REVIEW_UNANSWERED;
+  review_push(item);
+}
+
+/**
+ * @brief Loads the root glyphs of a script with the current user's strengths.
+ *        Weak glyphs are due first.
+ * @param script - script_t*, script to practise
+ * @param mode - unsigned char, mode number the strengths are saved under
+ * @return Void
+ */
+void review_init(script_t* script, unsigned char mode)
+{
+  review_item_t item;
+  int i;
+
+  review_script = script;
+  review_mode = mode;
+  review_count = 0;
+  review_holding = false;
+  review_step = 0;
+
+  for(i = 0; i < script->length && i < REVIEW_MAX_ITEMS; i++)
+  {
+    if(glyph_prev(&script->glyphs[i]) != NULL)
+    {
+      continue;
+    }
+    item.glyph = i;
+    item.strength = user_strength(mode, i);
+    if(item.strength > REVIEW_MAX_STRENGTH)
+    {
+      item.strength = REVIEW_MAX_STRENGTH;
+    }
+    item.result = REVIEW_UNANSWERED;
+    item.due = review_interval(item.strength) - review_interval(0) +
+      random_below(REVIEW_JITTER);
+    review_push(&item);
+  }
+
+  sprintf(dbgstr, "[Review] %u glyphs for mode %u\n\r", review_count, mode);
+  PRINTF(dbgstr);
+}
+
+/**
+ * @brief Picks the glyph to ask next: the one most overdue, or the one due
+ *        soonest if none is due yet
+ * @return const glyph_t* - glyph, NULL if review_init() found no glyphs
+ */
+const glyph_t* review_next(void)
+{
+  review_release();
+  if(review_count == 0)
+  {
+    return NULL;
+  }
+
+  review_pop(&review_current);
+  review_holding = true;
+  review_step++;
+
+  sprintf(dbgstr, "[Review] Glyph %u strength %u\n\r", review_current.glyph,
+    review_current.strength);
+  PRINTF(dbgstr);
+  return &review_script->glyphs[review_current.glyph];
+}
+
+/**
+ * @brief Notes an answer to the glyph asked last. The worst answer counts
+ *        when the glyph goes back on the heap at the next review_next().
+ * @param glyph - const glyph_t*, glyph answered, any cell of it
+ * @param result - unsigned char, USERLOG_CORRECT, _INCORRECT or _SKIPPED
+ * @return Void
+ */
+void review_answer(const glyph_t* glyph, unsigned char result)
+{
+  if(!review_holding || glyph == NULL ||
+    get_root(review_script, glyph) !=
+    &review_script->glyphs[review_current.glyph])
+  {
+    return;
+  }
+
+  if(review_current.result == REVIEW_UNANSWERED ||
+    review_current.result == USERLOG_CORRECT ||
+    result == USERLOG_INCORRECT)
+  {
+    review_current.result = result;
+  }
+}
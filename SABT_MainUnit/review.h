@@ -0,0 +1,31 @@
+/**
+ * @file review.h
+ * @brief Spaced repetition of the glyphs of a script: the glyphs a learner
+ *        gets wrong come back soon, the ones they know come back rarely
+ */
+
+#ifndef _REVIEW_H_
+#define _REVIEW_H_
+
+#include <stdint.h>
+#include "glyph.h"
+
+// Strength goes up by one for each right answer and back to 0 for a wrong
+// one; it picks how many questions go by before the glyph is asked again.
+// Strengths are saved per user (user.h), 4 bits each.
+#define REVIEW_MAX_STRENGTH 7
+#define REVIEW_MAX_ITEMS 64             // Same as USER_MAX_GLYPHS
+#define REVIEW_JITTER 4                 // Spreads out glyphs of equal strength
+
+typedef struct review_item {
+  uint8_t glyph;                        // Position of the glyph in the script
+  uint8_t strength;
+  uint8_t result;                       // Worst answer so far, USERLOG_*
+  uint16_t due;                         // Question number it is due at
+} review_item_t;
+
+void review_init(script_t* script, unsigned char mode);
+const glyph_t* review_next(void);
+void review_answer(const glyph_t* glyph, unsigned char result);
+
+#endif /* _REVIEW_H_ */
@@ -0,0 +1,93 @@
+/**
+ * @file rx_buffer.c
+ * @brief Single-producer/single-consumer receive ring buffer shared between
+ *        a USART RX interrupt and the main loop
+ */
+
+#include <util/atomic.h>
+#include "Globals.h"
+#include "rx_buffer.h"
+
+/**
+ * @brief Empties the buffer and clears its overflow counter
+ * @param buf - rx_buffer_t*, buffer to reset
+ * @return Void
+ */
+void rx_buffer_init(rx_buffer_t* buf)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    buf->head = 0;
+    buf->tail = 0;
+    buf->overflows = 0;
+  }
+}
+
+/**
+ * @brief Stores a received byte. Only called from the RX interrupt.
+ *        When the buffer is full the byte is dropped and counted.
+ * @param buf - rx_buffer_t*, buffer to store into
+ * @param data - unsigned char, received byte
+ * @return bool - true if the byte was stored
+ */
+bool rx_buffer_put(rx_buffer_t* buf, unsigned char data)
+{
+  uint8_t head = buf->head;
+  uint8_t next = (head + 1) & RX_BUFFER_MASK;
+
+  if (next == buf->tail)
+  {
+    if (buf->overflows != UINT16_MAX)
+      buf->overflows++;
+    return false;
+  }
+
+  buf->data[head] = data;
+  buf->head = next;
+  return true;
+}
+
+/**
+ * @brief Takes the oldest byte out of the buffer. Only called from the main
+ *        loop.
+ * @param buf - rx_buffer_t*, buffer to read from
+ * @param data - unsigned char*, set to the byte read
+ * @return bool - false if the buffer was empty
+ */
+bool rx_buffer_get(rx_buffer_t* buf, unsigned char* data)
+{
+  uint8_t tail = buf->tail;
+
+  if (tail == buf->head)
+    return false;
+
+  *data = buf->data[tail];
+  buf->tail = (tail + 1) & RX_BUFFER_MASK;
+  return true;
+}
+
+/**
+ * @brief Checks whether there are bytes waiting in the buffer
+ * @param buf - rx_buffer_t*, buffer to check
+ * @return bool - true if nothing is waiting
+ */
+bool rx_buffer_empty(rx_buffer_t* buf)
+{
+  return buf->head == buf->tail;
+}
+
+/**
+ * @brief Number of bytes dropped because the main loop fell behind
+ * @param buf - rx_buffer_t*, buffer to query
+ * @return uint16_t - overflow count, saturating
+ */
+uint16_t rx_buffer_overflows(rx_buffer_t* buf)
+{
+  uint16_t overflows;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    overflows = buf->overflows;
+  }
+  return overflows;
+}
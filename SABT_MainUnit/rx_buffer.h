@@ -0,0 +1,37 @@
+/**
+ * @file rx_buffer.h
+ * @brief Single-producer/single-consumer receive ring buffer shared between
+ *        a USART RX interrupt and the main loop
+ */
+
+#ifndef _RX_BUFFER_H_
+#define _RX_BUFFER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Must be a power of two so the indices can wrap with a mask. Holds the copies
+// of a 20 byte packet the UI board sends in about two seconds (6, see
+// CommPacket.h) while the main loop is busy.
+#define RX_BUFFER_SIZE 128
+#define RX_BUFFER_MASK (RX_BUFFER_SIZE - 1)
+
+/*
+ * The ISR is the only writer of head and the main loop is the only writer of
+ * tail. Both indices are single bytes, so reads and writes are atomic on the
+ * AVR and no locking is needed to move data through the buffer.
+ */
+typedef struct rx_buffer {
+  volatile uint8_t head;
+  volatile uint8_t tail;
+  volatile uint16_t overflows;
+  volatile unsigned char data[RX_BUFFER_SIZE];
+} rx_buffer_t;
+
+void rx_buffer_init(rx_buffer_t* buf);
+bool rx_buffer_put(rx_buffer_t* buf, unsigned char data);
+bool rx_buffer_get(rx_buffer_t* buf, unsigned char* data);
+bool rx_buffer_empty(rx_buffer_t* buf);
+uint16_t rx_buffer_overflows(rx_buffer_t* buf);
+
+#endif /* _RX_BUFFER_H_ */
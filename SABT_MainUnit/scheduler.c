@@ -0,0 +1,223 @@
+/**
+ * @file scheduler.c
+ * @brief Cooperative event-driven task scheduler for the main loop. Interrupts
+ *        and tasks post events; the highest priority task with a pending event
+ *        runs to completion, and the MCU sleeps when nothing is pending.
+ */
+
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include "Globals.h"
+#include "scheduler.h"
+
+static volatile uint8_t scheduler_events;
+
+// Timer 1 compare matches since reset, and timer 1 ticks spent asleep.
+// Timer 1 runs from the 8MHz clock divided by 1024 (TCCR1B = 0x0D).
+static volatile uint32_t scheduler_timer_periods;
+static uint32_t scheduler_sleep_ticks;
+
+/**
+ * @brief Timer 1 ticks since reset. Call with interrupts disabled.
+ * @return uint32_t - elapsed ticks
+ */
+static uint32_t scheduler_uptime_ticks(void)
+{
+  uint32_t periods = scheduler_timer_periods;
+  uint16_t count = TCNT1;
+
+  // The counter has already wrapped but the compare ISR has not run yet
+  if((TIFR1 & _BV(OCF1A)) && count < (OCR1A >> 1))
+  {
+    periods++;
+  }
+  return periods * (OCR1A + 1UL) + count;
+}
+
+/**
+ * @brief Converts timer 1 ticks (128us each) to milliseconds without
+ *        overflowing 32 bits
+ * @param ticks - uint32_t, timer 1 ticks
+ * @return uint32_t - milliseconds
+ */
+static uint32_t scheduler_ticks_to_ms(uint32_t ticks)
+{
+  return (ticks / 125) * 16 + ((ticks % 125) * 16) / 125;
+}
+
+/**
+ * @brief Clears all pending events and selects the sleep mode used when idle
+ * @return Void
+ */
+void scheduler_init(void)
+{
+  scheduler_events = EVENT_NONE;
+  scheduler_timer_periods = 0;
+  scheduler_sleep_ticks = 0;
+  set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+/**
+ * @brief Marks events as pending. Safe to call from ISRs and the main loop.
+ * @param events - uint8_t, EVENT_* bits to post
+ * @return Void
+ */
+void scheduler_post(uint8_t events)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    scheduler_events |= events;
+  }
+}
+
+/**
+ * @brief Counts a timer 1 compare match and posts EVENT_TIMER. Called from
+ *        the timer 1 ISR.
+ * @return Void
+ */
+void scheduler_timer_tick(void)
+{
+  scheduler_timer_periods++;
+  scheduler_events |= EVENT_TIMER;
+}
+
+/**
+ * @brief Sleeps in idle mode until the next interrupt and adds the time spent
+ *        to the sleep counter. Must be called with interrupts disabled, right
+ *        after checking there is nothing to do, so a wake-up interrupt cannot
+ *        slip in between the check and the sleep. Returns with interrupts
+ *        enabled.
+ * @return Void
+ */
+void scheduler_sleep(void)
+{
+  uint32_t start = scheduler_uptime_ticks();
+
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+
+  cli();
+  scheduler_sleep_ticks += scheduler_uptime_ticks() - start;
+  sei();
+}
+
+/**
+ * @brief Time spent awake and asleep since reset
+ * @param active_ms - uint32_t*, set to milliseconds spent running
+ * @param sleep_ms - uint32_t*, set to milliseconds spent asleep
+ * @return Void
+ */
+void scheduler_power_stats(uint32_t* active_ms, uint32_t* sleep_ms)
+{
+  uint32_t uptime, asleep;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    uptime = scheduler_uptime_ticks();
+    asleep = scheduler_sleep_ticks;
+  }
+  *active_ms = scheduler_ticks_to_ms(uptime - asleep);
+  *sleep_ms = scheduler_ticks_to_ms(asleep);
+}
+
+/**
+ * @brief Time since reset
+ * @return uint32_t - milliseconds
+ */
+uint32_t scheduler_uptime_ms(void)
+{
+  uint32_t uptime;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    uptime = scheduler_uptime_ticks();
+  }
+  return scheduler_ticks_to_ms(uptime);
+}
+
+/**
+ * @brief Idle hook - sleeps unless an event is already pending
+ * @return Void
+ */
+static void scheduler_idle(void)
+{
+  cli();
+  if(scheduler_events == EVENT_NONE)
+  {
+    scheduler_sleep();
+  }
+  sei();
+}
+
+/**
+ * @brief Finds the highest priority task with a pending event
+ * @param tasks - const task_t*, tasks in priority order, highest first
+ * @param first - uint8_t, first entry to look at
+ * @param num_tasks - uint8_t, number of entries in tasks
+ * @param pending - uint8_t, pending events
+ * @return uint8_t - entry of the task, num_tasks if none is pending
+ */
+static uint8_t scheduler_find_task(const task_t* tasks, uint8_t first,
+  uint8_t num_tasks, uint8_t pending)
+{
+  uint8_t i;
+
+  for(i = first; i < num_tasks; i++)
+  {
+    if(pending & tasks[i].events)
+    {
+      break;
+    }
+  }
+  return i;
+}
+
+/**
+ * @brief Runs tasks forever. After each task the search restarts from the top
+ *        of the table, so a higher priority task never waits behind more than
+ *        one lower priority task. A task that finds itself first again, having
+ *        posted its own event, lets the next pending task below it run first,
+ *        so a task that keeps itself busy cannot starve the ones below.
+ * @param tasks - const task_t*, tasks in priority order, highest first
+ * @param num_tasks - uint8_t, number of entries in tasks
+ * @return Void - never returns
+ */
+void scheduler_run(const task_t* tasks, uint8_t num_tasks)
+{
+  uint8_t i;
+  uint8_t lower;
+  uint8_t last = num_tasks;           // Task that ran last, num_tasks if none
+  uint8_t pending;
+
+  while(1)
+  {
+    pending = scheduler_events;
+
+    i = scheduler_find_task(tasks, 0, num_tasks, pending);
+    if(i == last)
+    {
+      lower = scheduler_find_task(tasks, i + 1, num_tasks, pending);
+      if(lower < num_tasks)
+      {
+        i = lower;
+      }
+    }
+
+    if(i == num_tasks)
+    {
+      last = num_tasks;
+      scheduler_idle();
+      continue;
+    }
+
+    // Clear before running so events posted by the task are not lost
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+      scheduler_events &= ~tasks[i].events;
+    }
+    tasks[i].run();
+    last = i;
+  }
+}
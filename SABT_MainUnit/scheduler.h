@@ -0,0 +1,34 @@
+/**
+ * @file scheduler.h
+ * @brief Cooperative event-driven task scheduler for the main loop
+ */
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Events, one bit each. Posting an event that is already pending has no
+// further effect - the task that handles it drains everything in one go.
+#define EVENT_NONE       0x00
+#define EVENT_KEYPAD_RX  0x01    // Byte received from the UI board
+#define EVENT_PC_RX      0x02    // Byte received from the PC
+#define EVENT_TIMER      0x04    // Timer 1 compare match
+#define EVENT_AUDIO      0x08    // MP3 files waiting in the playlist
+#define EVENT_MODE       0x10    // Current mode needs to run its main function
+
+typedef struct task {
+  uint8_t events;                // Events this task handles
+  void (*run)(void);
+} task_t;
+
+void scheduler_init(void);
+void scheduler_post(uint8_t events);
+void scheduler_timer_tick(void);
+void scheduler_sleep(void);
+void scheduler_power_stats(uint32_t* active_ms, uint32_t* sleep_ms);
+uint32_t scheduler_uptime_ms(void);
+void scheduler_run(const task_t* tasks, uint8_t num_tasks);
+
+#endif /* _SCHEDULER_H_ */
@@ -13,18 +13,18 @@
 #include "common.h"
 #include "io.h"
 
-#include <stdlib.h>
+#include <avr/pgmspace.h>
 #include <stdbool.h>
 #include <string.h>
 
 
 script_t* lang_script = NULL;
 
-glyph_t blank_cell = {
+const glyph_t blank_cell PROGMEM = {
 	0x00,
 	MP3_BLANK,
-	NULL,
-	NULL
+	0,
+	0
 };
 
 /**
@@ -37,16 +37,42 @@ void reset_script_indices(script_t* script) {
 }
 
 /**
-* @brief Pattern matches from a string of patterns to a glyph by traversing
-*	the script provided
+* @brief Finds the child of a multi-cell glyph that continues with a pattern.
+*	Children are stored next to each other, starting at the parent's next
+*	glyph, and each of them points back to the parent.
+* @param script_t* script - Script the parent belongs to
+* @param const glyph_t* parent - Glyph whose children to search
+* @param char pattern - Cell pattern of the following cell
+* @return const glyph_t* - Matching child, NULL if none
+*/
+static const glyph_t* search_children(script_t* script, const glyph_t* parent,
+	char pattern) {
+	const glyph_t* end = script->glyphs + script->length;
+	const glyph_t* child = glyph_next(parent);
+
+	for (; child != NULL && child < end && glyph_prev(child) == parent; child++) {
+		if (glyph_pattern(child) == pattern) {
+			return child;
+		}
+	}
+	return NULL;
+}
+
+/**
+* @brief Decodes the glyph starting at patterns[*index]. Each script's glyph
+*	table forms a trie: the first cell is found through the pattern index and
+*	every following cell selects a child, so the longest glyph is matched
+*	in one pass without backtracking. Only complete glyphs (leaves) are
+*	returned; a prefix that is not followed by a valid cell does not match.
 * @param script_t* script - Pointer to script to search in
 * @param char* pattern - Pointer to pattern array to search for
-* @param int* index - Index to update as parsing continues
-* @return glyph_t* - Pointer to glyph, NULL if not found
+* @param int* index - Set to the last cell consumed by the glyph
+* @return const glyph_t* - Pointer to glyph, NULL if not found
 */
-glyph_t* get_glyph(script_t* script, char* patterns, int* index) {
+const glyph_t* get_glyph(script_t* script, char* patterns, int* index) {
 	char curr_pattern = patterns[*index];
-	glyph_t* curr_glyph;
+	const glyph_t* curr_glyph;
+	int last_index = *index;
 
 	sprintf(dbgstr, "[IO] Current pattern: 0x%x\n\r", curr_pattern);
 	PRINTF(dbgstr);
@@ -65,14 +91,40 @@ glyph_t* get_glyph(script_t* script, char* patterns, int* index) {
 	// If no match found in script, return NULL
 	curr_glyph = search_script(script, curr_pattern);
 	if (curr_glyph == NULL) {
-		curr_glyph = search_script(&script_digits, curr_pattern);
+		script = &script_digits;
+		curr_glyph = search_script(script, curr_pattern);
 		if (curr_glyph == NULL) {
 			PRINTF("[IO] Matching glyph not found; returning NULL\n\r");
 			return NULL;
 		}
 	}
-		PRINTF("[IO] No subscript; returning glyph\n\r");
-		return curr_glyph;
+
+	// Follow multi-cell glyphs one cell at a time until reaching a leaf
+	while (glyph_next(curr_glyph) != NULL) {
+		curr_pattern = patterns[last_index + 1];
+		curr_glyph = search_children(script, curr_glyph, curr_pattern);
+		if (curr_glyph == NULL) {
+			PRINTF("[IO] Incomplete multi-cell glyph; returning NULL\n\r");
+			return NULL;
+		}
+		last_index++;
+	}
+
+	*index = last_index;
+	return curr_glyph;
+}
+
+/**
+ * @brief Reads a script's pattern index entry
+ * @param script_t* script - Script to look in
+ * @param char pattern - Cell pattern to look up
+ * @return unsigned char - Index entry, SCRIPT_INDEX_NONE if out of range
+ */
+static unsigned char lookup_pattern(script_t* script, char pattern) {
+	if ((unsigned char) pattern >= SCRIPT_INDEX_SIZE) {
+		return SCRIPT_INDEX_NONE;
+	}
+	return pgm_read_byte(&script->lookup[(unsigned char) pattern]);
 }
 
 /**
@@ -80,127 +132,117 @@ glyph_t* get_glyph(script_t* script, char* patterns, int* index) {
  * and then the common script if no match found in language
  * @param	script_t* script - Script to look in
  * @param char pattern - Cell pattern to look for
- * @return glyph_t* - Corresponding to glyph it found, NULL if not found
+ * @return const glyph_t* - Corresponding to glyph it found, NULL if not found
  */
-glyph_t* search_script(script_t* curr_script, char pattern) {
-	glyph_t* curr_glyph = NULL;
-	int index_bound = 0;
-	index_bound = curr_script->length;
-
-	// Search through array of glyphs
-	for (int glyph_index = 0; glyph_index < index_bound; glyph_index++) {
-		curr_glyph = &(curr_script->glyphs[glyph_index]);
-		if (curr_glyph && curr_glyph->pattern == pattern) {
-			return curr_glyph;
-		}
+const glyph_t* search_script(script_t* curr_script, char pattern) {
+	unsigned char entry = lookup_pattern(curr_script, pattern);
+
+	if (entry == SCRIPT_INDEX_NONE) {
+		sprintf(dbgstr, "[Script] Glyph match not found: 0x%x\n\r", pattern);
+		PRINTF(dbgstr);
+		return NULL;
 	}
+	return &(curr_script->glyphs[(entry & SCRIPT_INDEX_MASK) - 1]);
+}
 
-	// If nothing matches, return NULL
-	sprintf(dbgstr, "[Script] Glyph match not found: 0x%x\n\r", pattern);
-	PRINTF(dbgstr);
-	return NULL;
+/**
+ * @brief Checks whether a cell pattern starts a multi-cell glyph in a script
+ * @param script_t* script - Script to look in
+ * @param char pattern - Cell pattern to check
+ * @return bool - true if the matching glyph has a next cell
+ */
+bool is_prefix(script_t* curr_script, char pattern) {
+	return (lookup_pattern(curr_script, pattern) & SCRIPT_INDEX_PREFIX) != 0;
 }
 
 /**
  * @brief Returns the glyph in the script the corresponds to 
  * curr_glyph -> next
- * @param glyph_t* curr_glyph pointer to glyph to find next of
+ * @param const glyph_t* curr_glyph pointer to glyph to find next of
  * @param script_t* script - Script to look in
- * @return glyph_t* - Corresponding to next in the linked list
+ * @return const glyph_t* - Corresponding to next in the linked list
  */
-glyph_t* get_next(script_t* curr_script, glyph_t* curr_glyph) {
-	return search_script(curr_script, curr_glyph->next->pattern);
+const glyph_t* get_next(script_t* curr_script, const glyph_t* curr_glyph) {
+	return glyph_next(curr_glyph);
 }
 
 /**
-* @brief Adds added_glyph to the end of a word_node
-* @param word_node_t* curr_word pointer to word being added to
-* @param glyph_t* added_glyph pointer to glyph being added
-* @return word_node_t* - curr_word with added_glyph added
+* @brief Empties a word
+* @param word_t* curr_word - Word to reset
+* @return void
 */
-word_node_t* add_glyph_to_word(word_node_t* curr_word, glyph_t* added_glyph) {
-	word_node_t* new_word_node = malloc(sizeof(word_node_t));
-	new_word_node->data = added_glyph; 
-	new_word_node->next = NULL;
-	if (added_glyph == NULL) return NULL;
-	if (curr_word == NULL) { 
-		return new_word_node;
-	} else {
-		word_node_t* next_word_node = curr_word;
-		while (next_word_node->next != NULL){
-			next_word_node = next_word_node->next;
-		}
-		next_word_node->next = new_word_node;
-		return curr_word;
-	}
+void reset_word(word_t* curr_word) {
+	curr_word->length = 0;
 }
 
-word_node_t* free_word(word_node_t* this_word) {
-	word_node_t* curr_node;
-	while (this_word!= NULL) {
-		curr_node = this_word;
-		this_word = this_word->next;
-		free(curr_node);
+/**
+* @brief Adds added_glyph to the end of a word
+* @param word_t* curr_word pointer to word being added to
+* @param const glyph_t* added_glyph pointer to glyph being added
+* @return bool - false if added_glyph is NULL or the word is full
+*/
+bool add_glyph_to_word(word_t* curr_word, const glyph_t* added_glyph) {
+	if (added_glyph == NULL || curr_word->length >= MAX_WORD_LENGTH) {
+		return false;
 	}
-	return NULL;
+	curr_word->glyphs[curr_word->length++] = added_glyph;
+	return true;
 }
 
-
 /**
  * @brief Returns the glyph in the script the corresponds to 
  * the first node in the linked list that includes curr_glyph
- * @param glyph_t* curr_glyph - Pointer to glyph to find next of
+ * @param const glyph_t* curr_glyph - Pointer to glyph to find next of
  * @param script_t* script - Script to look in
- * @return glyph_t* - pointer to first glyph in the linked list
+ * @return const glyph_t* - pointer to first glyph in the linked list
  */
-glyph_t* get_root(script_t* curr_script, glyph_t* curr_glyph) {
-	if (curr_glyph->prev == NULL) {
-		return curr_glyph;
-	} else {
-		curr_glyph = search_script(curr_script,curr_glyph->prev->pattern);
-		return get_root(curr_script,curr_glyph);
+const glyph_t* get_root(script_t* curr_script, const glyph_t* curr_glyph) {
+	while (glyph_prev(curr_glyph) != NULL) {
+		curr_glyph = glyph_prev(curr_glyph);
 	}
+	return curr_glyph;
 }
 
 /**
- * @brief Returns a word linked list that corresponds to the given word
- * @param char* word -> word to turn into a glyph linked list
+ * @brief Fills a word with the glyphs for each letter of a string
  * @param script_t* script - Script to look in
- * @return word_node_t* - pointer to first word_node in the linked list representing word
+ * @param char* text - Letters to convert
+ * @param word_t* curr_word - Word to fill
+ * @return bool - false if a letter has no glyph or the word is too long
  */
-word_node_t* word_to_glyph_word(script_t* curr_script, char* word) {
-	word_node_t* curr_word = NULL;
-	glyph_t* curr_glyph = NULL;
-	for (int i = 0; i < strlen(word); i++) {
-		curr_glyph = search_script(curr_script,get_bits_from_letter(word[i]));
-		curr_word = add_glyph_to_word(curr_word,curr_glyph);
+bool word_to_glyph_word(script_t* curr_script, char* text, word_t* curr_word) {
+	reset_word(curr_word);
+	for (int i = 0; text[i] != '\0'; i++) {
+		if (!add_glyph_to_word(curr_word,
+			search_script(curr_script, get_bits_from_letter(text[i])))) {
+			return false;
+		}
 	}
-	return curr_word;
+	return true;
 }
 
 
 /**
 * @brief Returns a random last-order glyph from the current script
 * @param script_t* - Script to get random glyph from
-* @return glyph_t* - Pointer to random glyph
+* @return const glyph_t* - Pointer to random glyph
 */
-glyph_t* get_random_glyph(script_t* script) {
-	glyph_t* curr_glyph = &(script->glyphs[timer_rand() % script->length]);
-	if (curr_glyph->prev == NULL) {
-		return curr_glyph;
-	} else {
-		return get_random_glyph(script);
-	}
+const glyph_t* get_random_glyph(script_t* script) {
+	const glyph_t* curr_glyph;
+	do {
+		curr_glyph = &(script->glyphs[random_below(script->length)]);
+	} while (glyph_prev(curr_glyph) != NULL);
+	return curr_glyph;
 }
 
 /**
 * @brief Returns the next glyph from the current script
 * @param void
-* @glyph_t* - Pointer to next glyph
+* @const glyph_t* - Pointer to next glyph
 */
-glyph_t* get_next_glyph(script_t* script) {
+const glyph_t* get_next_glyph(script_t* script) {
 
-	glyph_t* curr_glyph;
+	const glyph_t* curr_glyph;
 
 	script->index++;
 
@@ -212,7 +254,7 @@ glyph_t* get_next_glyph(script_t* script) {
 
 	curr_glyph = &(script->glyphs[script->index]);
 	//
-	if (curr_glyph -> prev == NULL) {
+	if (glyph_prev(curr_glyph) == NULL) {
 		return curr_glyph;
 	} else {
 		return get_next_glyph(script);
@@ -222,11 +264,11 @@ glyph_t* get_next_glyph(script_t* script) {
 /**
 * @brief Returns the previous glyph from the current script
 * @param void
-* @glyph_t* - Pointer to previous glyph
+* @const glyph_t* - Pointer to previous glyph
 */
-glyph_t* get_prev_glyph(script_t* script) {
+const glyph_t* get_prev_glyph(script_t* script) {
 
-	glyph_t* curr_glyph;
+	const glyph_t* curr_glyph;
 
 	script->index--;
 
@@ -237,7 +279,7 @@ glyph_t* get_prev_glyph(script_t* script) {
 	}
 
 	curr_glyph = &(script->glyphs[script->index]);
-	if (curr_glyph -> prev == NULL) {
+	if (glyph_prev(curr_glyph) == NULL) {
 		return curr_glyph;
 	} else {
 		return get_prev_glyph(script);
@@ -248,13 +290,13 @@ glyph_t* get_prev_glyph(script_t* script) {
 
 /**
 * @brief Checks if a given glyph is a number
-* @param glyph_t* Pointer to glyph to check
+* @param const glyph_t* Pointer to glyph to check
 * @return bool - true if a number, false otherwise
 */
-bool is_number(glyph_t* curr_glyph) {
+bool is_number(const glyph_t* curr_glyph) {
 	if (curr_glyph == NULL)
 		return false;
-	switch (curr_glyph->pattern) {
+	switch (glyph_pattern(curr_glyph)) {
 		case NUM1: case NUM2: case NUM3: case NUM4: case NUM5: case NUM6:
 		case NUM7: case NUM8: case NUM9: case NUM0:
 			return true;
@@ -267,17 +309,17 @@ bool is_number(glyph_t* curr_glyph) {
 
 /**
 * @brief Converts a digit glyph to an integer
-* @param glyph_t* - Pointer to glyph to convet
+* @param const glyph_t* - Pointer to glyph to convet
 * @return int - 0-9 for valid digit, -1 otherwise
 */
-int get_digit(glyph_t* curr_glyph) {
+int get_digit(const glyph_t* curr_glyph) {
 	if (curr_glyph == NULL)
 		return -1;
 	if (!is_number(curr_glyph)) {
 		return -1;
 	}
 
-	switch(curr_glyph->pattern) {
+	switch(glyph_pattern(curr_glyph)) {
 		case NUM1: return 1; break;
 		case NUM2: return 2; break;
 		case NUM3: return 3; break;
@@ -294,12 +336,12 @@ int get_digit(glyph_t* curr_glyph) {
 
 /**
 * @brief Checks to see if a glyph is BLANK
-* @param glyph_t* - Pointer to check
+* @param const glyph_t* - Pointer to check
 * @return bool - true if BLANk, false otherwise
 */
-bool is_blank(glyph_t* curr_glyph) {
+bool is_blank(const glyph_t* curr_glyph) {
 	if (curr_glyph == NULL)
 		return false;
 	else
-		return (curr_glyph->pattern == 0x00);
+		return (glyph_pattern(curr_glyph) == 0x00);
 }
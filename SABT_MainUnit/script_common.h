@@ -32,21 +32,23 @@
 #define MP3_NEXT_PATTERN "NPAT"
 
 extern script_t* lang_script;
+extern const glyph_t blank_cell;
 extern script_t script_common;
 
 void reset_script_indices(script_t* script);
-glyph_t* get_glyph(script_t* script, char* patterns, int* index);
-glyph_t* search_script(script_t* script, char pattern);
-glyph_t* get_next_glyph(script_t* script);
-glyph_t* get_prev_glyph(script_t* script);
-glyph_t* get_random_glyph(script_t* script);
-bool is_number(glyph_t* curr_glyph);
-int get_digit(glyph_t* curr_glyph);
-bool is_blank(glyph_t* curr_glyph);
-glyph_t* get_next(script_t* curr_script, glyph_t* curr_glyph);
-glyph_t* get_root(script_t* curr_script, glyph_t* curr_glyph);
-word_node_t* word_to_glyph_word(script_t* curr_script, char* word);
-word_node_t* free_word(word_node_t* this_word);
-word_node_t* add_glyph_to_word(word_node_t* curr_word, glyph_t* added_glyph);
+const glyph_t* get_glyph(script_t* script, char* patterns, int* index);
+const glyph_t* search_script(script_t* script, char pattern);
+bool is_prefix(script_t* script, char pattern);
+const glyph_t* get_next_glyph(script_t* script);
+const glyph_t* get_prev_glyph(script_t* script);
+const glyph_t* get_random_glyph(script_t* script);
+bool is_number(const glyph_t* curr_glyph);
+int get_digit(const glyph_t* curr_glyph);
+bool is_blank(const glyph_t* curr_glyph);
+const glyph_t* get_next(script_t* curr_script, const glyph_t* curr_glyph);
+const glyph_t* get_root(script_t* curr_script, const glyph_t* curr_glyph);
+void reset_word(word_t* curr_word);
+bool add_glyph_to_word(word_t* curr_word, const glyph_t* added_glyph);
+bool word_to_glyph_word(script_t* curr_script, char* text, word_t* curr_word);
 
 #endif /* _SCRIPT_COMMON_H_ */
@@ -0,0 +1,45 @@
+/**
+ *  @file script_digits.c
+ *  @brief Structures for digits, stored in program memory
+ */
+
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include "script_digits.h"
+
+const glyph_t glyphs_digits[SCRIPT_DIGITS_LENGTH] PROGMEM = {
+	{NUM1, "#1", 0, 0},
+	{NUM2, "#2", 0, 0},
+	{NUM3, "#3", 0, 0},
+	{NUM4, "#4", 0, 0},
+	{NUM5, "#5", 0, 0},
+	{NUM6, "#6", 0, 0},
+	{NUM7, "#7", 0, 0},
+	{NUM8, "#8", 0, 0},
+	{NUM9, "#9", 0, 0},
+	{NUM0, "#0", 0, 0},
+	{NUMSIGN, "#NUM", 0, 0}
+};
+
+// Pattern index into glyphs_digits
+static const unsigned char digits_index[SCRIPT_INDEX_SIZE] PROGMEM = {
+	[NUM1] = 1,
+	[NUM2] = 2,
+	[NUM3] = 3,
+	[NUM4] = 4,
+	[NUM5] = 5,
+	[NUM6] = 6,
+	[NUM7] = 7,
+	[NUM8] = 8,
+	[NUM9] = 9,
+	[NUM0] = 10,
+	[NUMSIGN] = 11
+};
+
+script_t script_digits = {
+	SCRIPT_DIGITS_LENGTH,
+	0,
+	SCRIPT_DIGITS_FILESET,
+	glyphs_digits,
+	digits_index
+};
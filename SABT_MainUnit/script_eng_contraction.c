@@ -0,0 +1,168 @@
+/**
+ *  @file script_eng_contraction.c
+ *  @brief Structures for the english contractions, stored in program memory
+ */
+
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include "script_eng_contraction.h"
+
+const glyph_t contraction_glyphs[SCRIPT_CONTRACTION_LENGTH] PROGMEM = {
+	{ENG_A, "A", 0, 0},
+	{ENG_B, "B", 0, 0},
+	{ENG_C, "C", 0, 0},
+	{ENG_D, "D", 0, 0},
+	{ENG_E, "E", 0, 0},
+	{ENG_F, "F", 0, 0},
+	{ENG_G, "G", 0, 0},
+	{ENG_H, "H", 0, 0},
+	{ENG_I, "I", 0, 0},
+	{ENG_J, "J", 0, 0},
+	{ENG_K, "K", 0, 0},
+	{ENG_L, "L", 0, 0},
+	{ENG_M, "M", 0, 0},
+	{ENG_N, "N", 0, 0},
+	{ENG_O, "O", 0, 0},
+	{ENG_P, "P", 0, 0},
+	{ENG_Q, "Q", 0, 0},
+	{ENG_R, "R", 0, 0},
+	{ENG_S, "S", 0, 0},
+	{ENG_T, "T", 0, 0},
+	{ENG_U, "U", 0, 0},
+	{ENG_V, "V", 0, 0},
+	{ENG_W, "W", 0, 0},
+	{ENG_X, "X", 0, 0},
+	{ENG_Y, "Y", 0, 0},
+	{ENG_Z, "Z", 0, 0},
+	{CON_S1, "S1", 0, 0},
+	{CON_S2, "S2", 0, 0},
+	{CON_S3, "S3", 0, 0},
+	{CON_S4, "S4", 0, 0},
+	{CON_S5, "S5", 0, 0},
+	{CON_S6, "S6", 0, 0},
+	{CON_S7, "S7", 0, 0},
+	{CON_S8, "S8", 0, 0},
+	{CON_S9, "S9", 0, 0},
+	{CON_S10, "S10", 0, 0},
+
+	// Prefix cells; each is followed by its two-cell contractions below
+	{CON_P1, "P1", 0, +6},
+	{CON_P2, "P2", 0, +27},
+	{CON_P3, "P3", 0, +31},
+	{CON_P4, "P4", 0, +36},
+	{CON_P5, "P5", 0, +40},
+	{CON_P6, "P6", 0, +46},
+
+	// CON_P1 followed by a letter or symbol, named after the contraction
+	{ENG_D, "CON1_W4", -6, 0},
+	{ENG_E, "CON1_W5", -7, 0},
+	{ENG_F, "CON1_W6", -8, 0},
+	{ENG_H, "CON1_W8", -9, 0},
+	{ENG_K, "CON1_W11", -10, 0},
+	{ENG_L, "CON1_W12", -11, 0},
+	{ENG_M, "CON1_W13", -12, 0},
+	{ENG_N, "CON1_W14", -13, 0},
+	{ENG_O, "CON1_W15", -14, 0},
+	{ENG_P, "CON1_W16", -15, 0},
+	{ENG_Q, "CON1_W17", -16, 0},
+	{ENG_R, "CON1_W18", -17, 0},
+	{ENG_S, "CON1_W19", -18, 0},
+	{ENG_T, "CON1_W20", -19, 0},
+	{ENG_U, "CON1_W21", -20, 0},
+	{ENG_W, "CON1_W23", -21, 0},
+	{ENG_Y, "CON1_W25", -22, 0},
+	{CON_S4, "CON1_W30", -23, 0},
+	{CON_S6, "CON1_W32", -24, 0},
+	{CON_S8, "CON1_W34", -25, 0},
+	{CON_S9, "CON1_W35", -26, 0},
+	{CON_S10, "CON1_W36", -27, 0},
+
+	// CON_P2 followed by a letter or symbol, named after the contraction
+	{ENG_U, "CON2_W21", -27, 0},
+	{ENG_W, "CON2_W23", -28, 0},
+	{CON_S4, "CON2_W30", -29, 0},
+	{CON_S8, "CON2_W34", -30, 0},
+	{CON_S9, "CON2_W35", -31, 0},
+
+	// CON_P3 followed by a letter or symbol, named after the contraction
+	{ENG_C, "CON3_W3", -31, 0},
+	{ENG_H, "CON3_W8", -32, 0},
+	{ENG_M, "CON3_W13", -33, 0},
+	{ENG_S, "CON3_W19", -34, 0},
+	{ENG_W, "CON3_W23", -35, 0},
+	{CON_S4, "CON3_W30", -36, 0},
+
+	// CON_P4 followed by a letter or symbol, named after the contraction
+	{ENG_D, "CON4_W4", -36, 0},
+	{ENG_E, "CON4_W5", -37, 0},
+	{ENG_N, "CON4_W14", -38, 0},
+	{ENG_S, "CON4_W19", -39, 0},
+	{ENG_T, "CON4_W20", -40, 0},
+
+	// CON_P5 followed by a letter or symbol, named after the contraction
+	{ENG_E, "CON5_W5", -40, 0},
+	{ENG_G, "CON5_W7", -41, 0},
+	{ENG_L, "CON5_W12", -42, 0},
+	{ENG_N, "CON5_W14", -43, 0},
+	{ENG_S, "CON5_W19", -44, 0},
+	{ENG_T, "CON5_W20", -45, 0},
+	{ENG_Y, "CON5_W25", -46, 0},
+
+	// CON_P6 followed by a letter or symbol, named after the contraction
+	{ENG_N, "CON6_W14", -46, 0},
+	{ENG_Y, "CON6_W25", -47, 0}
+};
+
+// Pattern index into contraction_glyphs
+static const unsigned char contraction_index[SCRIPT_INDEX_SIZE] PROGMEM = {
+	[ENG_A] = 1,
+	[ENG_B] = 2,
+	[ENG_C] = 3,
+	[ENG_D] = 4,
+	[ENG_E] = 5,
+	[ENG_F] = 6,
+	[ENG_G] = 7,
+	[ENG_H] = 8,
+	[ENG_I] = 9,
+	[ENG_J] = 10,
+	[ENG_K] = 11,
+	[ENG_L] = 12,
+	[ENG_M] = 13,
+	[ENG_N] = 14,
+	[ENG_O] = 15,
+	[ENG_P] = 16,
+	[ENG_Q] = 17,
+	[ENG_R] = 18,
+	[ENG_S] = 19,
+	[ENG_T] = 20,
+	[ENG_U] = 21,
+	[ENG_V] = 22,
+	[ENG_W] = 23,
+	[ENG_X] = 24,
+	[ENG_Y] = 25,
+	[ENG_Z] = 26,
+	[CON_S1] = 27,
+	[CON_S2] = 28,
+	[CON_S3] = 29,
+	[CON_S4] = 30,
+	[CON_S5] = 31,
+	[CON_S6] = 32,
+	[CON_S7] = 33,
+	[CON_S8] = 34,
+	[CON_S9] = 35,
+	[CON_S10] = 36,
+	[CON_P1] = SCRIPT_INDEX_PREFIX | 37,
+	[CON_P2] = SCRIPT_INDEX_PREFIX | 38,
+	[CON_P3] = SCRIPT_INDEX_PREFIX | 39,
+	[CON_P4] = SCRIPT_INDEX_PREFIX | 40,
+	[CON_P5] = SCRIPT_INDEX_PREFIX | 41,
+	[CON_P6] = SCRIPT_INDEX_PREFIX | 42
+};
+
+script_t script_eng_contraction = {
+	SCRIPT_CONTRACTION_LENGTH,
+	0,
+	SCRIPT_CONTRACTION_FILESET,
+	contraction_glyphs,
+	contraction_index
+};
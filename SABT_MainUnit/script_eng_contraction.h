@@ -11,8 +11,15 @@
 #include "script_common.h"
 
 #define SCRIPT_CONTRACTION_FILESET "ENG_" // Followed by 0,1, ..., 6 depending on the pattern used
-#define SCRIPT_CONTRACTION_LENGTH 36 // 10 contraction symbols + 26 english alphabets
-#define SCRIPT_CONTRACTION_PATTERN_LENTGH 7 // 6 glyphs used to form contractions + 0 for single cell contractions
+#define SCRIPT_CONTRACTION_SYMBOLS 36 // 10 contraction symbols + 26 english alphabets
+#define SCRIPT_CONTRACTION_PREFIXES 6 // Patterns used to form two-cell contractions
+#define SCRIPT_CONTRACTION_TWO_CELL 47
+#define SCRIPT_CONTRACTION_LENGTH (SCRIPT_CONTRACTION_SYMBOLS + \
+	SCRIPT_CONTRACTION_PREFIXES + SCRIPT_CONTRACTION_TWO_CELL)
+
+// contraction_glyphs holds the symbols first, then the prefixes, then the
+// two-cell contractions grouped by prefix
+#define SCRIPT_CONTRACTION_PREFIX_START SCRIPT_CONTRACTION_SYMBOLS
 
 // English Alphabets - bit pattern
 
@@ -65,64 +72,11 @@
 #define CON_P5 0b110000
 #define CON_P6 0b100000
 
-
-glyph_t contraction_glyphs[SCRIPT_CONTRACTION_LENGTH] = {
-	{ENG_A, "A", NULL, NULL},
-	{ENG_B, "B", NULL, NULL},
-	{ENG_C, "C", NULL, NULL},
-	{ENG_D, "D", NULL, NULL},
-	{ENG_E, "E", NULL, NULL},
-	{ENG_F, "F", NULL, NULL},
-	{ENG_G, "G", NULL, NULL},
-	{ENG_H, "H", NULL, NULL},
-	{ENG_I, "I", NULL, NULL},
-	{ENG_J, "J", NULL, NULL},
-	{ENG_K, "K", NULL, NULL},
-	{ENG_L, "L", NULL, NULL},
-	{ENG_M, "M", NULL, NULL},
-	{ENG_N, "N", NULL, NULL},
-	{ENG_O, "O", NULL, NULL},
-	{ENG_P, "P", NULL, NULL},
-	{ENG_Q, "Q", NULL, NULL},
-	{ENG_R, "R", NULL, NULL},
-	{ENG_S, "S", NULL, NULL},
-	{ENG_T, "T", NULL, NULL},
-	{ENG_U, "U", NULL, NULL},
-	{ENG_V, "V", NULL, NULL},
-	{ENG_W, "W", NULL, NULL},
-	{ENG_X, "X", NULL, NULL},
-	{ENG_Y, "Y", NULL, NULL},
-	{ENG_Z, "Z", NULL, NULL},
-	{CON_S1, "S1", NULL, NULL},
-	{CON_S2, "S2", NULL, NULL},
-	{CON_S3, "S3", NULL, NULL},
-	{CON_S4, "S4", NULL, NULL},
-    {CON_S5, "S5", NULL, NULL},
-	{CON_S6, "S6", NULL, NULL},
-	{CON_S7, "S7", NULL, NULL},
-	{CON_S8, "S8", NULL, NULL},
-	{CON_S9, "S9", NULL, NULL},
-	{CON_S10, "S10", NULL, NULL},
-};
-
-glyph_t contraction_pattern[SCRIPT_CONTRACTION_PATTERN_LENTGH] = {
-	{0, "P0", NULL, NULL},						
-	{CON_P1, "P1", NULL, NULL},
-	{CON_P2, "P2", NULL, NULL},
-	{CON_P3, "P3", NULL, NULL},
-	{CON_P4, "P4", NULL, NULL},
-	{CON_P5, "P5", NULL, NULL},
-	{CON_P6, "P6", NULL, NULL}
-};
+extern const glyph_t contraction_glyphs[SCRIPT_CONTRACTION_LENGTH];
 
 // Patterns used to form braille cells  
 
-script_t script_eng_contraction = {
-	SCRIPT_CONTRACTION_LENGTH,
-	0,
-	SCRIPT_CONTRACTION_FILESET,
-	contraction_glyphs
-};
+extern script_t script_eng_contraction;
 
 #endif /* _SCRIPT_ENG_CONTRACTION_H_ */
 
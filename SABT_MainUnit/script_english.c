@@ -0,0 +1,75 @@
+/**
+ *  @file script_english.c
+ *  @brief Structures for the English language, stored in program memory
+ */
+
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include "script_english.h"
+
+const glyph_t english_glyphs[SCRIPT_ENGLISH_LENGTH] PROGMEM = {
+	{ENG_A, "A", 0, 0},
+	{ENG_B, "B", 0, 0},
+	{ENG_C, "C", 0, 0},
+	{ENG_D, "D", 0, 0},
+	{ENG_E, "E", 0, 0},
+	{ENG_F, "F", 0, 0},
+	{ENG_G, "G", 0, 0},
+	{ENG_H, "H", 0, 0},
+	{ENG_I, "I", 0, 0},
+	{ENG_J, "J", 0, 0},
+	{ENG_K, "K", 0, 0},
+	{ENG_L, "L", 0, 0},
+	{ENG_M, "M", 0, 0},
+	{ENG_N, "N", 0, 0},
+	{ENG_O, "O", 0, 0},
+	{ENG_P, "P", 0, 0},
+	{ENG_Q, "Q", 0, 0},
+	{ENG_R, "R", 0, 0},
+	{ENG_S, "S", 0, 0},
+	{ENG_T, "T", 0, 0},
+	{ENG_U, "U", 0, 0},
+	{ENG_V, "V", 0, 0},
+	{ENG_W, "W", 0, 0},
+	{ENG_X, "X", 0, 0},
+	{ENG_Y, "Y", 0, 0},
+	{ENG_Z, "Z", 0, 0}
+};
+
+// Pattern index into english_glyphs
+static const unsigned char english_index[SCRIPT_INDEX_SIZE] PROGMEM = {
+	[ENG_A] = 1,
+	[ENG_B] = 2,
+	[ENG_C] = 3,
+	[ENG_D] = 4,
+	[ENG_E] = 5,
+	[ENG_F] = 6,
+	[ENG_G] = 7,
+	[ENG_H] = 8,
+	[ENG_I] = 9,
+	[ENG_J] = 10,
+	[ENG_K] = 11,
+	[ENG_L] = 12,
+	[ENG_M] = 13,
+	[ENG_N] = 14,
+	[ENG_O] = 15,
+	[ENG_P] = 16,
+	[ENG_Q] = 17,
+	[ENG_R] = 18,
+	[ENG_S] = 19,
+	[ENG_T] = 20,
+	[ENG_U] = 21,
+	[ENG_V] = 22,
+	[ENG_W] = 23,
+	[ENG_X] = 24,
+	[ENG_Y] = 25,
+	[ENG_Z] = 26
+};
+
+script_t script_english = {
+	SCRIPT_ENGLISH_LENGTH,
+	0,
+	SCRIPT_ENGLISH_FILESET,
+	english_glyphs,
+	english_index
+};
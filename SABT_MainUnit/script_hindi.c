@@ -0,0 +1,132 @@
+/**
+ *  @file script_hindi.c
+ *  @brief Glyphs of the Hindi script, stored in program memory
+ */
+
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include "script_hindi.h"
+
+// Hindi script array
+const glyph_t glyphs_hindi[SCRIPT_HINDI_LENGTH] PROGMEM = {
+	{HIN_A, "A", 0, 0},
+	{HIN_AA, "AA", 0, 0},
+	{HIN_I, "I", 0, 0},
+	{HIN_II, "II", 0, 0},
+	{HIN_U, "U", 0, 0},
+	{HIN_UU, "UU", 0, 0},
+	// RU takes two cells; the second cell completes the glyph
+	{HIN_RU_1, "RU", 0, +1},
+	{HIN_RU_2, "RU", -1, 0},
+
+	{HIN_EE, "EE", 0, 0},
+	{HIN_AI, "AI", 0, 0},
+	{HIN_OO, "OO", 0, 0},
+	{HIN_AU, "AU", 0, 0},
+	{HIN_AM, "AM", 0, 0},
+	{HIN_AHA, "AHA", 0, 0},
+
+	{HIN_KA, "KA", 0, 0},
+	{HIN_KHA, "KHA", 0, 0},
+	{HIN_GA, "GA", 0, 0},
+	{HIN_GHA, "GHA", 0, 0},
+	{HIN_NYA, "NYA", 0, 0},
+
+	{HIN_CHA, "CHA", 0, 0},
+	{HIN_CHHA, "CHHA", 0, 0},
+	{HIN_JA, "JA", 0, 0},
+	{HIN_JHA, "JHA", 0, 0},
+	{HIN_NYAA, "NYAA", 0, 0},
+
+	{HIN_TTA, "TTA", 0, 0},
+	{HIN_TTHA, "TTHA", 0, 0},
+	{HIN_DDA, "DDA", 0, 0},
+	{HIN_DDHA, "DDHA", 0, 0},
+	{HIN_GNA, "GNA", 0, 0},
+
+	{HIN_TA, "TA", 0, 0},
+	{HIN_THA, "THA", 0, 0},
+	{HIN_DA, "DA", 0, 0},
+	{HIN_DHA, "DHA", 0, 0},
+	{HIN_NA, "NA", 0, 0},
+
+	{HIN_PA, "PA", 0, 0},
+	{HIN_PHA, "PHA", 0, 0},
+	{HIN_BA, "BA", 0, 0},
+	{HIN_BHA, "BHA", 0, 0},
+	{HIN_MA, "MA", 0, 0},
+
+	{HIN_YA, "YA", 0, 0},
+	{HIN_RA, "RA", 0, 0},
+	{HIN_LA, "LA", 0, 0},
+	{HIN_VA, "VA", 0, 0},
+
+	{HIN_SHA, "SHA", 0, 0},
+	{HIN_SHHA, "SHHA", 0, 0},
+	{HIN_SA, "SA", 0, 0},
+	{HIN_HA, "HA", 0, 0},
+
+	{HIN_DLA, "DLA", 0, 0},
+	{HIN_KSHA, "KSHA", 0, 0}
+};
+
+// Pattern index into glyphs_hindi
+static const unsigned char hindi_index[SCRIPT_INDEX_SIZE] PROGMEM = {
+	[HIN_A] = 1,
+	[HIN_AA] = 2,
+	[HIN_I] = 3,
+	[HIN_II] = 4,
+	[HIN_U] = 5,
+	[HIN_UU] = 6,
+	[HIN_RU_1] = SCRIPT_INDEX_PREFIX | 7,
+	[HIN_RU_2] = 8,
+	[HIN_EE] = 9,
+	[HIN_AI] = 10,
+	[HIN_OO] = 11,
+	[HIN_AU] = 12,
+	[HIN_AM] = 13,
+	[HIN_AHA] = 14,
+	[HIN_KA] = 15,
+	[HIN_KHA] = 16,
+	[HIN_GA] = 17,
+	[HIN_GHA] = 18,
+	[HIN_NYA] = 19,
+	[HIN_CHA] = 20,
+	[HIN_CHHA] = 21,
+	[HIN_JA] = 22,
+	[HIN_JHA] = 23,
+	[HIN_NYAA] = 24,
+	[HIN_TTA] = 25,
+	[HIN_TTHA] = 26,
+	[HIN_DDA] = 27,
+	[HIN_DDHA] = 28,
+	[HIN_GNA] = 29,
+	[HIN_TA] = 30,
+	[HIN_THA] = 31,
+	[HIN_DA] = 32,
+	[HIN_DHA] = 33,
+	[HIN_NA] = 34,
+	[HIN_PA] = 35,
+	[HIN_PHA] = 36,
+	[HIN_BA] = 37,
+	[HIN_BHA] = 38,
+	[HIN_MA] = 39,
+	[HIN_YA] = 40,
+	// HIN_RA has the same pattern as HIN_PA; the first entry wins
+	[HIN_LA] = 42,
+	[HIN_VA] = 43,
+	[HIN_SHA] = 44,
+	[HIN_SHHA] = 45,
+	[HIN_SA] = 46,
+	[HIN_HA] = 47,
+	[HIN_DLA] = 48,
+	[HIN_KSHA] = 49
+};
+
+script_t script_hindi = {
+	SCRIPT_HINDI_LENGTH,
+	0,
+	SCRIPT_HINDI_FILESET,
+	glyphs_hindi,
+	hindi_index
+}; 
@@ -74,77 +74,8 @@
 #define HIN_DLA				0b111000
 #define HIN_KSHA			0b011111
 
-glyph_t glyphs_hindi[SCRIPT_HINDI_LENGTH];
-
 //Multi-cell - RU
 
-// Hindi script array
-glyph_t glyphs_hindi[SCRIPT_HINDI_LENGTH] = {
-	{HIN_A, "A", NULL, NULL},
-	{HIN_AA, "AA", NULL, NULL},
-	{HIN_I, "I", NULL, NULL},
-	{HIN_II, "II", NULL, NULL},
-	{HIN_U, "U", NULL, NULL},
-	{HIN_UU, "UU", NULL, NULL},
-	{HIN_RU_1, "RU", NULL, &glyphs_hindi[7]},
-	{HIN_RU_2, "RU_2", &glyphs_hindi[6] ,NULL},
-
-	{HIN_EE, "EE", NULL, NULL},
-	{HIN_AI, "AI", NULL, NULL},
-	{HIN_OO, "OO", NULL, NULL},
-	{HIN_AU, "AU", NULL, NULL},
-	{HIN_AM, "AM", NULL, NULL},
-	{HIN_AHA, "AHA", NULL, NULL},
-
-	{HIN_KA, "KA", NULL, NULL},
-	{HIN_KHA, "KHA", NULL, NULL},
-	{HIN_GA, "GA", NULL, NULL},
-	{HIN_GHA, "GHA", NULL, NULL},
-	{HIN_NYA, "NYA", NULL, NULL},
-
-	{HIN_CHA, "CHA", NULL, NULL},
-	{HIN_CHHA, "CHHA", NULL, NULL},
-	{HIN_JA, "JA", NULL, NULL},
-	{HIN_JHA, "JHA", NULL, NULL},
-	{HIN_NYAA, "NYAA", NULL, NULL},
-
-	{HIN_TTA, "TTA", NULL, NULL},
-	{HIN_TTHA, "TTHA", NULL, NULL},
-	{HIN_DDA, "DDA", NULL, NULL},
-	{HIN_DDHA, "DDHA", NULL, NULL},
-	{HIN_GNA, "GNA", NULL, NULL},
-
-	{HIN_TA, "TA", NULL, NULL},
-	{HIN_THA, "THA", NULL, NULL},
-	{HIN_DA, "DA", NULL, NULL},
-	{HIN_DHA, "DHA", NULL, NULL},
-	{HIN_NA, "NA", NULL, NULL},
-
-	{HIN_PA, "PA", NULL, NULL},
-	{HIN_PHA, "PHA", NULL, NULL},
-	{HIN_BA, "BA", NULL, NULL},
-	{HIN_BHA, "BHA", NULL, NULL},
-	{HIN_MA, "MA", NULL, NULL},
-
-	{HIN_YA, "YA", NULL, NULL},
-	{HIN_RA, "RA", NULL, NULL},
-	{HIN_LA, "LA", NULL, NULL},
-	{HIN_VA, "VA", NULL, NULL},
-
-	{HIN_SHA, "SHA", NULL, NULL},
-	{HIN_SHHA, "SHHA", NULL, NULL},
-	{HIN_SA, "SA", NULL, NULL},
-	{HIN_HA, "HA", NULL, NULL},
-
-	{HIN_DLA, "DLA", NULL, NULL},
-	{HIN_KSHA, "KSHA", NULL, NULL}
-};
-
-script_t script_hindi = {
-	SCRIPT_HINDI_LENGTH,
-	0,
-	SCRIPT_HINDI_FILESET,
-	glyphs_hindi,
-}; 
+extern script_t script_hindi;
 
 #endif /* _SCRIPT_HINDI_H_ */
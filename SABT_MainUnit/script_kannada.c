@@ -0,0 +1,136 @@
+/**
+ *  @file script_kannada.c
+ *  @brief Glyphs of the Kannada script, stored in program memory
+ */
+
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include "script_kannada.h"
+
+// Kannada script array
+const glyph_t glyphs_kannada[SCRIPT_KANNADA_LENGTH] PROGMEM = {
+	{KAN_A, "A", 0, 0},
+	{KAN_AA, "AA", 0, 0},
+	{KAN_I, "I", 0, 0},
+	{KAN_II, "II", 0, 0},
+	{KAN_U, "U", 0, 0},
+	{KAN_UU, "UU", 0, 0},
+	// RU takes two cells; the second cell completes the glyph
+	{KAN_RU_1, "RU", 0, +1},
+	{KAN_RU_2, "RU", -1, 0},
+
+	{KAN_E, "E", 0, 0},
+	{KAN_EE, "EE", 0, 0},
+	{KAN_AI, "AI", 0, 0},
+	{KAN_O, "O", 0, 0},
+	{KAN_OO, "OO", 0, 0},
+	{KAN_AU, "AU", 0, 0},
+	{KAN_AM, "AM", 0, 0},
+	{KAN_AHA, "AHA", 0, 0},
+
+	{KAN_KA, "KA", 0, 0},
+	{KAN_KHA, "KHA", 0, 0},
+	{KAN_GA, "GA", 0, 0},
+	{KAN_GHA, "GHA", 0, 0},
+	{KAN_NYA, "NYA", 0, 0},
+
+	{KAN_CHA, "CHA", 0, 0},
+	{KAN_CHHA, "CHHA", 0, 0},
+	{KAN_JA, "JA", 0, 0},
+	{KAN_JHA, "JHA", 0, 0},
+	{KAN_NYAA, "NYAA", 0, 0},
+
+	{KAN_TTA, "TTA", 0, 0},
+	{KAN_TTHA, "TTHA", 0, 0},
+	{KAN_DDA, "DDA", 0, 0},
+	{KAN_DDHA, "DDHA", 0, 0},
+	{KAN_GNA, "GNA", 0, 0},
+
+	{KAN_TA, "TA", 0, 0},
+	{KAN_THA, "THA", 0, 0},
+	{KAN_DA, "DA", 0, 0},
+	{KAN_DHA, "DHA", 0, 0},
+	{KAN_NA, "NA", 0, 0},
+
+	{KAN_PA, "PA", 0, 0},
+	{KAN_PHA, "PHA", 0, 0},
+	{KAN_BA, "BA", 0, 0},
+	{KAN_BHA, "BHA", 0, 0},
+	{KAN_MA, "MA", 0, 0},
+
+	{KAN_YA, "YA", 0, 0},
+	{KAN_RA, "RA", 0, 0},
+	{KAN_LA, "LA", 0, 0},
+	{KAN_VA, "VA", 0, 0},
+
+	{KAN_SHA, "SHA", 0, 0},
+	{KAN_SHHA, "SHHA", 0, 0},
+	{KAN_SA, "SA", 0, 0},
+	{KAN_HA, "HA", 0, 0},
+
+	{KAN_DLA, "DLA", 0, 0},
+	{KAN_KSHA, "KSHA", 0, 0}
+};
+
+// Pattern index into glyphs_kannada
+static const unsigned char kannada_index[SCRIPT_INDEX_SIZE] PROGMEM = {
+	[KAN_A] = 1,
+	[KAN_AA] = 2,
+	[KAN_I] = 3,
+	[KAN_II] = 4,
+	[KAN_U] = 5,
+	[KAN_UU] = 6,
+	[KAN_RU_1] = SCRIPT_INDEX_PREFIX | 7,
+	[KAN_RU_2] = 8,
+	[KAN_E] = 9,
+	[KAN_EE] = 10,
+	[KAN_AI] = 11,
+	[KAN_O] = 12,
+	[KAN_OO] = 13,
+	[KAN_AU] = 14,
+	[KAN_AM] = 15,
+	[KAN_AHA] = 16,
+	[KAN_KA] = 17,
+	[KAN_KHA] = 18,
+	[KAN_GA] = 19,
+	[KAN_GHA] = 20,
+	[KAN_NYA] = 21,
+	[KAN_CHA] = 22,
+	[KAN_CHHA] = 23,
+	[KAN_JA] = 24,
+	[KAN_JHA] = 25,
+	[KAN_NYAA] = 26,
+	[KAN_TTA] = 27,
+	[KAN_TTHA] = 28,
+	[KAN_DDA] = 29,
+	[KAN_DDHA] = 30,
+	[KAN_GNA] = 31,
+	[KAN_TA] = 32,
+	[KAN_THA] = 33,
+	[KAN_DA] = 34,
+	[KAN_DHA] = 35,
+	[KAN_NA] = 36,
+	[KAN_PA] = 37,
+	[KAN_PHA] = 38,
+	[KAN_BA] = 39,
+	[KAN_BHA] = 40,
+	[KAN_MA] = 41,
+	[KAN_YA] = 42,
+	// KAN_RA has the same pattern as KAN_PA; the first entry wins
+	[KAN_LA] = 44,
+	[KAN_VA] = 45,
+	[KAN_SHA] = 46,
+	[KAN_SHHA] = 47,
+	[KAN_SA] = 48,
+	[KAN_HA] = 49,
+	[KAN_DLA] = 50,
+	[KAN_KSHA] = 51
+};
+
+script_t script_kannada = {
+	SCRIPT_KANNADA_LENGTH,
+	0,
+	SCRIPT_KANNADA_FILESET,
+	glyphs_kannada,
+	kannada_index
+}; 
@@ -0,0 +1,176 @@
+/**
+ * @file settings.c
+ * @brief Device settings kept on the SD card as keys and values. The
+ *        settings are read once at power on and kept in RAM; changes are
+ *        written back by settings_commit(), as a single sector, only when
+ *        something changed. The file is never resized and the two copies in
+ *        it (store.h) keep the settings safe if the power fails mid-write.
+ */
+
+#include <string.h>
+#include "Globals.h"
+#include "store.h"
+#include "settings.h"
+
+static struct file_stream settings_stream;
+static store_slot_t settings_slot;
+static bool settings_ready = false;
+static bool settings_dirty = false;
+
+// Entries: key, size, value; a 0 key ends the list
+static uint8_t settings_data[SETTINGS_DATA_SIZE];
+static uint8_t settings_length = 0;
+
+/**
+ * @brief Finds an entry
+ * @param key - uint8_t, key to look for
+ * @return int - offset of the entry in settings_data, -1 if there is none
+ */
+static int settings_find(uint8_t key)
+{
+  uint8_t offset = 0;
+
+  while(offset < settings_length)
+  {
+    if(settings_data[offset] == key)
+    {
+      return offset;
+    }
+    offset += 2 + settings_data[offset + 1];
+  }
+  return -1;
+}
+
+/**
+ * @brief Loads the settings from SETTINGS_FILE. Without the file, settings
+ *        still work but are lost at power off.
+ * @return bool - false if there are no saved settings
+ */
+bool settings_init(void)
+{
+  unsigned char file_name[FILE_NAME_LEN];
+  uint8_t offset = 0;
+  bool loaded;
+
+  settings_ready = false;
+  settings_dirty = false;
+  settings_length = 0;
+
+  strcpy((char*) file_name, SETTINGS_FILE);
+  if(!open_file_stream(&settings_stream, file_name) ||
+    settings_stream.size < 2 * STORE_SECTOR_SIZE)
+  {
+    PRINTF("[Settings] " SETTINGS_FILE " not found\n\r");
+    return false;
+  }
+  loaded = store_load(&settings_stream, 0, &settings_slot);
+  settings_ready = true;
+  if(!loaded)
+  {
+    PRINTF("[Settings] No saved settings\n\r");
+    return false;
+  }
+
+  // Keep the entries that fit; a damaged list is cut at the first bad entry
+  memcpy(settings_data, (void*) &buffer[STORE_DATA_OFFSET], SETTINGS_DATA_SIZE);
+  while(offset + 2 <= SETTINGS_DATA_SIZE && settings_data[offset] != SETTINGS_END
+    && offset + 2 + settings_data[offset + 1] <= SETTINGS_DATA_SIZE)
+  {
+    offset += 2 + settings_data[offset + 1];
+  }
+  settings_length = offset;
+
+  sprintf(dbgstr, "[Settings] Loaded %u bytes, copy %u\n\r", settings_length,
+    settings_slot.copy);
+  PRINTF(dbgstr);
+  return true;
+}
+
+/**
+ * @brief Reads a setting
+ * @param key - uint8_t, SETTINGS_* key
+ * @param value - void*, set to the value
+ * @param size - uint8_t, size of the value
+ * @return bool - false if the setting is not saved, or has another size
+ */
+bool settings_get(uint8_t key, void* value, uint8_t size)
+{
+  int offset = settings_find(key);
+
+  if(offset < 0 || settings_data[offset + 1] != size)
+  {
+    return false;
+  }
+  memcpy(value, &settings_data[offset + 2], size);
+  return true;
+}
+
+/**
+ * @brief Changes a setting in RAM. It is saved by the next settings_commit().
+ * @param key - uint8_t, SETTINGS_* key
+ * @param value - const void*, new value
+ * @param size - uint8_t, size of the value
+ * @return bool - false if there is no room for it
+ */
+bool settings_set(uint8_t key, const void* value, uint8_t size)
+{
+  int offset = settings_find(key);
+  uint8_t entry_size;
+
+  if(key == SETTINGS_END)
+  {
+    return false;
+  }
+
+  if(offset >= 0)
+  {
+    if(settings_data[offset + 1] == size &&
+      memcmp(&settings_data[offset + 2], value, size) == 0)
+    {
+      return true;
+    }
+    // Remove the old entry; the new one goes at the end
+    entry_size = 2 + settings_data[offset + 1];
+    memmove(&settings_data[offset], &settings_data[offset + entry_size],
+      settings_length - offset - entry_size);
+    settings_length -= entry_size;
+  }
+
+  if(settings_length + 2 + size > SETTINGS_DATA_SIZE)
+  {
+    PRINTF("[Settings] No room\n\r");
+    settings_dirty = true;
+    return false;
+  }
+  settings_data[settings_length] = key;
+  settings_data[settings_length + 1] = size;
+  memcpy(&settings_data[settings_length + 2], value, size);
+  settings_length += 2 + size;
+  settings_dirty = true;
+  return true;
+}
+
+/**
+ * @brief Saves the settings if they changed. Call at quiet moments, such as
+ *        when a mode starts or quits, rather than after every change.
+ * @return Void
+ */
+void settings_commit(void)
+{
+  if(!settings_ready || !settings_dirty)
+  {
+    return;
+  }
+  if(!store_prepare(&settings_stream, 0, &settings_slot))
+  {
+    PRINTF("[Settings] Cannot read " SETTINGS_FILE "\n\r");
+    return;
+  }
+  memcpy((void*) &buffer[STORE_DATA_OFFSET], settings_data, settings_length);
+  if(!store_commit(&settings_stream, &settings_slot))
+  {
+    PRINTF("[Settings] Cannot write " SETTINGS_FILE "\n\r");
+    return;
+  }
+  settings_dirty = false;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file settings.h
+ * @brief Device settings kept on the SD card as keys and values
+ */
+
+#ifndef _SETTINGS_H_
+#define _SETTINGS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Preallocated, zero-filled file of at least 2 sectors (see store.h)
+#define SETTINGS_FILE "SETTINGS.DAT"
+
+// Room for keys and values; each entry also takes 2 bytes
+#define SETTINGS_DATA_SIZE 64
+
+// Keys. 0 marks the end of the entries, so it is not a key.
+#define SETTINGS_END     0
+#define SETTINGS_VOLUME  1          // uint8_t, vs1053_get_vol()
+
+bool settings_init(void);
+bool settings_get(uint8_t key, void* value, uint8_t size);
+bool settings_set(uint8_t key, const void* value, uint8_t size);
+void settings_commit(void);
+
+#endif /* _SETTINGS_H_ */
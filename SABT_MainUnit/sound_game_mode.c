@@ -1,13 +1,15 @@
 /*
  * @file sound_game_mode.c
  *
- * @brief Shell for "sound game modes" (MD 3,11)
+ * @brief Shell for "sound game modes" (MD 3,11). The words and the clips that
+ *        go with them come from a word list on the SD card (words.h).
  * @author: Edward Cai
  */ 
 
 // Standard libraries
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 // Custom libraries
 #include "Globals.h"
@@ -18,13 +20,10 @@
 #include "letter_globals.h"
 #include "script_common.h"
 #include "script_english.h" 
+#include "words.h"
 #include "sound_game_mode.h"
 
-// Int array representing the animals that have been used already.
-static int sound_sources_used_list[11];
-// Keeps track of number of animals used in current rotation
-static int sound_sources_used;
-static char* sound_source;     // Name of current animal
+static words_entry_t sound_source;     // Current animal
 // Keeps track of how long the user entered word is
 int length_entered_word;
 // Used to read back the letters in the current word
@@ -41,101 +40,93 @@ static bool scrolled = false;
  * user_word - stores the word as it is being inputted
  * curr_word - stores the entire word
  */ 
-static glyph_t* user_glyph = NULL;
-static glyph_t* curr_glyph = NULL;
-static word_node_t* user_word = NULL;
-static word_node_t* curr_word = NULL;
+static const glyph_t* user_glyph = NULL;
+static const glyph_t* curr_glyph = NULL;
+static word_t user_word;
+static word_t curr_word;
 static script_t* this_script = &script_english;
-
-
-char **sound_source_list;
-char **sound_list;
+static script_t* word_script = &script_english;   // Script of the word list
 
 /*
 * @brief Plays sound_source sounds
-* @param char* sound_source - sound_source name
 * @param bool name - true if name requeste, false if sound requested
 * @return void
 */
-void play_sound(char* MODE_FILESET, char* sound_source, bool name) {
-  char filename[5];
-  for (int i = 0; i < MAX_INDEX; i++) {
-    if (strcmp(sound_source, sound_source_list[i]) == 0) {
-      // Match found
-      if (name)
-        sprintf(filename, "N%s", sound_list[i]);
-      else
-        sprintf(filename, "S%s", sound_list[i]);
-      play_mp3(MODE_FILESET, filename);
-    }
+void play_sound(bool name) {
+  char filename[WORDS_CLIP_SIZE + 2];
+
+  sprintf(filename, "%c%s", name ? 'N' : 'S', sound_source.clip);
+  play_mp3((char*) words_fileset(), filename);
+}
+
+/*
+* @brief Builds the glyphs of sound_source
+* @param word_t* curr_word - Word to fill
+* @return void
+*/
+static void sound_source_to_word(word_t* curr_word) {
+  reset_word(curr_word);
+  for (int i = 0; i < sound_source.length; i++) {
+    add_glyph_to_word(curr_word, search_script(word_script, sound_source.cells[i]));
   }
 }
 
 
 /**
- * @brief Based off of the internal timer (TCNT1) - we generate
- *        a psuedo-random number. Turn that into a number from 1 - MAX_INDEX
- *        which corresponds to 1 of MAX_INDEX different sound_sources. Check which
- *        sound_sources have been played already to be sure to play all of
- *        the different sound_sources before repeating the list.
- * @return int - number between 1 - MAX_INDEX corresponding to the sound_source file to play
+ * @brief Reads a random sound_source from the word list into sound_source.
+ *        Every sound_source is played once before the list repeats.
+ * @return bool - false if the word list could not be read
  */
-int choose_sound_source()
+bool choose_sound_source()
 {
-  int num = TCNT1;
-  int i;
-
-  num *= PRIME;
-  num = (abs(num) % MAX_INDEX);
+  uint16_t num = words_pick();
 
-  char buf[10];
-  sprintf(buf, "num=%i\r\n", num);
+  char buf[12];
+  sprintf(buf, "num=%u\r\n", num);
   PRINTF(buf);
 
-  while(sound_sources_used_list[num])
-  {
-    num = TCNT1;
-    num *= PRIME;
-    num = (abs(num) % MAX_INDEX);
-  }
+  return words_read(num, &sound_source);
+}
 
-  sound_sources_used_list[num] = 1;
+/**
+ * @brief Opens the word list, which MODES.DAT can change with "words=NAME",
+ *        and finds the script it is written in
+ * @param char* WORD_LIST - Word list to use when MODES.DAT names none
+ * @param script_t* SCRIPT_ADDRESS - Script to use if the list's is unknown
+ * @return void
+ */
+static void open_word_list(const char* WORD_LIST, script_t* SCRIPT_ADDRESS)
+{
+  const char* name = ui_current_mode_options()->words;
+  char language[WORDS_FILESET_SIZE + 1];
 
-  for(i = 0; i < MAX_INDEX; i ++)
-  {
-    sprintf(buf, "arr=%i, ",sound_sources_used_list[i] );
-    PRINTF(buf);
+  if (name[0] == '\0') {
+    name = WORD_LIST;
   }
-
-  TX_NEWLINE_PC;
-  sprintf(buf, "cnt=%i", sound_sources_used +1);
-  PRINTF(buf);
-  TX_NEWLINE_PC;
-
-  // increment sound_sources_used until we've used all MAX_INDEX sound_sources then reset everything
-  sound_sources_used++;
-  if (sound_sources_used == MAX_INDEX)
-  {
-    sound_sources_used = 0;
-    for (i = 0; i < MAX_INDEX; i++)
-      sound_sources_used_list[i] = 0;
+  word_script = SCRIPT_ADDRESS;
+  if (!words_open(name)) {
+    return;
   }
 
-  return num;
+  // "ENG_" names the same script as the option lang=ENG
+  strcpy(language, words_language());
+  strtok(language, "_");
+  if (find_language_script(language) != NULL) {
+    word_script = find_language_script(language);
+  }
 }
 
-void sound_game_reset(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FILESET, const char** SOUND_SOURCE_LIST, const char** SOUND_LIST)
+void sound_game_reset(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FILESET, const char* WORD_LIST)
 {
   set_mode_globals(SCRIPT_ADDRESS, LANG_FILESET, MODE_FILESET);
-  sound_list = (char**) SOUND_LIST;
-  sound_source_list = (char**) SOUND_SOURCE_LIST;
+  open_word_list(WORD_LIST, SCRIPT_ADDRESS);
   next_state = STATE_MENU;
   submode = SUBMODE_NULL;
   incorrect_tries = 0;
   user_glyph = NULL;
   curr_glyph = NULL;
-  user_word = free_word(user_word);
-  curr_word = free_word(curr_word);
+  reset_word(&user_word);
+  reset_word(&curr_word);
   cell = 0;
   cell_pattern = 0;
   cell_control = 0;
@@ -191,11 +182,16 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 	case STATE_GENQUES:
 	  length_entered_word = 0;
 	  current_word_index = 0;
-	  sound_source = sound_source_list[choose_sound_source()];
+	  if (!choose_sound_source()) {
+		  PRINTF("[MD3] Could not read the word list\n\r");
+		  play_mp3(lang_fileset, MP3_INVALID_PATTERN);
+		  quit_mode();
+		  break;
+	  }
 	  user_glyph = NULL;
 	  curr_glyph = NULL;
-      user_word = free_word(user_word);
-	  curr_word = free_word(curr_word);
+      reset_word(&user_word);
+	  reset_word(&curr_word);
 	  next_state = STATE_PROMPT;
 	  break;
 	  
@@ -204,12 +200,12 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 	  {
         case SUBMODE_PLAY:
 		  play_mp3(MODE_FILESET, "PLSA");
-		  play_sound(MODE_FILESET, sound_source, false);
+		  play_sound(false);
 		  break;
 		
 		case SUBMODE_LEARN:
 	      play_mp3(MODE_FILESET, "PLSB");
-		  play_sound(MODE_FILESET, sound_source, true);
+		  play_sound(true);
 		  break;
 	    
 		default:
@@ -232,7 +228,7 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 	cell_control = GET_CELL_CONTROL(cell);
 	switch (cell_control) {
 		case WITH_ENTER:
-		user_glyph = search_script(this_script, cell_pattern);
+		user_glyph = search_script(word_script, cell_pattern);
 		next_state = STATE_CHECK;
 		PRINTF("[MD3] Checking answer\n\r");
 		break;
@@ -248,13 +244,13 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 	break;
 
 	case STATE_CHECK:
-		curr_glyph = search_script(this_script, get_bits_from_letter(sound_source[length_entered_word]));
+		curr_glyph = search_script(word_script, sound_source.cells[length_entered_word]);
 		if (glyph_equals(curr_glyph, user_glyph)) {
 			play_glyph(curr_glyph);
 			incorrect_tries = 0;
 			length_entered_word++;
-			user_word = add_glyph_to_word(user_word, user_glyph);
-			if(length_entered_word != strlen(sound_source)) {
+			add_glyph_to_word(&user_word, user_glyph);
+			if(length_entered_word != sound_source.length) {
 			  play_mp3(lang_fileset, "GOOD");
 			  next_state = STATE_INPUT;
 			} else { 
@@ -262,14 +258,14 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 			  play_mp3(lang_fileset, "NCWK");
 			  switch (submode){
 				  case SUBMODE_LEARN:
-				  play_sound(MODE_FILESET, sound_source, true);
+				  play_sound(true);
 				  play_mp3(MODE_FILESET, "SAYS");
-				  play_sound(MODE_FILESET, sound_source, false);
+				  play_sound(false);
 				  break;
 				  
 				  case SUBMODE_PLAY:
-				  play_word(user_word);
-				  play_sound(MODE_FILESET, sound_source, true);
+				  play_word(&user_word);
+				  play_sound(true);
 			  }
 			  next_state = STATE_GENQUES;
 			}
@@ -279,12 +275,12 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 			PRINTF("[MD3] User answered incorrectly\n\r");
 			play_mp3(lang_fileset, "NO");
 			play_mp3(lang_fileset, MP3_TRY_AGAIN);
-			play_word(user_word);
+			play_word(&user_word);
 			if (incorrect_tries == MAX_INCORRECT_TRIES_1) {
 				play_mp3(MODE_FILESET, "PLWR");
-				play_sound(MODE_FILESET, sound_source, true);
-				curr_word = word_to_glyph_word(this_script, sound_source);
-				play_word(curr_word);
+				play_sound(true);
+				sound_source_to_word(&curr_word);
+				play_word(&curr_word);
 			} else if (incorrect_tries >= 6) {
 				play_glyph(curr_glyph);
 				play_mp3(MODE_FILESET, "PRSS");
@@ -319,16 +315,19 @@ void sound_game_main(script_t* SCRIPT_ADDRESS, char* LANG_FILESET, char* MODE_FI
 			PRINTF("[MD3] Next sound_source");
 			length_entered_word = 0;
 			current_word_index = 0;
-			sound_source = sound_source_list[choose_sound_source()];
-			user_word = NULL;
+			if (!choose_sound_source()) {
+				next_state = STATE_GENQUES;
+				break;
+			}
+			reset_word(&user_word);
 			switch(submode)
 			{
 				case SUBMODE_PLAY:
-				play_sound(MODE_FILESET, sound_source, false);
+				play_sound(false);
 				break;
 				
 				case SUBMODE_LEARN:
-				play_sound(MODE_FILESET, sound_source, true);
+				play_sound(true);
 				break;
 				
 				default:
@@ -17,8 +17,6 @@
 #define STATE_CHECK    0x05
 #define STATE_REPROMPT 0x06
 
-#define PRIME          	53
-
 // Submode constants
 #define SUBMODE_NULL 0x00
 #define SUBMODE_PLAY 0x01
@@ -27,12 +25,11 @@
 #define MAX_INCORRECT_TRIES_1 3
 #define MAX_INCORRECT_TRIES_2 6
 
-#define MAX_INDEX 11
 
 
 
 void sound_game_main(script_t* new_script, char* new_lang_fileset, char* new_mode_fileset);
-void sound_game_reset(script_t* new_script, char* new_lang_fileset, char* new_mode_fileset, char const *SOUND_LIST[], char const *SOUND_SOURCE_LIST[]);
+void sound_game_reset(script_t* new_script, char* new_lang_fileset, char* new_mode_fileset, const char* word_list);
 
 #endif 
 
@@ -0,0 +1,168 @@
+/**
+ * @file store.c
+ * @brief Crash-safe storage of one sector of data. Two sectors hold copies
+ *        with a sequence number and a CRC. A save always writes the older
+ *        copy, so a write cut off by a brownout only spoils that copy and the
+ *        other one is still there to load.
+ *
+ *        The data is built in the shared SD buffer: store_prepare() clears it,
+ *        the caller copies its data in at STORE_DATA_OFFSET and store_commit()
+ *        writes it out.
+ */
+
+#include <string.h>
+#include "Globals.h"
+#include "store.h"
+
+/**
+ * @brief CRC of a copy in the SD buffer
+ * @return uint16_t - CRC of everything before STORE_CRC_OFFSET
+ */
+static uint16_t store_crc(void)
+{
+  uint16_t crc = UI_CRC_INIT;
+  uint16_t i;
+
+  for(i = 0; i < STORE_CRC_OFFSET; i++)
+  {
+    crc = ui_crc_update(crc, buffer[i]);
+  }
+  return crc;
+}
+
+/**
+ * @brief Reads a little endian number from the SD buffer
+ * @param offset - uint16_t, position of the low byte
+ * @param size - uint8_t, number of bytes
+ * @return uint32_t - value
+ */
+static uint32_t store_get(uint16_t offset, uint8_t size)
+{
+  uint32_t value = 0;
+
+  while(size-- > 0)
+  {
+    value = (value << 8) | buffer[offset + size];
+  }
+  return value;
+}
+
+/**
+ * @brief Writes a little endian number to the SD buffer
+ * @param offset - uint16_t, position of the low byte
+ * @param size - uint8_t, number of bytes
+ * @param value - uint32_t, value
+ * @return Void
+ */
+static void store_put(uint16_t offset, uint8_t size, uint32_t value)
+{
+  while(size-- > 0)
+  {
+    buffer[offset++] = value & 0xFF;
+    value >>= 8;
+  }
+}
+
+/**
+ * @brief Reads one copy and checks it
+ * @param stream - struct file_stream*, preallocated file
+ * @param sector - uint32_t, sector of the copy in the file
+ * @param sequence - uint32_t*, set to the sequence number of a valid copy
+ * @return bool - true if the copy is valid; it is left in the SD buffer
+ */
+static bool store_read_copy(struct file_stream* stream, uint32_t sector,
+  uint32_t* sequence)
+{
+  if(!seek_file_stream(stream, sector * STORE_SECTOR_SIZE) ||
+    buffer[0] != STORE_MAGIC_0 || buffer[1] != STORE_MAGIC_1 ||
+    store_crc() != store_get(STORE_CRC_OFFSET, 2))
+  {
+    return false;
+  }
+  *sequence = store_get(2, 4);
+  return *sequence != 0;
+}
+
+/**
+ * @brief Loads the newest valid copy into the SD buffer
+ * @param stream - struct file_stream*, preallocated file
+ * @param sector - uint32_t, first of the two sectors in the file
+ * @param slot - store_slot_t*, set to the copy loaded
+ * @return bool - false if neither copy is valid; the SD buffer is then
+ *         cleared and the next save writes the first copy
+ */
+bool store_load(struct file_stream* stream, uint32_t sector,
+  store_slot_t* slot)
+{
+  uint32_t first = 0;
+  uint32_t second = 0;
+  bool first_valid = store_read_copy(stream, sector, &first);
+  bool second_valid = store_read_copy(stream, sector + 1, &second);
+
+  // Sequence numbers are compared so that they may wrap around
+  if(second_valid && (!first_valid || (int32_t) (second - first) > 0))
+  {
+    slot->sequence = second;
+    slot->copy = 1;
+    return true;
+  }
+
+  slot->sequence = first;
+  slot->copy = first_valid ? 0 : 1;
+  if(first_valid)
+  {
+    return store_read_copy(stream, sector, &first);
+  }
+  memset((void*) buffer, 0, STORE_SECTOR_SIZE);
+  return false;
+}
+
+/**
+ * @brief Starts a save: reads the older copy so its place on the card is
+ *        known, and clears the SD buffer for the new data
+ * @param stream - struct file_stream*, preallocated file
+ * @param sector - uint32_t, first of the two sectors in the file
+ * @param slot - const store_slot_t*, copy loaded or saved last
+ * @return bool - false if the card could not be read
+ */
+bool store_prepare(struct file_stream* stream, uint32_t sector,
+  const store_slot_t* slot)
+{
+  if(!seek_file_stream(stream, (sector + 1 - slot->copy) * STORE_SECTOR_SIZE))
+  {
+    return false;
+  }
+  memset((void*) buffer, 0, STORE_SECTOR_SIZE);
+  return true;
+}
+
+/**
+ * @brief Finishes a save started by store_prepare(): stamps the data in the
+ *        SD buffer with the next sequence number and its CRC and writes it
+ *        over the older copy
+ * @param stream - struct file_stream*, stream passed to store_prepare()
+ * @param slot - store_slot_t*, updated to the copy written
+ * @return bool - false if the card could not be written
+ */
+bool store_commit(struct file_stream* stream, store_slot_t* slot)
+{
+  uint32_t sequence = slot->sequence + 1;
+
+  if(sequence == 0)
+  {
+    sequence = 1;
+  }
+  buffer[0] = STORE_MAGIC_0;
+  buffer[1] = STORE_MAGIC_1;
+  store_put(2, 4, sequence);
+  store_put(STORE_CRC_OFFSET, 2, store_crc());
+
+  if(sd_write_single_block(get_first_sector(stream->cluster) +
+    stream->sector - 1) != 0)
+  {
+    return false;
+  }
+  slot->sequence = sequence;
+  slot->copy = 1 - slot->copy;
+  return true;
+}
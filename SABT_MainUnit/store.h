@@ -0,0 +1,36 @@
+/**
+ * @file store.h
+ * @brief Crash-safe storage of one sector of data in a pair of sectors of a
+ *        preallocated file
+ */
+
+#ifndef _STORE_H_
+#define _STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Each copy: magic, sequence number (4 bytes, low byte first), data, and a
+// CRC-16/CCITT of everything before it in the last 2 bytes of the sector
+#define STORE_MAGIC_0 'S'
+#define STORE_MAGIC_1 'T'
+#define STORE_SECTOR_SIZE 512
+#define STORE_DATA_OFFSET 6
+#define STORE_CRC_OFFSET (STORE_SECTOR_SIZE - 2)
+#define STORE_DATA_SIZE (STORE_CRC_OFFSET - STORE_DATA_OFFSET)
+
+// Which copy is newest
+typedef struct store_slot {
+  uint32_t sequence;                // 0 if neither copy is valid
+  uint8_t copy;                     // 0 or 1
+} store_slot_t;
+
+struct file_stream;
+
+bool store_load(struct file_stream* stream, uint32_t sector,
+  store_slot_t* slot);
+bool store_prepare(struct file_stream* stream, uint32_t sector,
+  const store_slot_t* slot);
+bool store_commit(struct file_stream* stream, store_slot_t* slot);
+
+#endif /* _STORE_H_ */
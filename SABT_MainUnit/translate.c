@@ -0,0 +1,569 @@
+/**
+ * @file translate.c
+ * @brief Text to braille translation for English, uncontracted (Grade 1) or
+ *        contracted (Grade 2). Letters and digits come from the English and
+ *        digit scripts; contractions come from a rule file on the SD card that
+ *        is opened once per text and streamed once per word, so no rule table
+ *        is kept in RAM.
+ */
+
+#include <avr/pgmspace.h>
+#include <ctype.h>
+#include <string.h>
+#include "Globals.h"
+#include "glyph.h"
+#include "script_english.h"
+#include "script_digits.h"
+#include "translate.h"
+
+// Best rule found so far starting at each letter of the current word
+typedef struct translate_match {
+  unsigned char length;             // Letters covered, 0 if no rule matched
+  unsigned char num_cells;
+  char cells[TRANSLATE_MAX_RULE_CELLS];
+} translate_match_t;
+
+static translate_match_t translate_matches[TRANSLATE_MAX_WORD];
+
+// Punctuation marks and their cells
+static const char translate_punctuation[][2] PROGMEM = {
+  {',',  0b000010},
+  {';',  0b000110},
+  {':',  0b010010},
+  {'.',  0b110010},
+  {'!',  0b010110},
+  {'?',  0b100110},
+  {'\'', 0b000100},
+  {'-',  0b100100}
+};
+
+#define TRANSLATE_NUM_PUNCTUATION \
+  (sizeof(translate_punctuation) / sizeof(translate_punctuation[0]))
+
+static char* translate_cells;
+static int translate_length;
+static int translate_max;
+
+// Rule file, opened by translate_text and rewound for each word
+static struct file_stream translate_rules;
+static bool translate_rules_open;
+
+/**
+ * @brief Appends a cell to the output, keeping room for END_OF_TEXT
+ * @param cell - char, cell pattern
+ * @return bool - false if the output is full
+ */
+static bool translate_emit(char cell)
+{
+  if(translate_length >= translate_max - 1)
+  {
+    return false;
+  }
+  translate_cells[translate_length++] = cell;
+  return true;
+}
+
+/**
+ * @brief Cell for a lower case letter. The English script is in
+ *        alphabetical order.
+ * @param letter - char, 'a' to 'z'
+ * @return char - cell pattern
+ */
+static char translate_letter_cell(char letter)
+{
+  return glyph_pattern(&script_english.glyphs[letter - 'a']);
+}
+
+/**
+ * @brief Cell for a punctuation mark
+ * @param c - char, character to look up
+ * @return char - cell pattern, END_OF_TEXT if not supported
+ */
+static char translate_punctuation_cell(char c)
+{
+  unsigned char i;
+
+  for(i = 0; i < TRANSLATE_NUM_PUNCTUATION; i++)
+  {
+    if(pgm_read_byte(&translate_punctuation[i][0]) == c)
+    {
+      return pgm_read_byte(&translate_punctuation[i][1]);
+    }
+  }
+  return (char) END_OF_TEXT;
+}
+
+/**
+ * @brief Punctuation mark written with a cell
+ * @param cell - char, cell pattern
+ * @return char - punctuation mark, '\0' if the cell is not one
+ */
+char translate_punctuation_char(char cell)
+{
+  unsigned char i;
+
+  for(i = 0; i < TRANSLATE_NUM_PUNCTUATION; i++)
+  {
+    if(pgm_read_byte(&translate_punctuation[i][1]) == cell)
+    {
+      return pgm_read_byte(&translate_punctuation[i][0]);
+    }
+  }
+  return '\0';
+}
+
+/**
+ * @brief Translates a word one character at a time: digits after a number
+ *        sign, capitals marked per letter (or once for an all capital word)
+ *        and supported punctuation
+ * @param word - const char*, characters of the word
+ * @param length - int, number of characters
+ * @return bool - false if a character is not supported or the output is full
+ */
+static bool translate_uncontracted(const char* word, int length)
+{
+  bool number_mode = false;
+  bool caps_word = length > 1;
+  char cell;
+  int i;
+
+  for(i = 0; i < length; i++)
+  {
+    if(!isupper((unsigned char) word[i]))
+    {
+      caps_word = false;
+    }
+  }
+  if(caps_word && (!translate_emit(TRANSLATE_CAPITAL_SIGN) ||
+    !translate_emit(TRANSLATE_CAPITAL_SIGN)))
+  {
+    return false;
+  }
+
+  for(i = 0; i < length; i++)
+  {
+    char c = word[i];
+
+    if(isdigit((unsigned char) c))
+    {
+      if(!number_mode && !translate_emit(NUMSIGN))
+      {
+        return false;
+      }
+      number_mode = true;
+      // 1-9 are written as a-i and 0 as j
+      cell = translate_letter_cell(c == '0' ? 'j' : c - '1' + 'a');
+    }
+    else if(isalpha((unsigned char) c))
+    {
+      char letter = tolower((unsigned char) c);
+
+      // a-j straight after a number would be read as digits
+      if(number_mode && letter <= 'j' && !translate_emit(TRANSLATE_GRADE_1_SIGN))
+      {
+        return false;
+      }
+      number_mode = false;
+      if(!caps_word && isupper((unsigned char) c) &&
+        !translate_emit(TRANSLATE_CAPITAL_SIGN))
+      {
+        return false;
+      }
+      cell = translate_letter_cell(letter);
+    }
+    else
+    {
+      number_mode = false;
+      cell = translate_punctuation_cell(c);
+      if(cell == (char) END_OF_TEXT)
+      {
+        return false;
+      }
+    }
+
+    if(!translate_emit(cell))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Value of a hexadecimal digit
+ * @param c - char, '0'-'9' or 'A'-'F'
+ * @return int - 0 to 15, -1 if c is not a hex digit
+ */
+static int translate_hex_value(char c)
+{
+  if(c >= '0' && c <= '9') return c - '0';
+  if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * @brief Reads one line of the rule file, dropping the line ending. Lines
+ *        longer than the buffer are cut short.
+ * @param stream - struct file_stream*, open rule file
+ * @param line - char*, buffer of TRANSLATE_MAX_RULE_LINE characters
+ * @return bool - false at the end of the file
+ */
+static bool translate_read_line(struct file_stream* stream, char* line)
+{
+  int c;
+  int n = 0;
+
+  while((c = read_file_stream(stream)) >= 0 && c != '\n')
+  {
+    if(c != '\r' && n < TRANSLATE_MAX_RULE_LINE - 1)
+    {
+      line[n++] = c;
+    }
+  }
+  line[n] = '\0';
+  return c >= 0 || n > 0;
+}
+
+/**
+ * @brief Splits a rule line into its parts
+ * @param line - char*, rule line "<where> <letters> <cells>"
+ * @param rule - translate_rule_t*, filled in from the line
+ * @return bool - false for comments, blank lines and malformed rules
+ */
+static bool translate_parse_rule(char* line, translate_rule_t* rule)
+{
+  char* text = line + 2;
+  char* hex;
+  int text_length;
+
+  if(line[0] == '#' || line[0] == '\0' || line[1] != ' ')
+  {
+    return false;
+  }
+  rule->where = line[0];
+
+  hex = strchr(text, ' ');
+  if(hex == NULL)
+  {
+    return false;
+  }
+  text_length = hex - text;
+  if(text_length == 0 || text_length > TRANSLATE_MAX_RULE_TEXT)
+  {
+    return false;
+  }
+  memcpy(rule->text, text, text_length);
+  rule->text[text_length] = '\0';
+  rule->text_length = text_length;
+
+  rule->num_cells = 0;
+  for(hex++; hex[0] != '\0' && hex[1] != '\0'; hex += 2)
+  {
+    int high = translate_hex_value(hex[0]);
+    int low = translate_hex_value(hex[1]);
+
+    if(high < 0 || low < 0 || rule->num_cells == TRANSLATE_MAX_RULE_CELLS)
+    {
+      return false;
+    }
+    rule->cells[rule->num_cells++] = (high << 4) | low;
+  }
+  return rule->num_cells > 0;
+}
+
+/**
+ * @brief Opens TRANSLATE_RULES_FILE for reading with translate_next_rule
+ * @param stream - struct file_stream*, stream to open
+ * @return bool - false if the file is not on the card
+ */
+bool translate_open_rules(struct file_stream* stream)
+{
+  unsigned char file_name[FILE_NAME_LEN];
+
+  strcpy((char*) file_name, TRANSLATE_RULES_FILE);
+  return open_file_stream(stream, file_name);
+}
+
+/**
+ * @brief Reads the next rule from the rule file, skipping comments and
+ *        malformed lines
+ * @param stream - struct file_stream*, stream from translate_open_rules
+ * @param rule - translate_rule_t*, filled in with the rule
+ * @return bool - false at the end of the file
+ */
+bool translate_next_rule(struct file_stream* stream, translate_rule_t* rule)
+{
+  char line[TRANSLATE_MAX_RULE_LINE];
+
+  while(translate_read_line(stream, line))
+  {
+    if(translate_parse_rule(line, rule))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Positions in a word where a rule may start
+ * @param where - char, rule position code
+ * @param rule_length - int, letters (or cells) the rule covers
+ * @param word_length - int, letters (or cells) in the word
+ * @param first - int*, set to the first allowed position
+ * @param last - int*, set to the last allowed position
+ * @return bool - false if the rule cannot apply to the word at all
+ */
+bool translate_rule_range(char where, int rule_length, int word_length,
+  int* first, int* last)
+{
+  if(rule_length > word_length)
+  {
+    return false;
+  }
+
+  switch(where)
+  {
+    case 'w':   // Whole word only
+      if(rule_length != word_length) return false;
+      *first = 0;
+      *last = 0;
+      break;
+    case 'a':   // Anywhere
+      *first = 0;
+      *last = word_length - rule_length;
+      break;
+    case 'm':   // Not touching either end of the word
+      *first = 1;
+      *last = word_length - rule_length - 1;
+      break;
+    case 'n':   // Not at the start of the word
+      *first = 1;
+      *last = word_length - rule_length;
+      break;
+    default:
+      return false;
+  }
+  return *first <= *last;
+}
+
+/**
+ * @brief Records a rule at every position of the word where it applies and
+ *        is longer than what was found there before
+ * @param rule - const translate_rule_t*, rule from the rule file
+ * @param word - const char*, lower case word
+ * @param length - int, letters in the word
+ * @return Void
+ */
+static void translate_apply_rule(const translate_rule_t* rule,
+  const char* word, int length)
+{
+  int pos, first, last;
+
+  if(!translate_rule_range(rule->where, rule->text_length, length,
+    &first, &last))
+  {
+    return;
+  }
+
+  for(pos = first; pos <= last; pos++)
+  {
+    if(rule->text_length > translate_matches[pos].length &&
+      strncmp(word + pos, rule->text, rule->text_length) == 0)
+    {
+      translate_matches[pos].length = rule->text_length;
+      translate_matches[pos].num_cells = rule->num_cells;
+      memcpy(translate_matches[pos].cells, rule->cells, rule->num_cells);
+    }
+  }
+}
+
+/**
+ * @brief Contracts a lower case word with the rules in TRANSLATE_RULES_FILE.
+ *        The rule file is read through once, recording the longest rule that applies
+ *        at each letter; the word is then written left to right taking the
+ *        recorded rule wherever there is one.
+ * @param word - const char*, lower case letters
+ * @param length - int, number of letters, at most TRANSLATE_MAX_WORD
+ * @return bool - false if the rules cannot be read or the output is full
+ */
+static bool translate_contracted(const char* word, int length)
+{
+  translate_rule_t rule;
+  int pos, i;
+
+  if(!translate_rules_open || !seek_file_stream(&translate_rules, 0))
+  {
+    return false;
+  }
+
+  memset(translate_matches, 0, sizeof(translate_matches));
+  while(translate_next_rule(&translate_rules, &rule))
+  {
+    translate_apply_rule(&rule, word, length);
+  }
+
+  for(pos = 0; pos < length; )
+  {
+    if(translate_matches[pos].length == 0)
+    {
+      if(!translate_emit(translate_letter_cell(word[pos])))
+      {
+        return false;
+      }
+      pos++;
+      continue;
+    }
+
+    for(i = 0; i < translate_matches[pos].num_cells; i++)
+    {
+      if(!translate_emit(translate_matches[pos].cells[i]))
+      {
+        return false;
+      }
+    }
+    pos += translate_matches[pos].length;
+  }
+  return true;
+}
+
+/**
+ * @brief Translates one word (no spaces). Grade 2 contracts words made only
+ *        of letters that are lower case, capitalised or all capitals; any
+ *        other word is written uncontracted.
+ * @param word - const char*, characters of the word
+ * @param length - int, number of characters
+ * @param grade - char, TRANSLATE_GRADE_1 or TRANSLATE_GRADE_2
+ * @return bool - false if the word cannot be translated or the output is full
+ */
+static bool translate_word(const char* word, int length, char grade)
+{
+  char lower[TRANSLATE_MAX_WORD];
+  int uppers = 0;
+  int start = translate_length;
+  int i;
+
+  if(length == 0)
+  {
+    return true;
+  }
+  if(grade != TRANSLATE_GRADE_2 || length > TRANSLATE_MAX_WORD)
+  {
+    return translate_uncontracted(word, length);
+  }
+
+  for(i = 0; i < length; i++)
+  {
+    if(!isalpha((unsigned char) word[i]))
+    {
+      return translate_uncontracted(word, length);
+    }
+    if(isupper((unsigned char) word[i]))
+    {
+      uppers++;
+    }
+    lower[i] = tolower((unsigned char) word[i]);
+  }
+
+  // Capitals inside a word are only handled letter by letter
+  if(uppers > 1 && uppers < length)
+  {
+    return translate_uncontracted(word, length);
+  }
+  if(uppers > 0 && uppers < length && !isupper((unsigned char) word[0]))
+  {
+    return translate_uncontracted(word, length);
+  }
+
+  // A letter on its own would be read as the word it stands for
+  if(length == 1 && lower[0] != 'a' && lower[0] != 'i' && lower[0] != 'o' &&
+    !translate_emit(TRANSLATE_GRADE_1_SIGN))
+  {
+    return false;
+  }
+
+  if(uppers > 0 && !translate_emit(TRANSLATE_CAPITAL_SIGN))
+  {
+    return false;
+  }
+  if(uppers > 1 && !translate_emit(TRANSLATE_CAPITAL_SIGN))
+  {
+    return false;
+  }
+
+  if(translate_contracted(lower, length))
+  {
+    return true;
+  }
+
+  // No rule file - fall back to uncontracted braille
+  translate_length = start;
+  return translate_uncontracted(word, length);
+}
+
+/**
+ * @brief Translates text to braille cells. Words are separated by single
+ *        blank cells and the result is terminated with END_OF_TEXT, so it can
+ *        be decoded with get_glyph like io_line.
+ * @param text - const char*, text to translate
+ * @param grade - char, TRANSLATE_GRADE_1 or TRANSLATE_GRADE_2
+ * @param cells - char*, buffer for the cell patterns
+ * @param max_cells - int, size of cells including the END_OF_TEXT
+ * @return int - number of cells before END_OF_TEXT, -1 if the text contains
+ *               unsupported characters or does not fit
+ */
+int translate_text(const char* text, char grade, char* cells, int max_cells)
+{
+  int start, end, first, last;
+
+  if(max_cells < 1)
+  {
+    return -1;
+  }
+
+  translate_cells = cells;
+  translate_length = 0;
+  translate_max = max_cells;
+
+  // Finding the rule file scans the root directory, so it is done once here
+  translate_rules_open = grade == TRANSLATE_GRADE_2 &&
+    translate_open_rules(&translate_rules);
+
+  for(start = 0; text[start] != '\0'; start = end)
+  {
+    if(text[start] == ' ')
+    {
+      if(!translate_emit(NO_DOTS))
+      {
+        return -1;
+      }
+      end = start + 1;
+      continue;
+    }
+
+    for(end = start; text[end] != '\0' && text[end] != ' '; end++);
+
+    // Punctuation around a word is written separately so the word itself
+    // can still be contracted
+    first = start;
+    last = end;
+    while(first < last && ispunct((unsigned char) text[first]))
+    {
+      first++;
+    }
+    while(last > first && ispunct((unsigned char) text[last - 1]))
+    {
+      last--;
+    }
+
+    if(!translate_uncontracted(text + start, first - start) ||
+      !translate_word(text + first, last - first, grade) ||
+      !translate_uncontracted(text + last, end - last))
+    {
+      return -1;
+    }
+  }
+
+  cells[translate_length] = END_OF_TEXT;
+  return translate_length;
+}
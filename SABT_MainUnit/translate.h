@@ -0,0 +1,46 @@
+/**
+ * @file translate.h
+ * @brief Text to braille translation for English, uncontracted (Grade 1) or
+ *        contracted (Grade 2)
+ */
+
+#ifndef _TRANSLATE_H_
+#define _TRANSLATE_H_
+
+#include <stdbool.h>
+
+#define TRANSLATE_GRADE_1 1
+#define TRANSLATE_GRADE_2 2
+
+// Contraction rules on the SD card; see the header of the file for the format
+#define TRANSLATE_RULES_FILE "ENG_G2.DAT"
+
+// Longer words are translated letter by letter
+#define TRANSLATE_MAX_WORD 32
+#define TRANSLATE_MAX_RULE_TEXT 12
+#define TRANSLATE_MAX_RULE_CELLS 2
+#define TRANSLATE_MAX_RULE_LINE 40
+
+// Indicators
+#define TRANSLATE_CAPITAL_SIGN 0b100000
+#define TRANSLATE_GRADE_1_SIGN 0b110000
+
+// One line of the rule file
+typedef struct translate_rule {
+  char where;                       // w, a, m or n
+  unsigned char text_length;
+  char text[TRANSLATE_MAX_RULE_TEXT + 1];
+  unsigned char num_cells;
+  char cells[TRANSLATE_MAX_RULE_CELLS];
+} translate_rule_t;
+
+struct file_stream;
+
+int translate_text(const char* text, char grade, char* cells, int max_cells);
+char translate_punctuation_char(char cell);
+bool translate_open_rules(struct file_stream* stream);
+bool translate_next_rule(struct file_stream* stream, translate_rule_t* rule);
+bool translate_rule_range(char where, int rule_length, int word_length,
+  int* first, int* last);
+
+#endif /* _TRANSLATE_H_ */
@@ -0,0 +1,298 @@
+/**
+ * @file user.c
+ * @brief Users of the device. USERS.DAT maps login codes to user numbers;
+ *        each user's state lives in the header sector of their log file, so
+ *        logging in reads one sector and the state is only written back with
+ *        the log when a mode quits.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Globals.h"
+#include "user.h"
+
+unsigned char user_current = USER_NONE;
+static user_state_t user_state;
+
+/**
+ * @brief Cell pattern written as dot numbers
+ * @param token - const char*, e.g. "145"
+ * @return char - cell pattern, 0 if token has anything but dots 1 to 6
+ */
+static char user_token_cell(const char* token)
+{
+  char cell = 0;
+
+  for(; *token != '\0'; token++)
+  {
+    if(*token < '1' || *token > '6')
+    {
+      return 0;
+    }
+    cell |= 1 << (*token - '1');
+  }
+  return cell;
+}
+
+/**
+ * @brief Looks a login code up in USER_FILE. # starts a comment.
+ * @param code - const char*, cell patterns of the code
+ * @param length - unsigned char, number of cells
+ * @return unsigned char - user number, USER_NONE if no user has the code
+ */
+unsigned char user_find(const char* code, unsigned char length)
+{
+  unsigned char file_name[FILE_NAME_LEN];
+  struct file_stream stream;
+  char token[USER_MAX_TOKEN + 1];
+  unsigned char token_length = 0;
+  int user = -1;                      // User on this line, -1 before it
+  unsigned char cells = 0;            // Cells of the code matched so far
+  bool match = true;
+  bool comment = false;
+  int c;
+
+  strcpy((char*) file_name, USER_FILE);
+  if(!open_file_stream(&stream, file_name))
+  {
+    PRINTF("[User] " USER_FILE " not found\n\r");
+    return USER_NONE;
+  }
+
+  do
+  {
+    c = read_file_stream(&stream);
+    if(c == '#')
+    {
+      comment = true;
+    }
+    if(c >= 0 && c != '\n' && c != '\r' && c != ' ' && c != '\t' && !comment)
+    {
+      if(token_length < USER_MAX_TOKEN)
+      {
+        token[token_length++] = c;
+      }
+      else
+      {
+        match = false;
+      }
+      continue;
+    }
+
+    if(token_length > 0)
+    {
+      token[token_length] = '\0';
+      token_length = 0;
+      if(user < 0)
+      {
+        user = (strspn(token, "0123456789") == strlen(token)) ?
+          atoi(token) : USER_NONE;
+      }
+      else if(cells >= length || user_token_cell(token) != code[cells])
+      {
+        match = false;
+      }
+      else
+      {
+        cells++;
+      }
+    }
+
+    if(c == '\n' || c < 0)
+    {
+      if(match && user >= 0 && user <= USERLOG_MAX_USER && cells == length)
+      {
+        return user;
+      }
+      user = -1;
+      cells = 0;
+      match = true;
+      comment = false;
+    }
+  } while(c >= 0);
+
+  return USER_NONE;
+}
+
+/**
+ * @brief Logs a user in, ending the session of the user before. Loads the
+ *        user's state with their log and restores their volume.
+ * @param user - unsigned char, user number
+ * @return Void
+ */
+void user_login(unsigned char user)
+{
+  userlog_open(user, &user_state, sizeof(user_state));
+  user_current = user;
+  if(user_state.volume != 0)
+  {
+    vs1053_set_vol(user_state.volume);
+  }
+  sprintf(dbgstr, "[User] Logged in user %u\n\r", user);
+  PRINTF(dbgstr);
+}
+
+/**
+ * @brief Logs the current user out; the guest is logged in instead
+ * @return Void
+ */
+void user_logout(void)
+{
+  user_login(USER_GUEST);
+}
+
+/**
+ * @brief Level the current user has reached in a mode
+ * @param mode - unsigned char, mode number
+ * @return unsigned char - level, UI_LEVEL_DEFAULT if none was saved
+ */
+unsigned char user_level(unsigned char mode)
+{
+  if(mode >= USER_MAX_MODES)
+  {
+    return UI_LEVEL_DEFAULT;
+  }
+  return user_state.level[mode];
+}
+
+/**
+ * @brief Saves the level the current user has reached in a mode
+ * @param mode - unsigned char, mode number
+ * @param level - unsigned char, level
+ * @return Void
+ */
+void user_set_level(unsigned char mode, unsigned char level)
+{
+  if(mode >= USER_MAX_MODES || user_state.level[mode] == level)
+  {
+    return;
+  }
+  user_state.level[mode] = level;
+  userlog_state_changed();
+}
+
+/**
+ * @brief Whether the current user has mastered a glyph of a mode
+ * @param mode - unsigned char, mode number
+ * @param glyph - unsigned char, position of the glyph in the mode's script
+ * @return bool - true if mastered
+ */
+bool user_mastered(unsigned char mode, unsigned char glyph)
+{
+  if(mode >= USER_MAX_MODES || glyph >= USER_MAX_GLYPHS)
+  {
+    return false;
+  }
+  return (user_state.mastered[mode][glyph / 8] & (1 << (glyph % 8))) != 0;
+}
+
+/**
+ * @brief Marks a glyph of a mode as mastered by the current user
+ * @param mode - unsigned char, mode number
+ * @param glyph - unsigned char, position of the glyph in the mode's script
+ * @return Void
+ */
+void user_set_mastered(unsigned char mode, unsigned char glyph)
+{
+  if(user_mastered(mode, glyph) || mode >= USER_MAX_MODES ||
+    glyph >= USER_MAX_GLYPHS)
+  {
+    return;
+  }
+  user_state.mastered[mode][glyph / 8] |= 1 << (glyph % 8);
+  userlog_state_changed();
+}
+
+/**
+ * @brief Finds the slot holding a mode's strengths
+ * @param mode - unsigned char, mode number, not 0
+ * @param create - bool, take a free slot if the mode has none
+ * @return uint8_t* - strengths of the mode, NULL if it has no slot
+ */
+static uint8_t* user_strengths(unsigned char mode, bool create)
+{
+  uint8_t i;
+
+  for(i = 0; i < USER_REVIEW_MODES; i++)
+  {
+    if(user_state.review_mode[i] == mode)
+    {
+      return user_state.strength[i];
+    }
+  }
+  if(!create)
+  {
+    return NULL;
+  }
+  for(i = 0; i < USER_REVIEW_MODES; i++)
+  {
+    if(user_state.review_mode[i] == 0)
+    {
+      user_state.review_mode[i] = mode;
+      return user_state.strength[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Spaced repetition strength of a glyph for the current user
+ * @param mode - unsigned char, mode number
+ * @param glyph - unsigned char, position of the glyph in the mode's script
+ * @return unsigned char - strength, 0 if none was saved
+ */
+unsigned char user_strength(unsigned char mode, unsigned char glyph)
+{
+  uint8_t* strengths;
+
+  if(mode == 0 || glyph >= USER_MAX_GLYPHS ||
+    (strengths = user_strengths(mode, false)) == NULL)
+  {
+    return 0;
+  }
+  return (strengths[glyph / 2] >> (4 * (glyph % 2))) & 0x0F;
+}
+
+/**
+ * @brief Saves the spaced repetition strength of a glyph for the current
+ *        user. Modes past the first USER_REVIEW_MODES are not saved.
+ * @param mode - unsigned char, mode number
+ * @param glyph - unsigned char, position of the glyph in the mode's script
+ * @param strength - unsigned char, 0 to 15
+ * @return Void
+ */
+void user_set_strength(unsigned char mode, unsigned char glyph,
+  unsigned char strength)
+{
+  uint8_t* strengths;
+  uint8_t shift = 4 * (glyph % 2);
+
+  if(mode == 0 || glyph >= USER_MAX_GLYPHS || strength > 0x0F ||
+    user_strength(mode, glyph) == strength ||
+    (strengths = user_strengths(mode, true)) == NULL)
+  {
+    return;
+  }
+  strengths[glyph / 2] = (strengths[glyph / 2] & ~(0x0F << shift)) |
+    (strength << shift);
+  userlog_state_changed();
+}
+
+/**
+ * @brief Saves the volume as the current user's preference, and as the
+ *        volume to start with at power on. Call after the volume buttons
+ *        change it.
+ * @return Void
+ */
+void user_volume_changed(void)
+{
+  uint8_t volume = vs1053_get_vol();
+
+  settings_set(SETTINGS_VOLUME, &volume, sizeof(volume));
+  if(user_state.volume == volume)
+  {
+    return;
+  }
+  user_state.volume = volume;
+  userlog_state_changed();
+}
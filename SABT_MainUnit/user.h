@@ -0,0 +1,50 @@
+/**
+ * @file user.h
+ * @brief Users of the device: login codes and saved per-user state
+ */
+
+#ifndef _USER_H_
+#define _USER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Login codes, one line per user: the user number and then the cells of the
+// code as dot numbers, e.g. "3 145 15". See the top of the file.
+#define USER_FILE "USERS.DAT"
+#define USER_MAX_TOKEN 6
+
+#define USER_GUEST 0                // Logged in at power on, needs no code
+#define USER_NONE 0xFF
+#define USER_CODE_SIZE 4            // Most cells in a login code
+
+// Modes and glyphs the saved state has room for
+#define USER_MAX_MODES 16
+#define USER_MAX_GLYPHS 64
+// Modes with spaced repetition strengths (review.h) saved
+#define USER_REVIEW_MODES 4
+
+// Saved with the user's log (userlog.h) and written back when a mode quits
+typedef struct user_state {
+  uint8_t volume;                               // 0 if never set
+  uint8_t level[USER_MAX_MODES];                // By mode number
+  uint8_t mastered[USER_MAX_MODES][USER_MAX_GLYPHS / 8];
+  uint8_t review_mode[USER_REVIEW_MODES];       // 0 if the slot is free
+  uint8_t strength[USER_REVIEW_MODES][USER_MAX_GLYPHS / 2]; // 4 bits each
+} user_state_t;
+
+extern unsigned char user_current;
+
+unsigned char user_find(const char* code, unsigned char length);
+void user_login(unsigned char user);
+void user_logout(void);
+unsigned char user_level(unsigned char mode);
+void user_set_level(unsigned char mode, unsigned char level);
+bool user_mastered(unsigned char mode, unsigned char glyph);
+void user_set_mastered(unsigned char mode, unsigned char glyph);
+unsigned char user_strength(unsigned char mode, unsigned char glyph);
+void user_set_strength(unsigned char mode, unsigned char glyph,
+  unsigned char strength);
+void user_volume_changed(void);
+
+#endif /* _USER_H_ */
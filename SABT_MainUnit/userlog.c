@@ -0,0 +1,373 @@
+/**
+ * @file userlog.c
+ * @brief Per-user progress log. Each user has a preallocated log file that is
+ *        never resized, so no FAT or directory sectors are written while
+ *        logging. Records are collected in RAM and written a block at a time;
+ *        the head pointer in the header sector is only rewritten every few
+ *        blocks, and userlog_open() finds newer records by their lap number.
+ *        The header also holds the user's state, so logging in takes one read
+ *        of each header copy.
+ */
+
+#include <string.h>
+#include "Globals.h"
+#include "userlog.h"
+
+static struct file_stream userlog_stream;
+static store_slot_t userlog_slot;
+static bool userlog_ready = false;
+static userlog_header_t userlog_header;
+static uint32_t userlog_capacity;       // Records the file can hold
+
+static userlog_record_t userlog_pending[USERLOG_PENDING_RECORDS];
+static uint8_t userlog_num_pending = 0;
+static uint32_t userlog_pending_first;  // Record number of userlog_pending[0]
+static uint8_t userlog_writes;          // Record writes since the header
+static uint32_t userlog_prompt_ms;
+
+static void* userlog_state = NULL;     // Saved in the header sector
+static uint16_t userlog_state_size = 0;
+static bool userlog_state_dirty = false;
+
+/**
+ * @brief Stops logging after an SD card error
+ * @param message - const char*, what failed
+ * @return Void
+ */
+static void userlog_fail(const char* message)
+{
+  userlog_ready = false;
+  sprintf(dbgstr, "[Log] %s\n\r", message);
+  PRINTF(dbgstr);
+}
+
+/**
+ * @brief Reads a sector of the log file into the SD buffer
+ * @param sector - uint32_t, sector number in the file
+ * @return bool - false on error
+ */
+static bool userlog_load_sector(uint32_t sector)
+{
+  return seek_file_stream(&userlog_stream, sector * USERLOG_SECTOR_SIZE);
+}
+
+/**
+ * @brief Writes the SD buffer back to the sector last loaded
+ * @return bool - false on error
+ */
+static bool userlog_store_sector(void)
+{
+  return sd_write_single_block(get_first_sector(userlog_stream.cluster) +
+    userlog_stream.sector - 1) == 0;
+}
+
+/**
+ * @brief Writes the header and the user's state over the older header copy
+ * @return bool - false on error
+ */
+static bool userlog_write_header(void)
+{
+  if(!store_prepare(&userlog_stream, 0, &userlog_slot))
+  {
+    return false;
+  }
+  memcpy((void*) &buffer[STORE_DATA_OFFSET], &userlog_header,
+    sizeof(userlog_header));
+  if(userlog_state != NULL)
+  {
+    memcpy((void*) &buffer[STORE_DATA_OFFSET + USERLOG_STATE_OFFSET],
+      userlog_state, userlog_state_size);
+  }
+  userlog_writes = 0;
+  userlog_state_dirty = false;
+  return store_commit(&userlog_stream, &userlog_slot);
+}
+
+/**
+ * @brief Lap number that follows a lap; 0 is never used so the zeros of a
+ *        new file never look like records
+ * @param lap - uint8_t, current lap
+ * @return uint8_t - next lap
+ */
+static uint8_t userlog_next_lap(uint8_t lap)
+{
+  return (lap == UINT8_MAX) ? 1 : lap + 1;
+}
+
+/**
+ * @brief Moves the head on by one record, wrapping at the end of the file
+ * @return Void
+ */
+static void userlog_advance(void)
+{
+  if(++userlog_header.head == userlog_capacity)
+  {
+    userlog_header.head = 0;
+    userlog_header.lap = userlog_next_lap(userlog_header.lap);
+  }
+}
+
+/**
+ * @brief Finds records written after the header was last saved. They carry
+ *        the current lap; the first record of an older lap ends the search.
+ * @return bool - false on error
+ */
+static bool userlog_recover(void)
+{
+  userlog_record_t record;
+  uint32_t sector = UINT32_MAX;
+  uint32_t found = 0;
+  uint32_t limit = (uint32_t) (USERLOG_HEADER_INTERVAL + 1) *
+    USERLOG_RECORDS_PER_SECTOR;
+
+  while(found < limit)
+  {
+    if(userlog_header.head / USERLOG_RECORDS_PER_SECTOR +
+      USERLOG_FIRST_RECORD_SECTOR != sector)
+    {
+      sector = userlog_header.head / USERLOG_RECORDS_PER_SECTOR +
+        USERLOG_FIRST_RECORD_SECTOR;
+      if(!userlog_load_sector(sector))
+      {
+        return false;
+      }
+    }
+    memcpy(&record, (void*) &buffer[(userlog_header.head %
+      USERLOG_RECORDS_PER_SECTOR) * USERLOG_RECORD_SIZE], sizeof(record));
+    if(record.lap != userlog_header.lap)
+    {
+      break;
+    }
+    if(record.result == USERLOG_SESSION)
+    {
+      userlog_header.sessions = record.latency;
+    }
+    userlog_advance();
+    found++;
+  }
+
+  if(found > 0)
+  {
+    sprintf(dbgstr, "[Log] Recovered %lu records\n\r", (unsigned long) found);
+    PRINTF(dbgstr);
+  }
+  return true;
+}
+
+/**
+ * @brief Opens the log of a user, ending any log already open, loads the
+ *        user's state and records the start of a session. A file with no
+ *        header is set up as an empty log with all of the state 0.
+ * @param user - unsigned char, user number from 0 to USERLOG_MAX_USER
+ * @param state - void*, set to the state saved with the log; it is written
+ *        back with the header, so it must stay valid until the log is closed
+ * @param state_size - uint16_t, size of state, at most USERLOG_MAX_STATE
+ * @return bool - false if the user has no usable log file; state is then 0
+ */
+bool userlog_open(unsigned char user, void* state, uint16_t state_size)
+{
+  unsigned char file_name[FILE_NAME_LEN];
+
+  userlog_close();
+  memset(state, 0, state_size);
+  if(user > USERLOG_MAX_USER || state_size > USERLOG_MAX_STATE)
+  {
+    return false;
+  }
+
+  snprintf((char*) file_name, sizeof(file_name), USERLOG_FILE_FORMAT, user);
+  if(!open_file_stream(&userlog_stream, file_name))
+  {
+    sprintf(dbgstr, "[Log] No log file for user %u\n\r", user);
+    PRINTF(dbgstr);
+    return false;
+  }
+  if(userlog_stream.size <= USERLOG_FIRST_RECORD_SECTOR * USERLOG_SECTOR_SIZE)
+  {
+    userlog_fail("Log file is too small");
+    return false;
+  }
+  userlog_capacity = (userlog_stream.size / USERLOG_SECTOR_SIZE -
+    USERLOG_FIRST_RECORD_SECTOR) * USERLOG_RECORDS_PER_SECTOR;
+
+  // With no valid copy the buffer is cleared, which fails the checks below
+  store_load(&userlog_stream, 0, &userlog_slot);
+  memcpy(&userlog_header, (void*) &buffer[STORE_DATA_OFFSET],
+    sizeof(userlog_header));
+
+  if(memcmp(userlog_header.magic, USERLOG_MAGIC, USERLOG_MAGIC_SIZE) != 0 ||
+    userlog_header.record_size != USERLOG_RECORD_SIZE ||
+    userlog_header.lap == 0 || userlog_header.head >= userlog_capacity)
+  {
+    PRINTF("[Log] Starting a new log\n\r");
+    memset(&userlog_header, 0, sizeof(userlog_header));
+    memcpy(userlog_header.magic, USERLOG_MAGIC, USERLOG_MAGIC_SIZE);
+    userlog_header.record_size = USERLOG_RECORD_SIZE;
+    userlog_header.lap = 1;
+  }
+  else
+  {
+    memcpy(state, (void*) &buffer[STORE_DATA_OFFSET + USERLOG_STATE_OFFSET],
+      state_size);
+    if(!userlog_recover())
+    {
+      userlog_fail("Cannot read log records");
+      return false;
+    }
+  }
+  userlog_state = state;
+  userlog_state_size = state_size;
+
+  userlog_header.sessions++;
+  if(!userlog_write_header())
+  {
+    userlog_fail("Cannot write log header");
+    return false;
+  }
+  userlog_ready = true;
+  userlog_num_pending = 0;
+  userlog_prompt_ms = scheduler_uptime_ms();
+  userlog_record(0, USERLOG_SESSION);
+
+  sprintf(dbgstr, "[Log] User %u, session %u\n\r", user,
+    userlog_header.sessions);
+  PRINTF(dbgstr);
+  return true;
+}
+
+/**
+ * @brief Writes everything still in RAM and stops logging
+ * @return Void
+ */
+void userlog_close(void)
+{
+  userlog_flush();
+  userlog_ready = false;
+  userlog_state = NULL;
+}
+
+/**
+ * @brief Marks the user's state as changed, so the next userlog_flush()
+ *        saves it
+ * @return Void
+ */
+void userlog_state_changed(void)
+{
+  userlog_state_dirty = true;
+}
+
+/**
+ * @brief Marks the moment a question was asked; the next record measures
+ *        its latency from here
+ * @return Void
+ */
+void userlog_prompt(void)
+{
+  userlog_prompt_ms = scheduler_uptime_ms();
+}
+
+/**
+ * @brief Writes the records waiting in RAM, and the header every
+ *        USERLOG_HEADER_INTERVAL writes
+ * @return Void
+ */
+static void userlog_write_pending(void)
+{
+  uint16_t offset;
+
+  if(!userlog_ready || userlog_num_pending == 0)
+  {
+    return;
+  }
+
+  offset = (userlog_pending_first % USERLOG_RECORDS_PER_SECTOR) *
+    USERLOG_RECORD_SIZE;
+  if(!userlog_load_sector(userlog_pending_first / USERLOG_RECORDS_PER_SECTOR +
+    USERLOG_FIRST_RECORD_SECTOR))
+  {
+    userlog_fail("Cannot read log records");
+    return;
+  }
+  memcpy((void*) &buffer[offset], userlog_pending,
+    userlog_num_pending * USERLOG_RECORD_SIZE);
+  if(!userlog_store_sector())
+  {
+    userlog_fail("Cannot write log records");
+    return;
+  }
+  userlog_num_pending = 0;
+
+  if(++userlog_writes >= USERLOG_HEADER_INTERVAL && !userlog_write_header())
+  {
+    userlog_fail("Cannot write log header");
+  }
+}
+
+/**
+ * @brief Logs an answer. The record stays in RAM until a block of records is
+ *        ready, so this normally costs no SD card access.
+ * @param glyph - char, cell pattern of the glyph that was asked for
+ * @param result - unsigned char, USERLOG_CORRECT, USERLOG_INCORRECT,
+ *        USERLOG_SKIPPED or USERLOG_SESSION
+ * @return Void
+ */
+void userlog_record(char glyph, unsigned char result)
+{
+  userlog_record_t* record;
+  uint32_t now;
+  uint32_t latency;
+
+  if(!userlog_ready)
+  {
+    return;
+  }
+
+  now = scheduler_uptime_ms();
+  latency = now - userlog_prompt_ms;
+  if(userlog_num_pending == 0)
+  {
+    userlog_pending_first = userlog_header.head;
+  }
+
+  record = &userlog_pending[userlog_num_pending++];
+  record->lap = userlog_header.lap;
+  record->mode = ui_is_mode_selected ? ui_current_mode_number : 0;
+  record->glyph = glyph;
+  record->result = result;
+  record->time = (now / 1000 > UINT16_MAX) ? UINT16_MAX : now / 1000;
+  if(result == USERLOG_SESSION)
+  {
+    record->latency = userlog_header.sessions;
+  }
+  else
+  {
+    record->latency = (latency > UINT16_MAX) ? UINT16_MAX : latency;
+  }
+  userlog_advance();
+
+  // Records written together must lie in one sector
+  if(userlog_num_pending == USERLOG_PENDING_RECORDS ||
+    userlog_header.head % USERLOG_RECORDS_PER_SECTOR == 0)
+  {
+    userlog_write_pending();
+  }
+}
+
+/**
+ * @brief Writes the records waiting in RAM and the header, so the log is
+ *        complete on the card. Call when leaving a mode or logging out.
+ * @return Void
+ */
+void userlog_flush(void)
+{
+  if(!userlog_ready)
+  {
+    return;
+  }
+  userlog_write_pending();
+  if(userlog_ready && (userlog_writes > 0 || userlog_state_dirty) &&
+    !userlog_write_header())
+  {
+    userlog_fail("Cannot write log header");
+  }
+}
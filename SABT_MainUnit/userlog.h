@@ -0,0 +1,68 @@
+/**
+ * @file userlog.h
+ * @brief Per-user progress log kept in a preallocated file on the SD card
+ */
+
+#ifndef _USERLOG_H_
+#define _USERLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "store.h"
+
+// Log files are USERnn.LOG, made on a PC as a zero-filled file of whole
+// sectors (see README.sd_card). Sectors 0 and 1 hold two copies of the
+// header (store.h); records fill the rest and wrap around to the first
+// record when the file is full.
+#define USERLOG_FILE_FORMAT "USER%02u.LOG"
+#define USERLOG_FILE_NAME_SIZE 13
+#define USERLOG_MAX_USER 99
+#define USERLOG_MAGIC "SABTLOG2"
+#define USERLOG_MAGIC_SIZE 8
+
+#define USERLOG_SECTOR_SIZE 512
+#define USERLOG_FIRST_RECORD_SECTOR 2
+// The rest of the header holds the state of the user (user.h)
+#define USERLOG_STATE_OFFSET 32
+#define USERLOG_MAX_STATE (STORE_DATA_SIZE - USERLOG_STATE_OFFSET)
+#define USERLOG_RECORD_SIZE 8
+#define USERLOG_RECORDS_PER_SECTOR (USERLOG_SECTOR_SIZE / USERLOG_RECORD_SIZE)
+
+// Records are written when this many are waiting, at the end of a sector or
+// by userlog_flush(). The header is rewritten every USERLOG_HEADER_INTERVAL
+// record writes; records written after it are found again by their lap.
+#define USERLOG_PENDING_RECORDS 32
+#define USERLOG_HEADER_INTERVAL 8
+
+// Results
+#define USERLOG_INCORRECT 0
+#define USERLOG_CORRECT   1
+#define USERLOG_SKIPPED   2
+#define USERLOG_SESSION   0xFF      // First record after userlog_open()
+
+typedef struct userlog_record {
+  uint8_t lap;                      // Header lap when written, never 0
+  uint8_t mode;                     // Mode number, 0 outside modes
+  uint8_t glyph;                    // Cell pattern of the glyph asked for
+  uint8_t result;                   // USERLOG_*
+  uint16_t time;                    // Seconds since power on
+  uint16_t latency;                 // Milliseconds from prompt to answer, or
+                                    // the session number for USERLOG_SESSION
+} userlog_record_t;
+
+typedef struct userlog_header {
+  char magic[USERLOG_MAGIC_SIZE];
+  uint8_t record_size;
+  uint8_t lap;                      // Goes up each time the log wraps
+  uint16_t sessions;
+  uint32_t head;                    // Next record to write
+} userlog_header_t;
+
+bool userlog_open(unsigned char user, void* state, uint16_t state_size);
+void userlog_close(void);
+void userlog_prompt(void);
+void userlog_record(char glyph, unsigned char result);
+void userlog_state_changed(void);
+void userlog_flush(void);
+
+#endif /* _USERLOG_H_ */
@@ -0,0 +1,209 @@
+/**
+ * @file words.c
+ * @brief Word lists on the SD card for the word games. Entries are read one
+ *        at a time straight from the file, so lists can hold thousands of
+ *        words; only the current entry is kept in RAM.
+ */
+
+#include <string.h>
+#include "Globals.h"
+#include "common.h"
+#include "words.h"
+
+static struct file_stream words_stream;
+static bool words_is_open = false;
+static uint16_t words_total = 0;
+static char words_lang[WORDS_FILESET_SIZE + 1];
+static char words_clips[WORDS_FILESET_SIZE + 1];
+
+// Lists that fit draw from a shuffle bag; longer lists step through the
+// entries from a random start by a random stride that shares no factor with
+// the count, which visits each entry once per round in O(1) space.
+static shuffle_bag_t words_bag;
+static uint16_t words_position;
+static uint16_t words_stride;
+static uint16_t words_drawn;
+
+/**
+ * @brief Reads bytes from the list
+ * @param position - unsigned long, offset in the file
+ * @param dest - unsigned char*, set to the bytes read
+ * @param length - uint8_t, number of bytes
+ * @return bool - false if the file is too short or the card could not be read
+ */
+static bool words_read_bytes(unsigned long position, unsigned char* dest,
+  uint8_t length)
+{
+  int byte;
+  uint8_t i;
+
+  if(!seek_file_stream(&words_stream, position))
+  {
+    return false;
+  }
+  for(i = 0; i < length; i++)
+  {
+    if((byte = read_file_stream(&words_stream)) < 0)
+    {
+      return false;
+    }
+    dest[i] = byte;
+  }
+  return true;
+}
+
+/**
+ * @brief Greatest common divisor
+ * @param a - uint16_t, first number
+ * @param b - uint16_t, second number
+ * @return uint16_t - gcd(a, b)
+ */
+static uint16_t words_gcd(uint16_t a, uint16_t b)
+{
+  uint16_t t;
+
+  while(b != 0)
+  {
+    t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/**
+ * @brief Opens a word list and starts a new round of words_pick()
+ * @param name - const char*, file name without WORDS_EXTENSION, e.g. "ANIMALS"
+ * @return bool - false if the file is missing or not a word list
+ */
+bool words_open(const char* name)
+{
+  unsigned char file_name[FILE_NAME_LEN];
+  unsigned char header[WORDS_HEADER_SIZE];
+
+  words_is_open = false;
+  words_total = 0;
+  if(strlen(name) > WORDS_MAX_NAME)
+  {
+    return false;
+  }
+  strcpy((char*) file_name, name);
+  strcat((char*) file_name, WORDS_EXTENSION);
+
+  if(!open_file_stream(&words_stream, file_name) ||
+    !words_read_bytes(0, header, sizeof(header)) ||
+    memcmp(header, WORDS_MAGIC, WORDS_MAGIC_SIZE) != 0)
+  {
+    sprintf(dbgstr, "[Words] %s is not a word list\n\r", name);
+    PRINTF(dbgstr);
+    return false;
+  }
+
+  words_total = header[WORDS_COUNT_OFFSET] |
+    (uint16_t) header[WORDS_COUNT_OFFSET + 1] << 8;
+  if(words_total == 0 || words_stream.size < WORDS_FIRST_RECORD +
+    (unsigned long) words_total * WORDS_RECORD_SIZE)
+  {
+    sprintf(dbgstr, "[Words] %s is too short\n\r", name);
+    PRINTF(dbgstr);
+    words_total = 0;
+    return false;
+  }
+  memcpy(words_lang, &header[WORDS_LANGUAGE_OFFSET], WORDS_FILESET_SIZE);
+  words_lang[WORDS_FILESET_SIZE] = '\0';
+  memcpy(words_clips, &header[WORDS_FILESET_OFFSET], WORDS_FILESET_SIZE);
+  words_clips[WORDS_FILESET_SIZE] = '\0';
+
+  shuffle_bag_init(&words_bag, words_total <= SHUFFLE_BAG_SIZE ?
+    words_total : 0);
+  words_drawn = 0;
+  words_is_open = true;
+
+  sprintf(dbgstr, "[Words] %s: %u words\n\r", name, words_total);
+  PRINTF(dbgstr);
+  return true;
+}
+
+/**
+ * @brief Number of entries in the open list
+ * @return uint16_t - count, 0 if no list is open
+ */
+uint16_t words_count(void)
+{
+  return words_total;
+}
+
+/**
+ * @brief Fileset of the script the words are written in
+ * @return const char* - e.g. "ENG_"
+ */
+const char* words_language(void)
+{
+  return words_lang;
+}
+
+/**
+ * @brief Fileset of the clips of the words
+ * @return const char* - e.g. "MD3_"
+ */
+const char* words_fileset(void)
+{
+  return words_clips;
+}
+
+/**
+ * @brief Reads one entry of the open list, with a single sector read
+ * @param index - uint16_t, entry number
+ * @param entry - words_entry_t*, set to the entry
+ * @return bool - false if there is no such entry or it could not be read
+ */
+bool words_read(uint16_t index, words_entry_t* entry)
+{
+  unsigned char record[WORDS_CLIP_OFFSET + WORDS_CLIP_SIZE];
+
+  if(!words_is_open || index >= words_total ||
+    !words_read_bytes(WORDS_FIRST_RECORD +
+    (unsigned long) index * WORDS_RECORD_SIZE, record, sizeof(record)) ||
+    record[0] == 0 || record[0] > WORDS_MAX_CELLS)
+  {
+    return false;
+  }
+  entry->length = record[0];
+  memcpy(entry->cells, &record[1], WORDS_MAX_CELLS);
+  memcpy(entry->clip, &record[WORDS_CLIP_OFFSET], WORDS_CLIP_SIZE);
+  entry->clip[WORDS_CLIP_SIZE] = '\0';
+  return true;
+}
+
+/**
+ * @brief Picks an entry at random. Every entry is picked once before any is
+ *        picked again.
+ * @return uint16_t - entry number, 0 if no list is open
+ */
+uint16_t words_pick(void)
+{
+  if(words_total <= SHUFFLE_BAG_SIZE)
+  {
+    return shuffle_bag_draw(&words_bag);
+  }
+
+  if(words_drawn == 0)
+  {
+    words_position = random_below(words_total);
+    words_stride = 1 + random_below(words_total - 1);
+    while(words_gcd(words_stride, words_total) != 1)
+    {
+      words_stride++;
+    }
+  }
+  else
+  {
+    words_position = ((uint32_t) words_position + words_stride) % words_total;
+  }
+
+  if(++words_drawn == words_total)
+  {
+    words_drawn = 0;
+  }
+  return words_position;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file words.h
+ * @brief Word lists on the SD card. Each entry is a word as braille cells
+ *        and the name of the clips that go with it.
+ */
+
+#ifndef _WORDS_H_
+#define _WORDS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// NAME.WRD, made on a PC with tools/words/wordpack. Sector 0 is the header;
+// each further sector holds 16 entries of WORDS_RECORD_SIZE bytes, so an
+// entry is found from its number alone and never spans two sectors.
+#define WORDS_EXTENSION ".WRD"
+#define WORDS_MAX_NAME 8
+#define WORDS_MAGIC "SABTWRD1"
+#define WORDS_MAGIC_SIZE 8
+#define WORDS_MAX_COUNT 65535
+
+// Header, little-endian
+#define WORDS_COUNT_OFFSET 8            // uint16_t, number of entries
+#define WORDS_LANGUAGE_OFFSET 10        // Fileset of the script, e.g. "ENG_"
+#define WORDS_FILESET_OFFSET 14         // Fileset of the clips, e.g. "MD3_"
+#define WORDS_FILESET_SIZE 4
+#define WORDS_HEADER_SIZE 18
+
+// Entries start at sector 1
+#define WORDS_FIRST_RECORD 512
+#define WORDS_RECORD_SIZE 32
+#define WORDS_MAX_CELLS 16              // Same as MAX_WORD_LENGTH
+#define WORDS_CLIP_OFFSET (1 + WORDS_MAX_CELLS)
+#define WORDS_CLIP_SIZE 4               // Clips are <fileset>N<clip>.mp3 for the
+                                        // word and <fileset>S<clip>.mp3 for
+                                        // its sound
+
+typedef struct words_entry {
+  unsigned char length;                 // Number of cells
+  char cells[WORDS_MAX_CELLS];          // Cell patterns
+  char clip[WORDS_CLIP_SIZE + 1];
+} words_entry_t;
+
+bool words_open(const char* name);
+uint16_t words_count(void);
+const char* words_language(void);
+const char* words_fileset(void);
+bool words_read(uint16_t index, words_entry_t* entry);
+uint16_t words_pick(void);
+
+#endif /* _WORDS_H_ */
@@ -8,32 +8,48 @@
 
 #include "GlobalsUI.h"
 
+// Number of the next packet. Only the first packet after reset is numbered 0,
+// which tells the MCU a new run of numbers has started
+static unsigned char mcu_msg_number = 0;
+
+// CRC-16/CCITT (polynomial 0x1021) remainders for each value of a nibble
+static const uint16_t crc_table[16] PROGMEM = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/**
+ * @brief add one byte to a running CRC-16/CCITT, four bits at a time
+ * @param crc the CRC so far (CRC_INIT for the first byte)
+ * @param data the next byte of the message
+ * @return updated CRC
+ */
+uint16_t crc_update(uint16_t crc, unsigned char data)
+{
+  crc = (crc << 4) ^ pgm_read_word(&crc_table[(crc >> 12) ^ (data >> 4)]);
+  crc = (crc << 4) ^ pgm_read_word(&crc_table[(crc >> 12) ^ (data & 0x0F)]);
+  return crc;
+}
+
 /**
  * @brief calculate cyclic redundancy checks (CRC)
+ *        Covers [message_length][msg_number][msgtype][payload] - everything
+ *        except the header and the two CRC bytes
  * @param message the message being sent
  * @return checksum
  */
 uint16_t calculate_crc(unsigned char* message)
 {
-  // Get the length of the message
-  // Note that message_length doesn't include the two checksum bytes
-  unsigned char message_length = *(message + 2) - 5;
-  uint16_t checksum = 0;
+  // Note that message_length doesn't include the header or checksum bytes
+  unsigned char message_length = *(message + 2) - 4;
+  uint16_t checksum = CRC_INIT;
   
-  message += 3;
+  message += 2;
   
   // Calculate the checksum
-  while(message_length > 1)
+  while(message_length-- > 0)
   {
-    checksum += (*(message) << 8) | *(message + 1);
-    checksum = checksum & 0xffff;
-    message_length -= 2;
-    message += 2;
-  }
-  
-  if(message_length > 0) // If the packet size is odd numbered
-  {
-    checksum = checksum^((int)*(message++));
+    checksum = crc_update(checksum, *(message++));
   }
 
   return checksum;
@@ -44,6 +60,9 @@ uint16_t calculate_crc(unsigned char* message)
  *
  *        [U][I][message_length][msg_number][msgtype][payload][CRC1][CRC2]
  *
+ *        Each packet gets the next message number, which the MCU echoes back
+ *        in its ACK/NAK and uses to discard retransmitted duplicates
+ *
  * @param cmd command type (A-E)
  * @param payload the packet message
  * @param payload_length length of the packet message
@@ -65,7 +84,8 @@ bool mcu_compile_packet(char cmd, char* payload, int payload_length)
   if (payload_length + PACKET_WRAP_LENGTH > MAX_PACKET_LENGTH) return false;
 
   mcu_packet[2] = payload_length + PACKET_WRAP_LENGTH;  // Total message length
-  mcu_packet[3] = DEFAULT_MSG_NUMBER;                   // Message number
+  mcu_packet[3] = mcu_msg_number;                       // Message number
+  if(++mcu_msg_number == 0) mcu_msg_number = 1;
   mcu_packet[4] = cmd;                                  // Command type: A-E
   
   // Copy over the payload
@@ -84,21 +104,152 @@ bool mcu_compile_packet(char cmd, char* payload, int payload_length)
 }
 
 /**
- * @brief send the prepared packet
+ * @brief wait for the MCU to acknowledge a packet
+ *
+ *        [M][C][message_length][msg_number][ACK/NAK][CRC1][CRC2]
+ *
+ * @param packet the packet that was sent
+ * @param timeout_ms how long to wait
+ * @return true if an ACK for this message number arrived before the timeout,
+ *         false on a NAK or timeout
+ */
+static bool wait_for_reply(unsigned char* packet, int timeout_ms)
+{
+  int elapsed_ms = 0;
+  uint16_t checksum;
+
+  while(elapsed_ms < timeout_ms)
+  {
+    if(usart_mcu_reply_ready)
+    {
+      usart_mcu_reply_ready = false;
+      checksum = calculate_crc((unsigned char*)&usart_mcu_reply_packet);
+
+      // Ignore corrupt replies and replies to an earlier packet
+      if((checksum == (usart_mcu_reply_packet[MCU_REPLY_LENGTH - 2] << 8 |
+              usart_mcu_reply_packet[MCU_REPLY_LENGTH - 1])) &&
+          (usart_mcu_reply_packet[3] == packet[3]))
+      {
+        return (usart_mcu_reply_packet[4] == MCU_REPLY_ACK);
+      }
+    }
+    _delay_ms(1);
+    elapsed_ms++;
+  }
+
+  return false;
+}
+
+/**
+ * @brief send a compiled packet, retransmitting it with a doubling wait
+ *        until the MCU acknowledges it or the copies are used up
+ * @param packet the packet, starting with its header
+ * @param copies number of copies to send at most
+ * @return true if the MCU acknowledged the packet, false otw
+ */
+static bool transmit_packet(unsigned char* packet, int copies)
+{
+  int i = 0;
+  int attempt = 0;
+  int timeout_ms = PACKET_ACK_TIMEOUT_MS;
+
+  for(attempt = 0; attempt < copies; attempt++)
+  {
+    usart_mcu_reply_ready = false;
+    for(i = 0; i < packet[2]; i++)
+    {
+      usart_transmit_byte_to_mcu(packet[i]);
+    }
+
+    if(wait_for_reply(packet, timeout_ms)) return true;
+
+    timeout_ms *= 2;
+    if(timeout_ms > PACKET_ACK_MAX_TIMEOUT_MS)
+      timeout_ms = PACKET_ACK_MAX_TIMEOUT_MS;
+  }
+
+  return false;
+}
+
+// Packets waiting for the MCU, oldest first
+static unsigned char packet_queue[PACKET_QUEUE_SIZE][MAX_PACKET_LENGTH];
+static unsigned char packet_queue_first = 0;
+static unsigned char packet_queue_count = 0;
+
+// Timer ticks left before the head of the queue is sent again, and the
+// number to wait after the next unacknowledged copy
+static unsigned char packet_retry_ticks = 0;
+static unsigned char packet_retry_interval = 1;
+
+/**
+ * @brief send the packets waiting in the queue, oldest first, called on each
+ *        timer tick. Each gets one copy and a PACKET_ACK_TIMEOUT_MS wait;
+ *        at the first one not acknowledged it stops and skips a doubling
+ *        number of ticks, up to PACKET_RETRY_MAX_TICKS, before trying again.
+ * @return true if the queue is now empty
+ */
+bool send_queued_packets(void)
+{
+  if(packet_queue_count == 0) return true;
+
+  if(packet_retry_ticks > 0)
+  {
+    packet_retry_ticks--;
+    return false;
+  }
+
+  while(packet_queue_count > 0)
+  {
+    if(!transmit_packet(packet_queue[packet_queue_first], 1))
+    {
+      packet_retry_ticks = packet_retry_interval;
+      if(packet_retry_interval < PACKET_RETRY_MAX_TICKS)
+        packet_retry_interval *= 2;
+      return false;
+    }
+
+    packet_queue_first = (packet_queue_first + 1) % PACKET_QUEUE_SIZE;
+    packet_queue_count--;
+    packet_retry_interval = 1;
+  }
+
+  return true;
+}
+
+/**
+ * @brief send a packet to the MCU. If nothing is queued ahead of it, it gets
+ *        PACKET_SEND_COPIES tries straight away; otherwise, or if those are
+ *        not acknowledged, it is queued behind the others so packets arrive
+ *        in order, and timer_routine() sends it. Never waits for room in the
+ *        queue, so the buttons keep working while the MCU is absent or
+ *        resetting.
  * @param cmd command (A-E)
  * @param payload the message
  * @param payload_length length of the message
- * @return Void
+ * @return true if the MCU acknowledged the packet or it was queued, false
+ *         if it is too long to send or the queue is full
  */
-void send_packet(char cmd, char* payload, int payload_length)
+bool send_packet(char cmd, char* payload, int payload_length)
 {
   int i = 0;
+  unsigned char slot;
 
-  if(mcu_compile_packet(cmd, payload, payload_length))
+  if(!mcu_compile_packet(cmd, payload, payload_length)) return false;
+
+  if(packet_queue_count == 0 &&
+      transmit_packet((unsigned char*)mcu_packet, PACKET_SEND_COPIES))
   {
-    for(i = 0; i < mcu_packet_size; i++)
-    {
-      usart_transmit_byte_to_mcu(mcu_packet[i]);
-    }
-  }  
+    return true;
+  }
+
+  if(packet_queue_count == PACKET_QUEUE_SIZE) return false;
+
+  slot = (packet_queue_first + packet_queue_count) % PACKET_QUEUE_SIZE;
+  for(i = 0; i < mcu_packet_size; i++)
+  {
+    packet_queue[slot][i] = mcu_packet[i];
+  }
+  packet_queue_count++;
+
+  return true;
 }
@@ -14,7 +14,22 @@
 #define PACKET_HEADER_LENGTH    5   // Header of a message length
 #define PACKET_WRAP_LENGTH      7   // Number of bytes not in payload
 
-#define DEFAULT_MSG_NUMBER      2   // Currently a dummy value for msg number
+#define CRC_INIT                0xFFFF  // Initial value of the CRC-16/CCITT
+
+#define MCU_REPLY_ACK           'K' // Packet received and accepted
+#define MCU_REPLY_NAK           'N' // Packet received with a bad checksum
+
+// The MCU only reads its RX ring between tasks, and can be busy for over a
+// second (an SD directory search, loading the dictionary). send_packet() only
+// waits for a quick reply; packets the MCU has not acknowledged by then wait
+// in the queue, in order, and timer_routine() (about every 100 ms) sends them
+// again, skipping a doubling number of ticks while the MCU stays busy so the
+// copies fit the MCU's RX_BUFFER_SIZE (rx_buffer.h).
+#define PACKET_ACK_TIMEOUT_MS     40   // First wait for the MCU to reply
+#define PACKET_ACK_MAX_TIMEOUT_MS 640  // Longest wait between copies
+#define PACKET_SEND_COPIES        2    // Copies send_packet() tries at once
+#define PACKET_RETRY_MAX_TICKS    8    // Most timer ticks between retries
+#define PACKET_QUEUE_SIZE         8    // Packets waiting for the MCU
 
 // The payload for the current message being built
 volatile char mcu_message_payload[MAX_MSG_PAYLOAD_LENGTH];
@@ -25,8 +40,10 @@ volatile unsigned char mcu_packet[MAX_PACKET_LENGTH];
 // The size of mcu_packet
 volatile int mcu_packet_size;
 
+uint16_t crc_update(uint16_t crc, unsigned char data);
 uint16_t calculate_crc(unsigned char* message);
 bool mcu_compile_packet(char cmd, char* payload, int payload_length);
-void send_packet(char cmd, char* payload, int payload_length);
+bool send_packet(char cmd, char* payload, int payload_length);
+bool send_queued_packets(void);
 
 #endif /* _COMM_PACKET_H_ */
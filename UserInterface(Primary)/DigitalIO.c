@@ -187,18 +187,12 @@ void run_command_tasks(void)
  */
 void enter1_task(void)
 {
-  int i = 0;
-
   set_stat_led2(true);
   mcu_message_payload[0] = ENTER1_PAYLOAD;
+
+  // send_packet() delivers packets in order, each acknowledged before the
+  // next, so the cell value below can no longer overtake the command
   send_packet('D', (char*)&mcu_message_payload, 1);
-  
-  //@TODO fix this --- THIS MAKES IT WORK. FIND BETTER WAY TO DO THIS
-  
-  for(i = 0; i < 15; i++)
-  {
-    delay();
-  }
 
   // Send the value of the currently entered cell
   capture_cell_value();
@@ -53,6 +53,9 @@ void timer_routine(void)
     led_toggle=false;
   }
  
+  // Retry packets the MCU was too busy to acknowledge
+  send_queued_packets();
+
   // Handle button presses
   check_command_buttons();
   run_command_tasks();
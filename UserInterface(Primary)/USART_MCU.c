@@ -8,6 +8,9 @@
 
 #include "GlobalsUI.h"
 
+// Number of bytes of the current reply received so far
+static unsigned char usart_mcu_reply_count = 0;
+
 /**
  * @brief initialize the USART hardware
  *        Baud Rate: 19,200
@@ -26,13 +29,32 @@ void init_usart_mcu(void)
 
 /**
  * @brief interrupt handler for USART0_RX
- * Fires when we receive data from the MCU.
+ * Fires when we receive data from the MCU. Replies are only 7 bytes long, so
+ * they are framed here and handed over to send_packet() complete.
  * @return Void
  */
 ISR(_VECTOR(18))
 {
   usart_mcu_received_data = UDR0;
   usart_mcu_data_ready = true;
+
+  // Resynchronise on the 'M' 'C' header
+  if((usart_mcu_reply_count == 0 && usart_mcu_received_data != 'M') ||
+      (usart_mcu_reply_count == 1 && usart_mcu_received_data != 'C') ||
+      (usart_mcu_reply_count == 2 && usart_mcu_received_data != MCU_REPLY_LENGTH))
+  {
+    usart_mcu_reply_count = (usart_mcu_received_data == 'M') ? 1 : 0;
+    if(usart_mcu_reply_count == 1) usart_mcu_reply_packet[0] = 'M';
+    return;
+  }
+
+  usart_mcu_reply_packet[usart_mcu_reply_count++] = usart_mcu_received_data;
+
+  if(usart_mcu_reply_count == MCU_REPLY_LENGTH)
+  {
+    usart_mcu_reply_count = 0;
+    usart_mcu_reply_ready = true;
+  }
 };
 
 /**
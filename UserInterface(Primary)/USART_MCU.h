@@ -9,10 +9,16 @@
 #ifndef _USART_MCU_H_
 #define _USART_MCU_H_
 
+#define MCU_REPLY_LENGTH 7   // [M][C][len][msg_number][ACK/NAK][CRC1][CRC2]
+
 volatile char usart_mcu_received_data;
 volatile bool usart_mcu_data_ready;
 volatile bool transmit_complete;
 
+// Last complete reply received from the MCU
+volatile unsigned char usart_mcu_reply_packet[MCU_REPLY_LENGTH];
+volatile bool usart_mcu_reply_ready;
+
 void init_usart_mcu(void);
 void usart_transmit_byte_to_mcu(unsigned char data);
 void usart_transmit_string_to_mcu_from_flash(char* str_data);
@@ -0,0 +1,618 @@
+/**
+ * @file fsmasm.c
+ * @brief Host tool that assembles a game script source (.fsa) into the
+ *        bytecode run by SABT_MainUnit/fsm.c. See README for the syntax.
+ *
+ *        usage: fsmasm game.fsa GAME.FSM
+ */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fsm.h"
+
+#define MAX_CODE 65536
+#define MAX_LINE 256
+#define MAX_TOKENS 8
+#define MAX_NAME 32
+#define MAX_SYMBOLS 512
+#define MAX_FIXUPS 2048
+
+typedef struct symbol {
+  char name[MAX_NAME];
+  long value;                       // Code offset or state number, -1 if unset
+  int line;
+} symbol_t;
+
+typedef struct fixup {
+  char name[MAX_NAME];
+  long offset;                      // Where the value goes in the code
+  int is_state;                     // 1 byte state number, else 2 byte offset
+  int line;
+} fixup_t;
+
+static unsigned char code[MAX_CODE];
+static long code_length;
+static symbol_t labels[MAX_SYMBOLS];
+static int num_labels;
+static symbol_t states[MAX_SYMBOLS];
+static int num_states;
+static symbol_t vars[FSM_NUM_VARS];
+static int num_vars;
+static fixup_t fixups[MAX_FIXUPS];
+static int num_fixups;
+
+static const char* source_name;
+static int source_line;
+static int in_handlers;             // After a WAIT, until the list is closed
+
+static void fail(const char* format, ...)
+{
+  va_list args;
+
+  fprintf(stderr, "%s:%d: ", source_name, source_line);
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+  exit(1);
+}
+
+static void emit(unsigned char byte)
+{
+  if(code_length >= MAX_CODE)
+  {
+    fail("script is larger than %d bytes", MAX_CODE);
+  }
+  code[code_length++] = byte;
+}
+
+static void emit_word(long value)
+{
+  emit(value & 0xFF);
+  emit((value >> 8) & 0xFF);
+}
+
+static symbol_t* find_symbol(symbol_t* table, int count, const char* name)
+{
+  int i;
+
+  for(i = 0; i < count; i++)
+  {
+    if(strcmp(table[i].name, name) == 0)
+    {
+      return &table[i];
+    }
+  }
+  return NULL;
+}
+
+static symbol_t* add_symbol(symbol_t* table, int* count, int max,
+  const char* name, long value)
+{
+  symbol_t* symbol;
+
+  if(strlen(name) >= MAX_NAME)
+  {
+    fail("name '%s' is too long", name);
+  }
+  if(*count >= max)
+  {
+    fail("too many names");
+  }
+  symbol = &table[(*count)++];
+  strcpy(symbol->name, name);
+  symbol->value = value;
+  symbol->line = source_line;
+  return symbol;
+}
+
+static void add_fixup(const char* name, int is_state)
+{
+  fixup_t* fixup;
+
+  if(num_fixups >= MAX_FIXUPS)
+  {
+    fail("too many references");
+  }
+  if(strlen(name) >= MAX_NAME)
+  {
+    fail("name '%s' is too long", name);
+  }
+  fixup = &fixups[num_fixups++];
+  strcpy(fixup->name, name);
+  fixup->offset = code_length;
+  fixup->is_state = is_state;
+  fixup->line = source_line;
+  if(is_state)
+  {
+    emit(0);
+  }
+  else
+  {
+    emit_word(0);
+  }
+}
+
+/**
+ * @brief Cell pattern written as dot numbers, e.g. #145
+ */
+static long parse_cell(const char* text)
+{
+  long pattern = 0;
+
+  if(*text == '\0')
+  {
+    fail("empty cell");
+  }
+  for(; *text != '\0'; text++)
+  {
+    if(*text < '1' || *text > '6')
+    {
+      fail("bad dot '%c' in cell", *text);
+    }
+    pattern |= 1 << (*text - '1');
+  }
+  return pattern;
+}
+
+/**
+ * @brief Number: decimal, 'c' character or #dots cell pattern
+ */
+static long parse_number(const char* text)
+{
+  char* end;
+  long value;
+
+  if(text[0] == '\'')
+  {
+    if(strlen(text) != 3 || text[2] != '\'')
+    {
+      fail("bad character %s", text);
+    }
+    return (unsigned char)text[1];
+  }
+  if(text[0] == '#')
+  {
+    return parse_cell(text + 1);
+  }
+  value = strtol(text, &end, 10);
+  if(*text == '\0' || *end != '\0')
+  {
+    fail("bad number '%s'", text);
+  }
+  if(value < -32768 || value > 32767)
+  {
+    fail("number %ld out of range", value);
+  }
+  return value;
+}
+
+static void emit_var(const char* name)
+{
+  symbol_t* var = find_symbol(vars, num_vars, name);
+
+  if(var == NULL)
+  {
+    fail("unknown variable '%s'", name);
+  }
+  emit(var->value);
+}
+
+static void emit_string(const char* text)
+{
+  size_t length = strlen(text);
+
+  if(length > FSM_MAX_STRING)
+  {
+    fail("'%s' is longer than %d characters", text, FSM_MAX_STRING);
+  }
+  emit(length);
+  while(*text != '\0')
+  {
+    emit(*text++);
+  }
+}
+
+/**
+ * @brief Splits a line into words. ; starts a comment; "..." is one word
+ *        with the quotes removed.
+ */
+static int split_line(char* line, char** tokens)
+{
+  int count = 0;
+  char* p = line;
+
+  while(1)
+  {
+    while(isspace((unsigned char)*p))
+    {
+      p++;
+    }
+    if(*p == '\0' || *p == ';')
+    {
+      break;
+    }
+    if(count == MAX_TOKENS)
+    {
+      fail("too many words");
+    }
+    if(*p == '"')
+    {
+      tokens[count++] = ++p;
+      while(*p != '"')
+      {
+        if(*p == '\0')
+        {
+          fail("missing \"");
+        }
+        p++;
+      }
+    }
+    else
+    {
+      tokens[count++] = p;
+      while(*p != '\0' && !isspace((unsigned char)*p) && *p != ';')
+      {
+        p++;
+      }
+      if(*p == ';')
+      {
+        *p = '\0';
+        break;
+      }
+    }
+    if(*p == '\0')
+    {
+      break;
+    }
+    *p++ = '\0';
+  }
+  return count;
+}
+
+static void expect(int count, int wanted, const char* usage)
+{
+  if(count != wanted)
+  {
+    fail("usage: %s", usage);
+  }
+}
+
+static void close_handlers(void)
+{
+  if(in_handlers)
+  {
+    emit(0);
+    in_handlers = 0;
+  }
+}
+
+static int event_number(const char* name)
+{
+  static const char* names[] = {
+    "dot", "cell", "enter", "cancel", "left", "right"
+  };
+  int i;
+
+  for(i = 0; i < 6; i++)
+  {
+    if(strcmp(names[i], name) == 0)
+    {
+      return FSM_EVENT_DOT + i;
+    }
+  }
+  fail("unknown event '%s'", name);
+  return 0;
+}
+
+static void assemble_handler(char** tokens, int count)
+{
+  int event;
+  long value = FSM_ANY;
+
+  if(!in_handlers)
+  {
+    fail("'on' must follow wait or another 'on'");
+  }
+  if(count < 3)
+  {
+    fail("usage: on <event> [value|any] <label>");
+  }
+  event = event_number(tokens[1]);
+  if(count == 4)
+  {
+    if(strcmp(tokens[2], "any") != 0)
+    {
+      value = (event == FSM_EVENT_CELL && tokens[2][0] != '#') ?
+        parse_cell(tokens[2]) : parse_number(tokens[2]);
+      if(value < 0 || value >= FSM_ANY)
+      {
+        fail("value %ld out of range", value);
+      }
+    }
+  }
+  else if(count != 3)
+  {
+    fail("usage: on <event> [value|any] <label>");
+  }
+  emit(event);
+  emit(value);
+  add_fixup(tokens[count - 1], 0);
+}
+
+typedef struct instruction {
+  const char* name;
+  unsigned char op;
+  const char* operands;             // v variable, n number, a label, s state,
+                                    // t string
+} instruction_t;
+
+static const instruction_t instructions[] = {
+  { "end",     FSM_OP_END,     "" },
+  { "play",    FSM_OP_PLAY,    "tt" },
+  { "saynum",  FSM_OP_SAYNUM,  "v" },
+  { "saycell", FSM_OP_SAYCELL, "v" },
+  { "set",     FSM_OP_SET,     "vn" },
+  { "add",     FSM_OP_ADD,     "vn" },
+  { "mov",     FSM_OP_MOV,     "vv" },
+  { "rand",    FSM_OP_RAND,    "vn" },
+  { "jmp",     FSM_OP_JMP,     "a" },
+  { "jeq",     FSM_OP_JEQ,     "vna" },
+  { "jne",     FSM_OP_JNE,     "vna" },
+  { "jlt",     FSM_OP_JLT,     "vna" },
+  { "jgt",     FSM_OP_JGT,     "vna" },
+  { "jeqv",    FSM_OP_JEQV,    "vva" },
+  { "goto",    FSM_OP_GOTO,    "s" },
+  { "wait",    FSM_OP_WAIT,    "" },
+  { "stay",    FSM_OP_STAY,    "" },
+  { "wclr",    FSM_OP_WCLR,    "" },
+  { "wadd",    FSM_OP_WADD,    "v" },
+  { "letter",  FSM_OP_LETTER,  "v" },
+  { "jdict",   FSM_OP_JDICT,   "a" },
+};
+
+static void assemble_instruction(char** tokens, int count)
+{
+  const instruction_t* instruction = NULL;
+  size_t i;
+  int operand;
+
+  for(i = 0; i < sizeof(instructions) / sizeof(instructions[0]); i++)
+  {
+    if(strcmp(instructions[i].name, tokens[0]) == 0)
+    {
+      instruction = &instructions[i];
+      break;
+    }
+  }
+  if(instruction == NULL)
+  {
+    fail("unknown instruction '%s'", tokens[0]);
+  }
+  if(count - 1 != (int)strlen(instruction->operands))
+  {
+    fail("'%s' takes %d operands", tokens[0],
+      (int)strlen(instruction->operands));
+  }
+
+  emit(instruction->op);
+  for(operand = 0; operand < count - 1; operand++)
+  {
+    const char* text = tokens[operand + 1];
+    switch(instruction->operands[operand])
+    {
+      case 'v':
+        emit_var(text);
+        break;
+      case 'n':
+        emit_word(parse_number(text));
+        break;
+      case 'a':
+        add_fixup(text, 0);
+        break;
+      case 's':
+        add_fixup(text, 1);
+        break;
+      case 't':
+        emit_string(text);
+        break;
+    }
+  }
+  if(instruction->op == FSM_OP_WAIT)
+  {
+    in_handlers = 1;
+  }
+}
+
+static void assemble_line(char* line)
+{
+  char* tokens[MAX_TOKENS];
+  int count = split_line(line, tokens);
+  size_t length;
+
+  if(count == 0)
+  {
+    return;
+  }
+
+  if(strcmp(tokens[0], "on") == 0)
+  {
+    assemble_handler(tokens, count);
+    return;
+  }
+  close_handlers();
+
+  length = strlen(tokens[0]);
+  if(strcmp(tokens[0], ".var") == 0)
+  {
+    expect(count, 2, ".var <name>");
+    if(find_symbol(vars, num_vars, tokens[1]) != NULL)
+    {
+      fail("variable '%s' defined twice", tokens[1]);
+    }
+    add_symbol(vars, &num_vars, FSM_NUM_VARS, tokens[1], num_vars);
+  }
+  else if(strcmp(tokens[0], "state") == 0)
+  {
+    symbol_t* state;
+    expect(count, 2, "state <name>");
+    state = find_symbol(states, num_states, tokens[1]);
+    if(state == NULL || state->value >= 0)
+    {
+      fail("state '%s' defined twice", tokens[1]);
+    }
+    state->value = code_length;
+  }
+  else if(tokens[0][length - 1] == ':')
+  {
+    if(count != 1)
+    {
+      fail("put the label on a line of its own");
+    }
+    tokens[0][length - 1] = '\0';
+    if(find_symbol(labels, num_labels, tokens[0]) != NULL)
+    {
+      fail("label '%s' defined twice", tokens[0]);
+    }
+    add_symbol(labels, &num_labels, MAX_SYMBOLS, tokens[0], code_length);
+  }
+  else
+  {
+    assemble_instruction(tokens, count);
+  }
+}
+
+/**
+ * @brief First pass: numbers the states so the header size is known
+ */
+static void find_states(FILE* source)
+{
+  char line[MAX_LINE];
+  char* tokens[MAX_TOKENS];
+  int count;
+
+  source_line = 0;
+  while(fgets(line, sizeof(line), source) != NULL)
+  {
+    source_line++;
+    count = split_line(line, tokens);
+    if(count == 2 && strcmp(tokens[0], "state") == 0 &&
+      find_symbol(states, num_states, tokens[1]) == NULL)
+    {
+      if(num_states >= FSM_MAX_STATES)
+      {
+        fail("more than %d states", FSM_MAX_STATES);
+      }
+      add_symbol(states, &num_states, MAX_SYMBOLS, tokens[1], -1);
+    }
+  }
+  if(num_states == 0)
+  {
+    fail("no states");
+  }
+}
+
+static void resolve_fixups(void)
+{
+  int i;
+  symbol_t* symbol;
+
+  for(i = 0; i < num_fixups; i++)
+  {
+    source_line = fixups[i].line;
+    if(fixups[i].is_state)
+    {
+      symbol = find_symbol(states, num_states, fixups[i].name);
+      if(symbol == NULL)
+      {
+        fail("unknown state '%s'", fixups[i].name);
+      }
+      code[fixups[i].offset] = symbol - states;
+    }
+    else
+    {
+      symbol = find_symbol(labels, num_labels, fixups[i].name);
+      if(symbol == NULL)
+      {
+        fail("unknown label '%s'", fixups[i].name);
+      }
+      code[fixups[i].offset] = symbol->value & 0xFF;
+      code[fixups[i].offset + 1] = (symbol->value >> 8) & 0xFF;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  FILE* source;
+  FILE* output;
+  char line[MAX_LINE];
+  int i;
+
+  if(argc != 3)
+  {
+    fprintf(stderr, "usage: %s game.fsa GAME.FSM\n", argv[0]);
+    return 2;
+  }
+  source_name = argv[1];
+  source = fopen(source_name, "r");
+  if(source == NULL)
+  {
+    perror(source_name);
+    return 1;
+  }
+
+  find_states(source);
+  rewind(source);
+
+  // Variable 0 always holds the value of the last input event
+  add_symbol(vars, &num_vars, FSM_NUM_VARS, "in", FSM_VAR_INPUT);
+
+  for(i = 0; i < FSM_MAGIC_SIZE; i++)
+  {
+    emit(FSM_MAGIC[i]);
+  }
+  emit(num_states);
+  for(i = 0; i < num_states; i++)
+  {
+    emit_word(0);
+  }
+
+  source_line = 0;
+  while(fgets(line, sizeof(line), source) != NULL)
+  {
+    source_line++;
+    if(strchr(line, '\n') == NULL && !feof(source))
+    {
+      fail("line is too long");
+    }
+    assemble_line(line);
+  }
+  close_handlers();
+  fclose(source);
+
+  for(i = 0; i < num_states; i++)
+  {
+    if(states[i].value < 0)
+    {
+      source_line = states[i].line;
+      fail("state '%s' has no code", states[i].name);
+    }
+    code[FSM_HEADER_SIZE + 2 * i] = states[i].value & 0xFF;
+    code[FSM_HEADER_SIZE + 2 * i + 1] = (states[i].value >> 8) & 0xFF;
+  }
+  resolve_fixups();
+
+  output = fopen(argv[2], "wb");
+  if(output == NULL || fwrite(code, 1, code_length, output) != (size_t)code_length
+    || fclose(output) != 0)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+  printf("%s: %d states, %ld bytes\n", argv[2], num_states, code_length);
+  return 0;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file fsmrun.c
+ * @brief Host tool that runs a compiled game script with the interpreter from
+ *        SABT_MainUnit/fsm.c. Input events are read from stdin, one per line:
+ *        dot <1-6>, enter, cancel, left, right, or cell <dots> for the dots of
+ *        a cell followed by ENTER. Everything the script would play is printed.
+ *
+ *        usage: fsmrun [-s seed] [-d dictionary] GAME.FSM < events.txt
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "fsm.h"
+
+#define MAX_SCRIPT 65536
+#define MAX_LINE 256
+#define MAX_RUNS 1000               // Calls to fsm_run before giving up
+
+static unsigned char script[MAX_SCRIPT];
+static size_t script_length;
+static const char* dictionary_name;
+
+// Dots of the letters a to z, as in script_english.c
+static const char letters[26] = {
+  0x01, 0x03, 0x09, 0x19, 0x11, 0x0B, 0x1B, 0x13, 0x0A, 0x1A,
+  0x05, 0x07, 0x0D, 0x1D, 0x15, 0x0F, 0x1F, 0x17, 0x0E, 0x1E,
+  0x25, 0x27, 0x3A, 0x2D, 0x3D, 0x35
+};
+
+bool fsm_platform_read(unsigned int offset, unsigned char* dest,
+  unsigned char length)
+{
+  unsigned char i;
+
+  for(i = 0; i < length; i++)
+  {
+    dest[i] = (offset + i < script_length) ? script[offset + i] : 0;
+  }
+  return true;
+}
+
+void fsm_platform_play(char* fileset, char* name)
+{
+  printf("play %s%s.mp3\n", fileset, name);
+}
+
+void fsm_platform_say_number(int number)
+{
+  printf("say number %d\n", number);
+}
+
+void fsm_platform_say_cell(char pattern)
+{
+  int dot;
+
+  printf("say cell");
+  for(dot = 0; dot < 6; dot++)
+  {
+    if(pattern & (1 << dot))
+    {
+      printf(" %d", dot + 1);
+    }
+  }
+  printf("\n");
+}
+
+int fsm_platform_random(int limit)
+{
+  return rand() % limit;
+}
+
+char fsm_platform_letter(char pattern)
+{
+  int i;
+
+  for(i = 0; i < 26; i++)
+  {
+    if(letters[i] == pattern)
+    {
+      return 'a' + i;
+    }
+  }
+  return '\0';
+}
+
+bool fsm_platform_in_dictionary(char* word)
+{
+  FILE* dictionary;
+  char line[MAX_LINE];
+  bool found = false;
+
+  if(dictionary_name == NULL)
+  {
+    return false;
+  }
+  dictionary = fopen(dictionary_name, "r");
+  if(dictionary == NULL)
+  {
+    perror(dictionary_name);
+    exit(1);
+  }
+  while(!found && fgets(line, sizeof(line), dictionary) != NULL)
+  {
+    line[strcspn(line, "\r\n")] = '\0';
+    found = (strcmp(line, word) == 0);
+  }
+  fclose(dictionary);
+  printf("dictionary %s: %s\n", word, found ? "yes" : "no");
+  return found;
+}
+
+/**
+ * @brief Runs the script until it waits for input or stops
+ * @return char - FSM_WAITING, FSM_ENDED or FSM_ERROR
+ */
+static char run(void)
+{
+  char status;
+  int runs = 0;
+
+  do
+  {
+    status = fsm_run();
+  } while(status == FSM_RUNNING && ++runs < MAX_RUNS);
+
+  if(status == FSM_RUNNING)
+  {
+    fprintf(stderr, "script ran %d instructions without waiting\n",
+      MAX_RUNS * FSM_MAX_STEPS);
+    exit(1);
+  }
+  return status;
+}
+
+/**
+ * @brief Passes one line of stdin to the script
+ * @return bool - false if the line is not an event
+ */
+static bool send_event(char* line)
+{
+  char name[16];
+  char value[16] = "";
+  const char* dot;
+
+  if(sscanf(line, "%15s %15s", name, value) < 1 || name[0] == '#')
+  {
+    return true;
+  }
+  printf("> %s%s%s\n", name, value[0] ? " " : "", value);
+
+  if(strcmp(name, "dot") == 0 && value[0] >= '1' && value[0] <= '6')
+  {
+    fsm_input(FSM_EVENT_DOT, value[0] - '0');
+  }
+  else if(strcmp(name, "cell") == 0)
+  {
+    for(dot = value; *dot >= '1' && *dot <= '6'; dot++)
+    {
+      fsm_input(FSM_EVENT_DOT, *dot - '0');
+    }
+    fsm_input(FSM_EVENT_ENTER, 0);
+  }
+  else if(strcmp(name, "enter") == 0)
+  {
+    fsm_input(FSM_EVENT_ENTER, 0);
+  }
+  else if(strcmp(name, "cancel") == 0)
+  {
+    fsm_input(FSM_EVENT_CANCEL, 0);
+  }
+  else if(strcmp(name, "left") == 0)
+  {
+    fsm_input(FSM_EVENT_LEFT, 0);
+  }
+  else if(strcmp(name, "right") == 0)
+  {
+    fsm_input(FSM_EVENT_RIGHT, 0);
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  FILE* file;
+  char line[MAX_LINE];
+  char status;
+  int option;
+
+  srand(1);
+  while((option = getopt(argc, argv, "s:d:")) != -1)
+  {
+    switch(option)
+    {
+      case 's':
+        srand(atoi(optarg));
+        break;
+      case 'd':
+        dictionary_name = optarg;
+        break;
+      default:
+        fprintf(stderr,
+          "usage: %s [-s seed] [-d dictionary] GAME.FSM < events\n", argv[0]);
+        return 2;
+    }
+  }
+  if(optind != argc - 1)
+  {
+    fprintf(stderr,
+      "usage: %s [-s seed] [-d dictionary] GAME.FSM < events\n", argv[0]);
+    return 2;
+  }
+
+  file = fopen(argv[optind], "rb");
+  if(file == NULL)
+  {
+    perror(argv[optind]);
+    return 1;
+  }
+  script_length = fread(script, 1, sizeof(script), file);
+  fclose(file);
+
+  if(!fsm_start())
+  {
+    fprintf(stderr, "%s: not a game script\n", argv[optind]);
+    return 1;
+  }
+
+  status = run();
+  while(status == FSM_WAITING && fgets(line, sizeof(line), stdin) != NULL)
+  {
+    if(!send_event(line))
+    {
+      fprintf(stderr, "unknown event: %s", line);
+      return 1;
+    }
+    status = run();
+  }
+
+  switch(status)
+  {
+    case FSM_WAITING:
+      printf("waiting for input\n");
+      return 0;
+    case FSM_ENDED:
+      printf("game over\n");
+      return 0;
+    default:
+      fprintf(stderr, "script error at offset %u\n", fsm_error_offset());
+      return 1;
+  }
+}
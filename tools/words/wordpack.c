@@ -0,0 +1,208 @@
+/**
+ * @file wordpack.c
+ * @brief Host tool that builds a word list (.WRD) for the word games on the
+ *        main unit from a text list. See README for the format.
+ *
+ *        usage: wordpack animals.txt ANIMALS.WRD
+ */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "words.h"
+
+#define MAX_LINE 256
+
+// Grade 1 English letters as cell patterns, dot 1 in the lowest bit
+static const unsigned char letter_cells[26] = {
+  0x01, 0x03, 0x09, 0x19, 0x11, 0x0B, 0x1B, 0x13, 0x0A, 0x1A,
+  0x05, 0x07, 0x0D, 0x1D, 0x15, 0x0F, 0x1F, 0x17, 0x0E, 0x1E,
+  0x25, 0x27, 0x3A, 0x2D, 0x3D, 0x35
+};
+
+static const char* source_name;
+static int line_number;
+
+/**
+ * @brief Prints an error at the current line and exits
+ * @param format - const char*, printf format
+ * @return Void - never returns
+ */
+static void fail(const char* format, ...)
+{
+  va_list args;
+
+  fprintf(stderr, "%s:%d: ", source_name, line_number);
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+/**
+ * @brief Copies a fileset name such as "ENG_" into the header
+ * @param dest - unsigned char*, WORDS_FILESET_SIZE bytes
+ * @param text - const char*, fileset
+ * @return Void
+ */
+static void set_fileset(unsigned char* dest, const char* text)
+{
+  if(text == NULL || strlen(text) != WORDS_FILESET_SIZE)
+  {
+    fail("filesets are %d characters, e.g. ENG_", WORDS_FILESET_SIZE);
+  }
+  memcpy(dest, text, WORDS_FILESET_SIZE);
+}
+
+/**
+ * @brief Converts a word to cells: letters a to z, or cells written as dot
+ *        numbers joined by '-', e.g. 1245-1-24
+ * @param text - const char*, the word
+ * @param cells - unsigned char*, set to the cells
+ * @return int - number of cells
+ */
+static int word_cells(const char* text, unsigned char* cells)
+{
+  int length = 0;
+  unsigned char cell = 0;
+  const char* c;
+
+  if(isdigit((unsigned char) text[0]))
+  {
+    for(c = text; ; c++)
+    {
+      if(*c >= '1' && *c <= '6')
+      {
+        cell |= 1 << (*c - '1');
+        continue;
+      }
+      if((*c != '-' && *c != '\0') || cell == 0)
+      {
+        fail("bad cell in \"%s\"", text);
+      }
+      if(length == WORDS_MAX_CELLS)
+      {
+        fail("\"%s\" has more than %d cells", text, WORDS_MAX_CELLS);
+      }
+      cells[length++] = cell;
+      cell = 0;
+      if(*c == '\0')
+      {
+        return length;
+      }
+    }
+  }
+
+  for(c = text; *c != '\0'; c++)
+  {
+    if(!isalpha((unsigned char) *c))
+    {
+      fail("\"%s\" is not a word of letters a to z", text);
+    }
+    if(length == WORDS_MAX_CELLS)
+    {
+      fail("\"%s\" has more than %d cells", text, WORDS_MAX_CELLS);
+    }
+    cells[length++] = letter_cells[tolower((unsigned char) *c) - 'a'];
+  }
+  return length;
+}
+
+int main(int argc, char** argv)
+{
+  unsigned char header[WORDS_FIRST_RECORD];
+  unsigned char record[WORDS_RECORD_SIZE];
+  char line[MAX_LINE];
+  char* word;
+  char* clip;
+  char* comment;
+  FILE* in;
+  FILE* out;
+  long count = 0;
+
+  if(argc != 3)
+  {
+    fprintf(stderr, "usage: wordpack list.txt NAME.WRD\n");
+    return 1;
+  }
+  source_name = argv[1];
+  if((in = fopen(argv[1], "r")) == NULL)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+  if((out = fopen(argv[2], "wb")) == NULL)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+
+  memset(header, 0, sizeof(header));
+  memcpy(header, WORDS_MAGIC, WORDS_MAGIC_SIZE);
+  memcpy(&header[WORDS_LANGUAGE_OFFSET], "ENG_", WORDS_FILESET_SIZE);
+  fwrite(header, 1, sizeof(header), out);
+
+  while(fgets(line, sizeof(line), in) != NULL)
+  {
+    line_number++;
+    if((comment = strchr(line, ';')) != NULL)
+    {
+      *comment = '\0';
+    }
+    if((word = strtok(line, " \t\r\n")) == NULL)
+    {
+      continue;
+    }
+    clip = strtok(NULL, " \t\r\n");
+    if(strtok(NULL, " \t\r\n") != NULL)
+    {
+      fail("expected a word and a clip name");
+    }
+
+    if(strcmp(word, "lang") == 0)
+    {
+      set_fileset(&header[WORDS_LANGUAGE_OFFSET], clip);
+      continue;
+    }
+    if(strcmp(word, "clips") == 0)
+    {
+      set_fileset(&header[WORDS_FILESET_OFFSET], clip);
+      continue;
+    }
+
+    if(clip == NULL || strlen(clip) > WORDS_CLIP_SIZE)
+    {
+      fail("clip names are 1 to %d characters", WORDS_CLIP_SIZE);
+    }
+    if(count == WORDS_MAX_COUNT)
+    {
+      fail("more than %d words", WORDS_MAX_COUNT);
+    }
+    memset(record, 0, sizeof(record));
+    record[0] = word_cells(word, &record[1]);
+    memcpy(&record[WORDS_CLIP_OFFSET], clip, strlen(clip));
+    fwrite(record, 1, sizeof(record), out);
+    count++;
+  }
+
+  if(header[WORDS_FILESET_OFFSET] == 0)
+  {
+    fail("no \"clips\" line");
+  }
+  header[WORDS_COUNT_OFFSET] = count & 0xFF;
+  header[WORDS_COUNT_OFFSET + 1] = count >> 8;
+  fseek(out, 0, SEEK_SET);
+  fwrite(header, 1, sizeof(header), out);
+
+  fclose(in);
+  if(fclose(out) != 0)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+  printf("%s: %ld words\n", argv[2], count);
+  return 0;
+}